@@ -13,6 +13,15 @@ local serializeWebHex = function(colorObject)
 		return '#' .. string.format('%02x%02x%02x', round(c:red() * 255), round(c:green() * 255), round(c:blue() * 255))
 	end
 end
+local serializeWebHexMany = function(colorObjects)
+	local result = {}
+	local format = options.upperCase and '#%02X%02X%02X' or '#%02x%02x%02x'
+	for i, colorObject in ipairs(colorObjects) do
+		local c = colorObject:getColor()
+		result[i] = string.format(format, round(c:red() * 255), round(c:green() * 255), round(c:blue() * 255))
+	end
+	return result
+end
 local deserializeWebHex = function(text, colorObject)
 	local c = color:new()
 	local findStart, findEnd, red, green, blue = string.find(text, '#([%x][%x])([%x][%x])([%x][%x])[^%x]?')
@@ -81,7 +90,7 @@ local deserializeWebHex3Digit = function(text, colorObject)
 end
 local serializeCssHsl = function(colorObject)
 	local c = colorObject:getColor()
-	c = c:rgbToHsl()
+	c:rgbToHsl(c)
 	return 'hsl(' .. string.format('%d, %d%%, %d%%', round(c:hue() * 360), round(c:saturation() * 100), round(c:lightness() * 100)) .. ')'
 end
 local serializeCssRgb = function(colorObject)
@@ -151,7 +160,7 @@ local serializeColorCsv = function(colorObject)
 	os.setlocale("", "numeric")
 	return r
 end
-gpick:addConverter('color_web_hex', _("Web: hex code"), serializeWebHex, deserializeWebHex)
+gpick:addConverter('color_web_hex', _("Web: hex code"), serializeWebHex, deserializeWebHex, serializeWebHexMany)
 gpick:addConverter('color_web_hex_3_digit', _("Web: hex code (3 digits)"), serializeWebHex3Digit, deserializeWebHex3Digit)
 gpick:addConverter('color_web_hex_no_hash', _("Web: hex code (no hash symbol)"), serializeWebHexNoHash, deserializeWebHexNoHash)
 gpick:addConverter('color_css_hsl', _("CSS: hue saturation lightness"), serializeCssHsl)
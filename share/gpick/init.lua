@@ -26,6 +26,5 @@ local componentToText = function(componentType, color)
 end
 gpick:setComponentToTextCallback(componentToText)
 require('options')
-require('layouts')
 require('converters')
 helpers.suggest('user_init')
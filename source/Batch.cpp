@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Batch.h"
+#include "GlobalState.h"
+#include "ImportExport.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "Converters.h"
+#include "DynvHelpers.h"
+#include "uiDialogSort.h"
+#include "color_names/ColorNames.h"
+#include "tools/PaletteFromImage.h"
+#include "parser/TextFile.h"
+#include <glib.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+using namespace std;
+
+static gchar **input_filenames = nullptr;
+static gchar *output_directory = nullptr;
+static gchar *output_format = nullptr;
+static gchar *converter_name = nullptr;
+static gchar *sort_type = nullptr;
+static gboolean sort_reverse = FALSE;
+static gboolean assign_names = FALSE;
+static gint color_count = 16;
+static gint job_count = 0;
+static GOptionEntry batch_entries[] =
+{
+	{"output-directory", 'd', 0, G_OPTION_ARG_FILENAME, &output_directory, "Output directory, input file directory is used by default", "DIRECTORY"},
+	{"format", 'f', 0, G_OPTION_ARG_STRING, &output_format, "Output format: gpa, gpl, ase, txt, css, html or mtl", "FORMAT"},
+	{"converter-name", 'c', 0, G_OPTION_ARG_STRING, &converter_name, "Converter name used for text output formats", "NAME"},
+	{"colors", 'n', 0, G_OPTION_ARG_INT, &color_count, "Number of colors extracted from images", "COUNT"},
+	{"sort", 's', 0, G_OPTION_ARG_STRING, &sort_type, "Sort type, for example hsl_hue or lab_lightness", "TYPE"},
+	{"reverse", 'r', 0, G_OPTION_ARG_NONE, &sort_reverse, "Sort in descending order", nullptr},
+	{"name", 0, 0, G_OPTION_ARG_NONE, &assign_names, "Assign color names", nullptr},
+	{"jobs", 'j', 0, G_OPTION_ARG_INT, &job_count, "Number of worker threads", "COUNT"},
+	{G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &input_filenames, nullptr, "FILE..."},
+	{nullptr}
+};
+struct BatchJob
+{
+	string input_filename;
+	string output_filename;
+	bool ok;
+	const char *error;
+	size_t colors;
+	double import_time, sort_time, name_time, export_time, total_time;
+};
+struct Batch
+{
+	Batch(GlobalState &gs, FileType output_type):
+		m_gs(gs),
+		m_output_type(output_type)
+	{
+		m_converter = m_gs.converters().byNameOrFirstCopy(converter_name);
+		m_imprecision_postfix = dynv_get_bool_wd(m_gs.getSettings(), "gpick.color_names.imprecision_postfix", false);
+	}
+	static double elapsed(chrono::steady_clock::time_point &start)
+	{
+		auto now = chrono::steady_clock::now();
+		double result = chrono::duration<double, milli>(now - start).count();
+		start = now;
+		return result;
+	}
+	static bool usesScript(FileType type)
+	{
+		switch (type){
+			case FileType::txt:
+			case FileType::css:
+			case FileType::html:
+				return true;
+			default:
+				return false;
+		}
+	}
+	ColorList *createColorList()
+	{
+		dynvHandlerMap *handler_map = dynv_system_get_handler_map(m_gs.getSettings());
+		ColorList *color_list = color_list_new(handler_map);
+		dynv_handler_map_release(handler_map);
+		return color_list;
+	}
+	bool importFile(ColorList *color_list, BatchJob &job)
+	{
+		FileType type = ImportExport::getFileType(job.input_filename.c_str());
+		ImportExport import_export(color_list, job.input_filename.c_str(), &m_gs);
+		//files are already processed in parallel, so each file is parsed by a single thread
+		import_export.setParserThreadCount(1);
+		switch (type){
+			case FileType::gpa:
+			case FileType::gpl:
+			case FileType::ase:
+			case FileType::rgbtxt:
+				return import_export.importType(type);
+			case FileType::txt:
+			case FileType::mtl:
+			case FileType::css:
+			case FileType::html:
+				return import_export.importTextFile(text_file_parser::Configuration());
+			case FileType::unknown:
+				{
+					vector<Color> colors;
+					if (!tools_palette_from_image_extract(job.input_filename.c_str(), color_count, colors))
+						return false;
+					for (auto &color: colors){
+						Color rgb;
+						color_set(&rgb, color.xyz.x, color.xyz.y, color.xyz.z);
+						color_list_add_color(color_list, &rgb);
+					}
+					return !colors.empty();
+				}
+		}
+		return false;
+	}
+	bool exportFile(ColorList *color_list, BatchJob &job)
+	{
+		ImportExport import_export(color_list, job.output_filename.c_str(), &m_gs);
+		import_export.setConverter(m_converter);
+		if (usesScript(m_output_type)){
+			lock_guard<mutex> lock(m_script_mutex);
+			return import_export.exportType(m_output_type);
+		}
+		return import_export.exportType(m_output_type);
+	}
+	void process(BatchJob &job)
+	{
+		job.ok = false;
+		job.error = nullptr;
+		job.colors = 0;
+		job.import_time = job.sort_time = job.name_time = job.export_time = job.total_time = 0;
+		auto job_start = chrono::steady_clock::now();
+		auto start = job_start;
+		ColorList *color_list = createColorList();
+		bool imported = importFile(color_list, job);
+		job.import_time = elapsed(start);
+		if (!imported){
+			job.error = "import failed";
+			color_list_destroy(color_list);
+			job.total_time = chrono::duration<double, milli>(chrono::steady_clock::now() - job_start).count();
+			return;
+		}
+		if (sort_type){
+			ColorList *sorted_color_list = createColorList();
+			if (sort_color_list(color_list, sorted_color_list, sort_type, sort_reverse)){
+				color_list_destroy(color_list);
+				color_list = sorted_color_list;
+			}else{
+				color_list_destroy(sorted_color_list);
+			}
+			job.sort_time = elapsed(start);
+		}
+		if (assign_names){
+			ColorNames *color_names = m_gs.getColorNames();
+			for (auto color_object: color_list->colors){
+				Color color = color_object->getColor();
+				color_object->setName(color_names_get(color_names, &color, m_imprecision_postfix));
+			}
+			job.name_time = elapsed(start);
+		}
+		job.colors = color_list->colors.size();
+		job.ok = exportFile(color_list, job);
+		if (!job.ok)
+			job.error = "export failed";
+		job.export_time = elapsed(start);
+		color_list_destroy(color_list);
+		job.total_time = chrono::duration<double, milli>(chrono::steady_clock::now() - job_start).count();
+	}
+	GlobalState &m_gs;
+	FileType m_output_type;
+	Converter *m_converter;
+	bool m_imprecision_postfix;
+	mutex m_script_mutex;
+};
+static string json_string(const string &value)
+{
+	string result = "\"";
+	for (char c: value){
+		switch (c){
+			case '"': result += "\\\""; break;
+			case '\\': result += "\\\\"; break;
+			case '\n': result += "\\n"; break;
+			case '\t': result += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20){
+					char buffer[8];
+					g_snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+					result += buffer;
+				}else
+					result += c;
+		}
+	}
+	return result + "\"";
+}
+static string build_output_filename(const char *input_filename, const char *extension)
+{
+	gchar *basename = g_path_get_basename(input_filename);
+	string name = basename;
+	g_free(basename);
+	size_t dot = name.rfind('.');
+	if (dot != string::npos && dot > 0)
+		name.erase(dot);
+	name += ".";
+	name += extension;
+	gchar *directory = output_directory ? g_strdup(output_directory) : g_path_get_dirname(input_filename);
+	gchar *path = g_build_filename(directory, name.c_str(), nullptr);
+	string result = path;
+	g_free(path);
+	g_free(directory);
+	return result;
+}
+int batch_main(int argc, char **argv)
+{
+	GError *error = nullptr;
+	GOptionContext *context = g_option_context_new("FILE... - process palettes and images without user interface");
+	g_option_context_add_main_entries(context, batch_entries, 0);
+	if (!g_option_context_parse(context, &argc, &argv, &error)){
+		g_printerr("option parsing failed: %s\n", error->message);
+		g_clear_error(&error);
+		g_option_context_free(context);
+		return -1;
+	}
+	g_option_context_free(context);
+	if (!input_filenames || !input_filenames[0]){
+		g_printerr("no input files\n");
+		return -1;
+	}
+	const char *extension = output_format ? output_format : "gpl";
+	FileType output_type = ImportExport::getFileTypeByExtension((string(".") + extension).c_str());
+	if (output_type == FileType::unknown || output_type == FileType::rgbtxt){
+		g_printerr("unsupported output format: %s\n", extension);
+		return -1;
+	}
+	if (color_count < 1) color_count = 1;
+	if (sort_type){
+		ColorList *color_list = color_list_new();
+		bool valid_sort_type = sort_color_list(color_list, color_list, sort_type, false);
+		color_list_destroy(color_list);
+		if (!valid_sort_type){
+			g_printerr("unknown sort type: %s\n", sort_type);
+			return -1;
+		}
+	}
+	auto start = chrono::steady_clock::now();
+	color_init();
+	GlobalState gs;
+	gs.loadAll();
+	double setup_time = Batch::elapsed(start);
+	Batch batch(gs, output_type);
+	vector<BatchJob> jobs;
+	for (gchar **filename = input_filenames; *filename; ++filename){
+		BatchJob job;
+		job.input_filename = *filename;
+		job.output_filename = build_output_filename(*filename, extension);
+		jobs.push_back(job);
+	}
+	size_t thread_count = job_count > 0 ? job_count : max(thread::hardware_concurrency(), 1u);
+	thread_count = min(thread_count, jobs.size());
+	atomic<size_t> next_job(0);
+	mutex output_mutex;
+	auto worker = [&](){
+		size_t index;
+		while ((index = next_job++) < jobs.size()){
+			BatchJob &job = jobs[index];
+			batch.process(job);
+			stringstream line;
+			line << "{\"input\": " << json_string(job.input_filename) << ", \"output\": " << json_string(job.output_filename);
+			line << ", \"ok\": " << (job.ok ? "true" : "false");
+			if (job.error)
+				line << ", \"error\": " << json_string(job.error);
+			line << ", \"colors\": " << job.colors;
+			line << ", \"import_ms\": " << job.import_time << ", \"sort_ms\": " << job.sort_time << ", \"name_ms\": " << job.name_time;
+			line << ", \"export_ms\": " << job.export_time << ", \"total_ms\": " << job.total_time << "}";
+			lock_guard<mutex> lock(output_mutex);
+			cout << line.str() << endl;
+		}
+	};
+	vector<thread> threads;
+	for (size_t i = 1; i < thread_count; i++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto &thread: threads)
+		thread.join();
+	double processing_time = Batch::elapsed(start);
+	size_t failed = count_if(jobs.begin(), jobs.end(), [](const BatchJob &job){ return !job.ok; });
+	cout << "{\"summary\": true, \"files\": " << jobs.size() << ", \"failed\": " << failed << ", \"threads\": " << thread_count;
+	cout << ", \"setup_ms\": " << setup_time << ", \"processing_ms\": " << processing_time << "}" << endl;
+	return failed == 0 ? 0 : 1;
+}
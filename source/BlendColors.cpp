@@ -40,11 +40,14 @@
 #include "StandardMenu.h"
 #include "ToolColorNaming.h"
 #include "I18N.h"
+#include "TaskExecutor.h"
 #include <gdk/gdkkeysyms.h>
 #include <math.h>
 #include <string.h>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <memory>
 #ifndef _MSC_VER
 #include <stdbool.h>
 #endif
@@ -64,6 +67,7 @@ typedef struct BlendColorsArgs{
 	ColorList *preview_color_list;
 	struct dynvSystem *params;
 	GlobalState* gs;
+	std::shared_ptr<TaskExecutor::Task> preview_task;
 }BlendColorsArgs;
 
 struct BlendColorNameAssigner: public ToolColorNameAssigner
@@ -131,43 +135,69 @@ static void store(ColorList *color_list, const Color *color, int step, BlendColo
 	color_object->release();
 }
 
-static void calc(BlendColorsArgs *args, bool preview, int limit)
+struct BlendSettings
+{
+	int type;
+	int steps1;
+	int steps2;
+	Color start_color;
+	Color middle_color;
+	Color end_color;
+};
+/** \struct BlendStage
+ * \brief Colors of one blend stage: from start to middle color or from middle to end color.
+ */
+struct BlendStage
+{
+	Color a, b;
+	int steps;
+	vector<Color> colors;
+};
+static void get_settings(BlendColorsArgs *args, BlendSettings &settings)
+{
+	settings.steps1 = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(args->steps1));
+	settings.steps2 = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(args->steps2));
+	settings.type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->mix_type));
+	gtk_color_get_color(GTK_COLOR(args->start_color), &settings.start_color);
+	gtk_color_get_color(GTK_COLOR(args->middle_color), &settings.middle_color);
+	gtk_color_get_color(GTK_COLOR(args->end_color), &settings.end_color);
+}
+/** Blends colors. Second stage starts from the first step, as middle color is already added by the first stage.
+ * Does not access GTK widgets or color names, so it can be called from a worker thread.
+ */
+static void blend(const BlendSettings &settings, BlendStage stages[2])
 {
-	gint steps1 = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(args->steps1));
-	gint steps2 = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(args->steps2));
-	gint type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->mix_type));
 	Color r;
 	gint step_i;
 	Color a,b;
-	ColorList *color_list;
-	color_list = args->preview_color_list;
-	BlendColorNameAssigner name_assigner(args->gs);
 	int steps;
 	for (int stage = 0; stage < 2; stage++){
 		if (stage == 0){
-			steps = steps1 + 1;
-			gtk_color_get_color(GTK_COLOR(args->start_color), &a);
-			gtk_color_get_color(GTK_COLOR(args->middle_color), &b);
+			steps = settings.steps1 + 1;
+			a = settings.start_color;
+			b = settings.middle_color;
 		}else{
-			steps = steps2 + 1;
-			gtk_color_get_color(GTK_COLOR(args->middle_color), &a);
-			gtk_color_get_color(GTK_COLOR(args->end_color), &b);
+			steps = settings.steps2 + 1;
+			a = settings.middle_color;
+			b = settings.end_color;
 		}
-		string start_name = color_names_get(args->gs->getColorNames(), &a, false);
-		string end_name = color_names_get(args->gs->getColorNames(), &b, false);
-		name_assigner.setNames(start_name.c_str(), end_name.c_str());
-		name_assigner.setStepsAndStage(steps, stage);
-		if (type == 0){
+		BlendStage &blend_stage = stages[stage];
+		blend_stage.a = a;
+		blend_stage.b = b;
+		blend_stage.steps = steps;
+		blend_stage.colors.clear();
+		blend_stage.colors.reserve(steps);
+		if (settings.type == 0){
 			color_rgb_get_linear(&a, &a);
 			color_rgb_get_linear(&b, &b);
 		}
 		step_i = stage;
-		switch (type){
+		switch (settings.type){
 		case 0:
 			for (; step_i < steps; ++step_i){
 				color_utils::mix(a, b, step_i / (float)(steps - 1), r);
 				color_linear_get_rgb(&r, &r);
-				store(color_list, &r, step_i, name_assigner);
+				blend_stage.colors.push_back(r);
 			}
 			break;
 		case 1:
@@ -186,7 +216,7 @@ static void calc(BlendColorsArgs *args, bool preview, int limit)
 					color_utils::mix(a_hsv, b_hsv, step_i / (float)(steps - 1), r_hsv);
 					if (r_hsv.hsv.hue < 0) r_hsv.hsv.hue += 1;
 					color_hsv_to_rgb(&r_hsv, &r);
-					store(color_list, &r, step_i, name_assigner);
+					blend_stage.colors.push_back(r);
 				}
 			}
 			break;
@@ -199,7 +229,7 @@ static void calc(BlendColorsArgs *args, bool preview, int limit)
 					color_utils::mix(a_lab, b_lab, step_i / (float)(steps - 1), r_lab);
 					color_lab_to_rgb_d50(&r_lab, &r);
 					color_rgb_normalize(&r);
-					store(color_list, &r, step_i, name_assigner);
+					blend_stage.colors.push_back(r);
 				}
 			}
 			break;
@@ -220,13 +250,67 @@ static void calc(BlendColorsArgs *args, bool preview, int limit)
 					if (r_lch.lch.h < 0) r_lch.lch.h += 360;
 					color_lch_to_rgb_d50(&r_lch, &r);
 					color_rgb_normalize(&r);
-					store(color_list, &r, step_i, name_assigner);
+					blend_stage.colors.push_back(r);
 				}
 			}
 			break;
 		}
 	}
 }
+static void store(BlendColorsArgs *args, ColorList *color_list, BlendStage stages[2])
+{
+	BlendColorNameAssigner name_assigner(args->gs);
+	for (int stage = 0; stage < 2; stage++){
+		BlendStage &blend_stage = stages[stage];
+		string start_name = name_assigner.getColorName(&blend_stage.a);
+		string end_name = name_assigner.getColorName(&blend_stage.b);
+		name_assigner.setNames(start_name.c_str(), end_name.c_str());
+		name_assigner.setStepsAndStage(blend_stage.steps, stage);
+		int step_i = stage;
+		for (vector<Color>::iterator i = blend_stage.colors.begin(); i != blend_stage.colors.end(); ++i, ++step_i){
+			store(color_list, &(*i), step_i, name_assigner);
+		}
+	}
+}
+/** \struct BlendPreviewTask
+ * \brief Blends colors in a worker thread. Resulting colors are named and added to the preview list in the main loop.
+ */
+struct BlendPreviewTask: public TaskExecutor::Task
+{
+	BlendColorsArgs *m_args;
+	BlendSettings m_settings;
+	BlendStage m_stages[2];
+	BlendPreviewTask(BlendColorsArgs *args, const BlendSettings &settings):
+		m_args(args),
+		m_settings(settings)
+	{
+	}
+	virtual void run()
+	{
+		blend(m_settings, m_stages);
+	}
+	virtual void finish()
+	{
+		color_list_remove_all(m_args->preview_color_list);
+		store(m_args, m_args->preview_color_list, m_stages);
+	}
+};
+static void calc(BlendColorsArgs *args, bool preview, int limit)
+{
+	BlendSettings settings;
+	get_settings(args, settings);
+	if (preview){
+		if (args->preview_task)
+			args->preview_task->cancel();
+		args->preview_task = std::make_shared<BlendPreviewTask>(args, settings);
+		args->gs->taskExecutor().submit(args->preview_task);
+		return;
+	}
+	BlendStage stages[2];
+	blend(settings, stages);
+	color_list_remove_all(args->preview_color_list);
+	store(args, args->preview_color_list, stages);
+}
 static PaletteListCallbackReturn add_to_palette_cb_helper(ColorObject* color_object, void *userdata)
 {
 	BlendColorsArgs *args = (BlendColorsArgs*)userdata;
@@ -292,7 +376,6 @@ static gboolean preview_list_button_press_cb(GtkWidget *widget, GdkEventButton *
 }
 static void update(GtkWidget *widget, BlendColorsArgs *args)
 {
-	color_list_remove_all(args->preview_color_list);
 	calc(args, true, 101);
 }
 static void reset_middle_color_cb(GtkWidget *widget, BlendColorsArgs *args)
@@ -393,6 +476,8 @@ static int source_deactivate(BlendColorsArgs *args)
 }
 static int source_destroy(BlendColorsArgs *args)
 {
+	if (args->preview_task)
+		args->preview_task->cancel();
 	gint steps1 = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(args->steps1));
 	gint steps2 = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(args->steps2));
 	gint type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->mix_type));
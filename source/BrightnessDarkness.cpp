@@ -78,7 +78,7 @@ struct BrightnessDarknessColorNameAssigner: public ToolColorNameAssigner
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color)
 		{
 			m_stream.str("");
-			m_stream << color_names_get(m_gs->getColorNames(), color, false) << " " << _("brightness darkness") << " " << m_ident;
+			m_stream << getColorName(color) << " " << _("brightness darkness") << " " << m_ident;
 			return m_stream.str();
 		}
 };
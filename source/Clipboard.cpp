@@ -26,6 +26,8 @@
 #include "ColorList.h"
 #include <gtk/gtk.h>
 #include <sstream>
+#include <vector>
+#include <string>
 using namespace std;
 
 static PaletteListCallbackReturn addToColorList(ColorObject* color_object, ColorList *color_list)
@@ -56,24 +58,16 @@ void Clipboard::set(GtkWidget *palette_widget, GlobalState *gs, Converter *conve
 	stringstream text(ios::out);
 	ColorList *color_list = color_list_new();
 	palette_list_foreach_selected(palette_widget, (PaletteListCallback)addToColorList, color_list);
-	string text_line;
-	ConverterSerializePosition position(color_list->colors.size());
-	if (position.count() > 0){
-		for (auto &color: color_list->colors){
-			if (position.index() + 1 == position.count())
-				position.last(true);
-			text_line = converter->serialize(color, position);
-			if (position.first()){
-				text << text_line;
-				position.first(false);
-			}else{
-				text << endl << text_line;
-			}
-			position.incrementIndex();
-		}
-	}
+	vector<ColorObject*> color_objects(color_list->colors.begin(), color_list->colors.end());
+	vector<string> text_lines;
+	converter->serialize(color_objects.data(), color_objects.size(), ConverterSerializePosition(0, color_objects.size()), text_lines);
 	color_list_destroy(color_list);
-	text_line = text.str();
+	for (size_t i = 0; i < text_lines.size(); i++){
+		if (i != 0)
+			text << endl;
+		text << text_lines[i];
+	}
+	string text_line = text.str();
 	if (text_line.length() > 0){
 		set(text_line);
 	}
@@ -65,7 +65,7 @@ struct ClosestColorsColorNameAssigner: public ToolColorNameAssigner
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color)
 		{
 			m_stream.str("");
-			m_stream << color_names_get(m_gs->getColorNames(), color, false) << " " << _("closest color") << " " << m_ident;
+			m_stream << getColorName(color) << " " << _("closest color") << " " << m_ident;
 			return m_stream.str();
 		}
 };
@@ -17,7 +17,10 @@
  */
 
 #include "Color.h"
+#include "ColorRYB.h"
 #include <math.h>
+#include <cmath>
+#include <algorithm>
 #include "MathUtil.h"
 
 #include <iostream>
@@ -44,6 +47,61 @@ static matrix3x3 sRGB_transformation_inverted;
 static matrix3x3 d65_d50_adaptation_matrix;
 static matrix3x3 d50_d65_adaptation_matrix;
 
+/** CAM16 viewing conditions dependent values. */
+static struct Cam16ViewingConditions{
+	float d_rgb[3]; /**< Degree of adaptation multipliers */
+	float f_l; /**< Luminance level adaptation factor */
+	float n; /**< Background induction factor */
+	float z; /**< Base exponential nonlinearity */
+	float n_bb; /**< Chromatic induction factor */
+	float a_w; /**< Achromatic response of white */
+	float c; /**< Impact of surround */
+	float n_c; /**< Chromatic induction factor of surround */
+}cam16;
+
+/** CAT16 matrix converting XYZ color space to cone responses. */
+static const float cam16_matrix[3][3] = {
+	{ 0.401288f, 0.650173f, -0.051461f},
+	{-0.250268f, 1.204414f,  0.045854f},
+	{-0.002079f, 0.048952f,  0.953127f},
+};
+
+static void cam16_cone_response(const float xyz[3], float rgb[3])
+{
+	for (int i = 0; i < 3; i++)
+		rgb[i] = cam16_matrix[i][0] * xyz[0] + cam16_matrix[i][1] * xyz[1] + cam16_matrix[i][2] * xyz[2];
+}
+
+static float cam16_compress(float value)
+{
+	float f = std::pow(cam16.f_l * std::fabs(value) / 100, 0.42f);
+	return std::copysign(400 * f / (f + 27.13f), value) + 0.1f;
+}
+
+/**
+ * Initialize CAM16 for sRGB viewing conditions: D65 reference white, average surround, 20% gray background and adapting luminance of 64 lux (4 cd/m²).
+ */
+static void cam16_init()
+{
+	const vector3 *white = color_get_reference(REFERENCE_ILLUMINANT_D65, REFERENCE_OBSERVER_2);
+	const float adapting_luminance = static_cast<float>(64 / PI / 5), background_luminance = 20, surround_f = 1;
+	cam16.c = 0.69f;
+	cam16.n_c = 1;
+	float k = 1 / (5 * adapting_luminance + 1), k4 = k * k * k * k;
+	cam16.f_l = 0.2f * k4 * (5 * adapting_luminance) + 0.1f * (1 - k4) * (1 - k4) * std::cbrt(5 * adapting_luminance);
+	cam16.n = background_luminance / white->y;
+	cam16.z = 1.48f + std::sqrt(cam16.n);
+	cam16.n_bb = 0.725f * std::pow(cam16.n, -0.2f);
+	float d = clamp_float(surround_f * (1 - (1 / 3.6f) * std::exp((-adapting_luminance - 42) / 92)), 0, 1);
+	float xyz_w[3] = {white->x, white->y, white->z}, rgb_w[3], rgb_aw[3];
+	cam16_cone_response(xyz_w, rgb_w);
+	for (int i = 0; i < 3; i++){
+		cam16.d_rgb[i] = d * white->y / rgb_w[i] + 1 - d;
+		rgb_aw[i] = cam16_compress(cam16.d_rgb[i] * rgb_w[i]);
+	}
+	cam16.a_w = (2 * rgb_aw[0] + rgb_aw[1] + 0.05f * rgb_aw[2] - 0.305f) * cam16.n_bb;
+}
+
 
 void color_init()
 {
@@ -53,7 +111,8 @@ void color_init()
 
 	color_get_chromatic_adaptation_matrix(color_get_reference(REFERENCE_ILLUMINANT_D65, REFERENCE_OBSERVER_2), color_get_reference(REFERENCE_ILLUMINANT_D50, REFERENCE_OBSERVER_2), &d65_d50_adaptation_matrix);
 	color_get_chromatic_adaptation_matrix(color_get_reference(REFERENCE_ILLUMINANT_D50, REFERENCE_OBSERVER_2), color_get_reference(REFERENCE_ILLUMINANT_D65, REFERENCE_OBSERVER_2), &d50_d65_adaptation_matrix);
-
+	color_ryb_init();
+	cam16_init();
 }
 
 
@@ -819,11 +878,79 @@ float color_distance_lch(const Color* a, const Color* b)
 	Color al, bl;
 	color_lab_to_lch(a, &al);
 	color_lab_to_lch(b, &bl);
-	return sqrt(
-		pow((bl.lch.L - al.lch.L) / 1, 2) +
-		pow((bl.lch.C - al.lch.C) / (1 + 0.045 * al.lch.C), 2) +
-		pow((pow(a->lab.a - b->lab.a, 2) + pow(a->lab.b - b->lab.b, 2) - (bl.lch.C - al.lch.C)) / (1 + 0.015 * al.lch.C), 2)
-	);
+	return sqrt(color_distance_lch_squared(a, &al, b, &bl));
+}
+float color_distance_lch_squared(const Color* a, const Color* a_lch, const Color* b, const Color* b_lch)
+{
+	float delta_l = b_lch->lch.L - a_lch->lch.L;
+	float delta_c = b_lch->lch.C - a_lch->lch.C;
+	float delta_a = a->lab.a - b->lab.a;
+	float delta_b = a->lab.b - b->lab.b;
+	float c = delta_c / (1 + 0.045f * a_lch->lch.C);
+	float h = (delta_a * delta_a + delta_b * delta_b - delta_c) / (1 + 0.015f * a_lch->lch.C);
+	return delta_l * delta_l + c * c + h * h;
+}
+float color_distance_ciede2000(const Color* a, const Color* b)
+{
+	const float pow25_7 = 6103515625.0f; // 25^7
+	const float pi = static_cast<float>(PI), two_pi = 2 * pi;
+	float c1 = std::sqrt(a->lab.a * a->lab.a + a->lab.b * a->lab.b);
+	float c2 = std::sqrt(b->lab.a * b->lab.a + b->lab.b * b->lab.b);
+	float c_mean = (c1 + c2) / 2, c_mean7 = std::pow(c_mean, 7.0f);
+	float g = 0.5f * (1 - std::sqrt(c_mean7 / (c_mean7 + pow25_7)));
+	float a1 = (1 + g) * a->lab.a, a2 = (1 + g) * b->lab.a;
+	float c1p = std::sqrt(a1 * a1 + a->lab.b * a->lab.b), c2p = std::sqrt(a2 * a2 + b->lab.b * b->lab.b);
+	float h1p = (a1 == 0 && a->lab.b == 0) ? 0 : std::atan2(a->lab.b, a1);
+	float h2p = (a2 == 0 && b->lab.b == 0) ? 0 : std::atan2(b->lab.b, a2);
+	if (h1p < 0) h1p += two_pi;
+	if (h2p < 0) h2p += two_pi;
+	float delta_l = b->lab.L - a->lab.L, delta_c = c2p - c1p, delta_h = 0, h_mean = h1p + h2p;
+	if (c1p * c2p != 0){
+		delta_h = h2p - h1p;
+		if (delta_h > pi) delta_h -= two_pi;
+		else if (delta_h < -pi) delta_h += two_pi;
+		if (std::fabs(h1p - h2p) <= pi) h_mean = (h1p + h2p) / 2;
+		else if (h1p + h2p < two_pi) h_mean = (h1p + h2p + two_pi) / 2;
+		else h_mean = (h1p + h2p - two_pi) / 2;
+	}
+	float delta_hp = 2 * std::sqrt(c1p * c2p) * std::sin(delta_h / 2);
+	float l_mean = (a->lab.L + b->lab.L) / 2, cp_mean = (c1p + c2p) / 2, cp_mean7 = std::pow(cp_mean, 7.0f);
+	float t = 1 - 0.17f * std::cos(h_mean - pi / 6) + 0.24f * std::cos(2 * h_mean) + 0.32f * std::cos(3 * h_mean + pi / 30) - 0.20f * std::cos(4 * h_mean - 63 * pi / 180);
+	float h_mean_degrees = h_mean * 180 / pi;
+	float delta_theta = (pi / 6) * std::exp(-((h_mean_degrees - 275) / 25) * ((h_mean_degrees - 275) / 25));
+	float r_c = 2 * std::sqrt(cp_mean7 / (cp_mean7 + pow25_7));
+	float l50 = (l_mean - 50) * (l_mean - 50);
+	float s_l = 1 + 0.015f * l50 / std::sqrt(20 + l50), s_c = 1 + 0.045f * cp_mean, s_h = 1 + 0.015f * cp_mean * t;
+	float r_t = -std::sin(2 * delta_theta) * r_c;
+	float l = delta_l / s_l, c = delta_c / s_c, h = delta_hp / s_h;
+	return std::sqrt(std::max(l * l + c * c + h * h + r_t * c * h, 0.0f));
+}
+void color_rgb_to_cam16ucs(const Color* a, Color* b)
+{
+	Color xyz;
+	color_rgb_to_xyz(a, &xyz, &sRGB_transformation);
+	float rgb[3];
+	cam16_cone_response(xyz.ma, rgb);
+	for (int i = 0; i < 3; i++)
+		rgb[i] = cam16_compress(cam16.d_rgb[i] * rgb[i]);
+	float p_a = rgb[0] - 12 * rgb[1] / 11 + rgb[2] / 11;
+	float p_b = (rgb[0] + rgb[1] - 2 * rgb[2]) / 9;
+	float hue = std::atan2(p_b, p_a);
+	float e_t = 0.25f * (std::cos(hue + 2) + 3.8f);
+	float achromatic = std::max((2 * rgb[0] + rgb[1] + 0.05f * rgb[2] - 0.305f) * cam16.n_bb, 0.0f);
+	float j = 100 * std::pow(achromatic / cam16.a_w, cam16.c * cam16.z);
+	float t = (50000.0f / 13 * cam16.n_c * cam16.n_bb * e_t * std::sqrt(p_a * p_a + p_b * p_b)) / (rgb[0] + rgb[1] + 21.0f / 20 * rgb[2]);
+	float chroma = std::pow(t, 0.9f) * std::sqrt(j / 100) * std::pow(1.64f - std::pow(0.29f, cam16.n), 0.73f);
+	float colorfulness = chroma * std::pow(cam16.f_l, 0.25f);
+	float m = std::log(1 + 0.0228f * colorfulness) / 0.0228f;
+	b->cam16ucs.J = 1.7f * j / (1 + 0.007f * j);
+	b->cam16ucs.a = m * std::cos(hue);
+	b->cam16ucs.b = m * std::sin(hue);
+}
+float color_distance_cam16ucs(const Color* a, const Color* b)
+{
+	float delta_j = a->cam16ucs.J - b->cam16ucs.J, delta_a = a->cam16ucs.a - b->cam16ucs.a, delta_b = a->cam16ucs.b - b->cam16ucs.b;
+	return std::sqrt(delta_j * delta_j + delta_a * delta_a + delta_b * delta_b);
 }
 bool color_equal(const Color* a, const Color* b)
 {
@@ -60,6 +60,11 @@ typedef struct Color{
 			float C;
 			float h;
 		}lch;
+		struct{
+			float J; /**< Lightness */
+			float a; /**< Red-green component */
+			float b; /**< Yellow-blue component */
+		}cam16ucs;
 		struct{
 			float c;
 			float m;
@@ -499,6 +504,40 @@ float color_distance(const Color* a, const Color* b);
  */
 float color_distance_lch(const Color* a, const Color* b);
 
+/**
+ * Get squared color_distance_lch() distance between two colors with precomputed LCh values.
+ * Avoids square root and LCh conversion, so it is suitable for ranking many colors by distance.
+ * @param[in] a First color in Lab color space.
+ * @param[in] a_lch First color in LCh color space.
+ * @param[in] b Second color in Lab color space.
+ * @param[in] b_lch Second color in LCh color space.
+ * @return Squared distance.
+ */
+float color_distance_lch_squared(const Color* a, const Color* a_lch, const Color* b, const Color* b_lch);
+
+/**
+ * Get distance between two colors using CIEDE2000 color difference calculation.
+ * @param[in] a First color in Lab color space.
+ * @param[in] b Second color in Lab color space.
+ * @return Distance.
+ */
+float color_distance_ciede2000(const Color* a, const Color* b);
+
+/**
+ * Convert RGB color space to CAM16-UCS color space with sRGB transformation matrix and sRGB viewing conditions.
+ * @param[in] a Source color in RGB color space.
+ * @param[out] b Destination color in CAM16-UCS color space.
+ */
+void color_rgb_to_cam16ucs(const Color* a, Color* b);
+
+/**
+ * Get distance between two colors in CAM16-UCS color space.
+ * @param[in] a First color in CAM16-UCS color space.
+ * @param[in] b Second color in CAM16-UCS color space.
+ * @return Distance.
+ */
+float color_distance_cam16ucs(const Color* a, const Color* b);
+
 /**
  * Check if colors are equal.
  * @param[in] a First color.
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ColorDistance.h"
+#include "I18N.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+void ColorDistance::prepareRgb(const Color &color, Color &result) const
+{
+	if (lab_input){
+		Color lab;
+		color_rgb_to_lab_d50(&color, &lab);
+		prepare(&lab, &result);
+	}else{
+		prepare(&color, &result);
+	}
+}
+static void prepare_lab(const Color *color, Color *result)
+{
+	result->lab.L = color->lab.L;
+	result->lab.a = color->lab.a;
+	result->lab.b = color->lab.b;
+	result->ma[3] = 0;
+}
+/** Store chroma in fourth component, so that it is not computed for every color pair. */
+static void prepare_lab_chroma(const Color *color, Color *result)
+{
+	result->lab.L = color->lab.L;
+	result->lab.a = color->lab.a;
+	result->lab.b = color->lab.b;
+	result->ma[3] = std::sqrt(color->lab.a * color->lab.a + color->lab.b * color->lab.b);
+}
+static void prepare_cam16ucs(const Color *color, Color *result)
+{
+	color_rgb_to_cam16ucs(color, result);
+	result->ma[3] = 0;
+}
+static void euclidean_distances(const Color &color, const Color *colors, size_t count, float *distances)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	const __m128 q0 = _mm_set1_ps(color.ma[0]), q1 = _mm_set1_ps(color.ma[1]), q2 = _mm_set1_ps(color.ma[2]);
+	for (; i + 4 <= count; i += 4){
+		__m128 c0 = _mm_loadu_ps(colors[i].ma), c1 = _mm_loadu_ps(colors[i + 1].ma), c2 = _mm_loadu_ps(colors[i + 2].ma), c3 = _mm_loadu_ps(colors[i + 3].ma);
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+		__m128 d0 = _mm_sub_ps(c0, q0), d1 = _mm_sub_ps(c1, q1), d2 = _mm_sub_ps(c2, q2);
+		_mm_storeu_ps(distances + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(d0, d0), _mm_mul_ps(d1, d1)), _mm_mul_ps(d2, d2)));
+	}
+#endif
+	for (; i < count; i++){
+		float d0 = colors[i].ma[0] - color.ma[0], d1 = colors[i].ma[1] - color.ma[1], d2 = colors[i].ma[2] - color.ma[2];
+		distances[i] = d0 * d0 + d1 * d1 + d2 * d2;
+	}
+}
+/** Same as color_distance_lch_squared with candidate color as the first color. */
+static void cie94_distances(const Color &color, const Color *colors, size_t count, float *distances)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	const __m128 q_l = _mm_set1_ps(color.lab.L), q_a = _mm_set1_ps(color.lab.a), q_b = _mm_set1_ps(color.lab.b), q_c = _mm_set1_ps(color.ma[3]);
+	const __m128 one = _mm_set1_ps(1), k_c = _mm_set1_ps(0.045f), k_h = _mm_set1_ps(0.015f);
+	for (; i + 4 <= count; i += 4){
+		__m128 l = _mm_loadu_ps(colors[i].ma), a = _mm_loadu_ps(colors[i + 1].ma), b = _mm_loadu_ps(colors[i + 2].ma), c = _mm_loadu_ps(colors[i + 3].ma);
+		_MM_TRANSPOSE4_PS(l, a, b, c);
+		__m128 delta_l = _mm_sub_ps(q_l, l), delta_c = _mm_sub_ps(q_c, c);
+		__m128 delta_a = _mm_sub_ps(a, q_a), delta_b = _mm_sub_ps(b, q_b);
+		__m128 chroma = _mm_div_ps(delta_c, _mm_add_ps(one, _mm_mul_ps(k_c, c)));
+		__m128 hue = _mm_div_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(delta_a, delta_a), _mm_mul_ps(delta_b, delta_b)), delta_c), _mm_add_ps(one, _mm_mul_ps(k_h, c)));
+		_mm_storeu_ps(distances + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(delta_l, delta_l), _mm_mul_ps(chroma, chroma)), _mm_mul_ps(hue, hue)));
+	}
+#endif
+	for (; i < count; i++){
+		const Color &candidate = colors[i];
+		float delta_l = color.lab.L - candidate.lab.L, delta_c = color.ma[3] - candidate.ma[3];
+		float delta_a = candidate.lab.a - color.lab.a, delta_b = candidate.lab.b - color.lab.b;
+		float chroma = delta_c / (1 + 0.045f * candidate.ma[3]);
+		float hue = (delta_a * delta_a + delta_b * delta_b - delta_c) / (1 + 0.015f * candidate.ma[3]);
+		distances[i] = delta_l * delta_l + chroma * chroma + hue * hue;
+	}
+}
+/**
+ * Same as squared color_distance_ciede2000.
+ * Chroma of all colors is precomputed, query color terms are computed once, and cosines of mean hue multiples are derived from a single sine and cosine pair.
+ */
+static void ciede2000_distances(const Color &color, const Color *colors, size_t count, float *distances)
+{
+	const float pow25_7 = 6103515625.0f; // 25^7
+	const float two_pi = static_cast<float>(2 * PI);
+	const float cos30 = std::cos(static_cast<float>(PI / 6)), sin30 = 0.5f;
+	const float cos6 = std::cos(static_cast<float>(PI / 30)), sin6 = std::sin(static_cast<float>(PI / 30));
+	const float cos63 = std::cos(static_cast<float>(63 * PI / 180)), sin63 = std::sin(static_cast<float>(63 * PI / 180));
+	const float q_l = color.lab.L, q_a = color.lab.a, q_b = color.lab.b, q_c = color.ma[3];
+	for (size_t i = 0; i < count; i++){
+		const Color &candidate = colors[i];
+		float c_mean = (q_c + candidate.ma[3]) / 2, c_mean2 = c_mean * c_mean, c_mean7 = c_mean2 * c_mean2 * c_mean2 * c_mean;
+		float g = 1.5f - 0.5f * std::sqrt(c_mean7 / (c_mean7 + pow25_7));
+		float a1 = g * q_a, a2 = g * candidate.lab.a;
+		float c1p = std::sqrt(a1 * a1 + q_b * q_b), c2p = std::sqrt(a2 * a2 + candidate.lab.b * candidate.lab.b);
+		float h1p = (a1 == 0 && q_b == 0) ? 0 : std::atan2(q_b, a1);
+		float h2p = (a2 == 0 && candidate.lab.b == 0) ? 0 : std::atan2(candidate.lab.b, a2);
+		if (h1p < 0) h1p += two_pi;
+		if (h2p < 0) h2p += two_pi;
+		float c_product = c1p * c2p, delta_h = 0, h_mean = h1p + h2p;
+		if (c_product != 0){
+			delta_h = h2p - h1p;
+			if (delta_h > PI) delta_h -= two_pi;
+			else if (delta_h < -PI) delta_h += two_pi;
+			if (std::fabs(h1p - h2p) <= PI) h_mean = (h1p + h2p) / 2;
+			else if (h1p + h2p < two_pi) h_mean = (h1p + h2p + two_pi) / 2;
+			else h_mean = (h1p + h2p - two_pi) / 2;
+		}
+		float delta_hp = 2 * std::sqrt(c_product) * std::sin(delta_h / 2);
+		float cos1 = std::cos(h_mean), sin1 = std::sin(h_mean);
+		float cos2 = cos1 * cos1 - sin1 * sin1, sin2 = 2 * sin1 * cos1;
+		float cos3 = cos2 * cos1 - sin2 * sin1, sin3 = sin2 * cos1 + cos2 * sin1;
+		float cos4 = cos2 * cos2 - sin2 * sin2, sin4 = 2 * sin2 * cos2;
+		float t = 1 - 0.17f * (cos1 * cos30 + sin1 * sin30) + 0.24f * cos2 + 0.32f * (cos3 * cos6 - sin3 * sin6) - 0.20f * (cos4 * cos63 + sin4 * sin63);
+		float h_mean_degrees = h_mean * static_cast<float>(180 / PI);
+		float delta_theta = static_cast<float>(PI / 6) * std::exp(-((h_mean_degrees - 275) / 25) * ((h_mean_degrees - 275) / 25));
+		float cp_mean = (c1p + c2p) / 2, cp_mean2 = cp_mean * cp_mean, cp_mean7 = cp_mean2 * cp_mean2 * cp_mean2 * cp_mean;
+		float r_c = 2 * std::sqrt(cp_mean7 / (cp_mean7 + pow25_7));
+		float l50 = (q_l + candidate.lab.L) / 2 - 50;
+		l50 *= l50;
+		float s_l = 1 + 0.015f * l50 / std::sqrt(20 + l50), s_c = 1 + 0.045f * cp_mean, s_h = 1 + 0.015f * cp_mean * t;
+		float r_t = -std::sin(2 * delta_theta) * r_c;
+		float l = (candidate.lab.L - q_l) / s_l, c = (c2p - c1p) / s_c, h = delta_hp / s_h;
+		distances[i] = std::max(l * l + c * c + h * h + r_t * c * h, 0.0f);
+	}
+}
+static const ColorDistance metrics[] = {
+	{"cie76", N_("CIE76"), true, true, prepare_lab, euclidean_distances},
+	{"cie94", N_("CIE94"), true, false, prepare_lab_chroma, cie94_distances},
+	{"ciede2000", N_("CIEDE2000"), true, false, prepare_lab_chroma, ciede2000_distances},
+	{"cam16ucs", N_("CAM16-UCS"), false, true, prepare_cam16ucs, euclidean_distances},
+	{nullptr, nullptr, false, false, nullptr, nullptr},
+};
+const ColorDistance &color_distance_cie76_metric = metrics[0];
+const ColorDistance &color_distance_cie94_metric = metrics[1];
+const ColorDistance &color_distance_ciede2000_metric = metrics[2];
+const ColorDistance &color_distance_cam16ucs_metric = metrics[3];
+const ColorDistance *color_distance_get_metrics()
+{
+	return metrics;
+}
+const ColorDistance &color_distance_get_metric(const char *name, const ColorDistance &default_metric)
+{
+	if (name == nullptr) return default_metric;
+	for (const ColorDistance *metric = metrics; metric->name; metric++){
+		if (strcmp(metric->name, name) == 0) return *metric;
+	}
+	return default_metric;
+}
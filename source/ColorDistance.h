@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_COLOR_DISTANCE_H_
+#define GPICK_COLOR_DISTANCE_H_
+#include "Color.h"
+#include <cstddef>
+/** \struct ColorDistance
+ * \brief Color difference metric with a batch kernel computing distances from one color to many colors.
+ *
+ * Colors are converted into metric specific representation by prepare() once, so that distances() only does arithmetic.
+ * Distances are squared, which is enough to rank colors.
+ */
+struct ColorDistance
+{
+	const char *name; /**< Identifier used in settings */
+	const char *label; /**< Translatable label */
+	bool lab_input; /**< True if prepare() takes colors in CIE Lab D50 color space instead of RGB color space */
+	bool euclidean; /**< True if distance is Euclidean distance between first three components of prepared colors */
+	/**
+	 * Convert color into representation used by distances().
+	 * @param[in] color Color in RGB or Lab color space, see lab_input.
+	 * @param[out] result Prepared color.
+	 */
+	void (*prepare)(const Color *color, Color *result);
+	/**
+	 * Compute squared distances from one prepared color to many prepared colors.
+	 * @param[in] color Prepared query color.
+	 * @param[in] colors Prepared colors.
+	 * @param[in] count Number of colors.
+	 * @param[out] distances Squared distances, one for each color.
+	 */
+	void (*distances)(const Color &color, const Color *colors, size_t count, float *distances);
+	/**
+	 * Prepare color given in RGB color space.
+	 * @param[in] color Color in RGB color space.
+	 * @param[out] result Prepared color.
+	 */
+	void prepareRgb(const Color &color, Color &result) const;
+};
+/** Euclidean distance in CIE Lab D50 color space. */
+extern const ColorDistance &color_distance_cie76_metric;
+/** Color difference used by color_distance_lch(). */
+extern const ColorDistance &color_distance_cie94_metric;
+/** CIEDE2000 color difference. */
+extern const ColorDistance &color_distance_ciede2000_metric;
+/** Euclidean distance in CAM16-UCS color space. */
+extern const ColorDistance &color_distance_cam16ucs_metric;
+/**
+ * Get all available color difference metrics.
+ * @return Array of metrics terminated by metric with null name.
+ */
+const ColorDistance *color_distance_get_metrics();
+/**
+ * Find color difference metric by name.
+ * @param[in] name Metric name.
+ * @param[in] default_metric Metric returned when no metric has the given name.
+ * @return Color difference metric.
+ */
+const ColorDistance &color_distance_get_metric(const char *name, const ColorDistance &default_metric);
+#endif /* GPICK_COLOR_DISTANCE_H_ */
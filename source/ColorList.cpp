@@ -18,6 +18,7 @@
 
 #include "ColorList.h"
 #include "ColorObject.h"
+#include "ColorListIndex.h"
 #include "dynv/DynvSystem.h"
 #include <algorithm>
 using namespace std;
@@ -26,6 +27,7 @@ ColorList* color_list_new()
 {
 	ColorList* color_list = new ColorList;
 	color_list->params = nullptr;
+	color_list->index = nullptr;
 	color_list->on_insert = nullptr;
 	color_list->on_change = nullptr;
 	color_list->on_delete = nullptr;
@@ -66,6 +68,7 @@ ColorList* color_list_new_with_one_color(ColorList *template_color_list, const C
 }
 void color_list_destroy(ColorList* color_list)
 {
+	if (color_list->index) delete color_list->index;
 	for (auto color_object: color_list->colors){
 		color_object->release();
 	}
@@ -92,6 +95,7 @@ ColorObject* color_list_add_color(ColorList *color_list, const Color *color)
 int color_list_add_color_object(ColorList *color_list, ColorObject *color_object, bool add_to_palette)
 {
 	color_list->colors.push_back(color_object->reference());
+	if (color_list->index) color_list->index->add(color_object);
 	if (add_to_palette && color_list->on_insert)
 		color_list->on_insert(color_list, color_object);
 	return 0;
@@ -100,6 +104,7 @@ int color_list_add(ColorList *color_list, ColorList *items, bool add_to_palette)
 {
 	for (auto color_object: items->colors){
 		color_list->colors.push_back(color_object->reference());
+		if (color_list->index) color_list->index->add(color_object);
 		if (add_to_palette && color_list->on_insert && color_object->isVisible())
 			color_list->on_insert(color_list, color_object);
 	}
@@ -111,6 +116,7 @@ int color_list_remove_color_object(ColorList *color_list, ColorObject *color_obj
 	if (i != color_list->colors.end()){
 		if (color_list->on_delete) color_list->on_delete(color_list, color_object);
 		color_list->colors.erase(i);
+		if (color_list->index) color_list->index->remove(color_object);
 		color_object->release();
 		return 0;
 	}else return -1;
@@ -120,16 +126,18 @@ int color_list_remove_selected(ColorList *color_list)
 	ColorList::iter i=color_list->colors.begin();
 	while (i != color_list->colors.end()){
 		if ((*i)->isSelected()){
+			if (color_list->index) color_list->index->remove(*i);
 			(*i)->release();
 			i = color_list->colors.erase(i);
 		}else ++i;
 	}
-	color_list->on_delete_selected(color_list);
+	if (color_list->on_delete_selected) color_list->on_delete_selected(color_list);
 	return 0;
 }
 int color_list_remove_all(ColorList *color_list)
 {
 	ColorList::iter i;
+	if (color_list->index) color_list->index->clear();
 	if (color_list->on_clear){
 		color_list->on_clear(color_list);
 		for (i = color_list->colors.begin(); i != color_list->colors.end(); ++i){
@@ -148,6 +156,11 @@ size_t color_list_get_count(ColorList *color_list)
 {
 	return color_list->colors.size();
 }
+void color_list_notify_text_change(ColorList *color_list)
+{
+	if (color_list->on_change)
+		color_list->on_change(color_list, nullptr);
+}
 int color_list_get_positions(ColorList *color_list)
 {
 	if (color_list->on_get_positions){
@@ -163,3 +176,28 @@ int color_list_get_positions(ColorList *color_list)
 	}
 	return 0;
 }
+ColorListIndex &color_list_get_index(ColorList *color_list)
+{
+	if (!color_list->index){
+		color_list->index = new ColorListIndex();
+		for (auto color_object: color_list->colors)
+			color_list->index->add(color_object);
+	}
+	return *color_list->index;
+}
+size_t color_list_remove_duplicates(ColorList *color_list, float threshold)
+{
+	vector<ColorListIndex::Cluster> clusters;
+	color_list_get_index(color_list).cluster(color_list->colors, threshold, clusters);
+	if (clusters.empty()) return 0;
+	for (auto color_object: color_list->colors)
+		color_object->setSelected(false);
+	size_t count = 0;
+	for (auto &cluster: clusters){
+		for (auto color_object: cluster.members)
+			color_object->setSelected(true);
+		count += cluster.members.size();
+	}
+	color_list_remove_selected(color_list);
+	return count;
+}
@@ -22,16 +22,18 @@
 #include <list>
 #include <cstddef>
 struct ColorObject;
+struct ColorListIndex;
 struct dynvSystem;
 struct ColorList
 {
 	std::list<ColorObject*> colors;
+	ColorListIndex *index; /**< Spatial index, created by color_list_get_index() */
 	typedef std::list<ColorObject*>::iterator iter;
 	dynvSystem *params;
 	int (*on_insert)(ColorList *color_list, ColorObject *color_object);
 	int (*on_delete)(ColorList *color_list, ColorObject *color_object);
 	int (*on_delete_selected)(ColorList *color_list);
-	int (*on_change)(ColorList *color_list, ColorObject *color_object);
+	int (*on_change)(ColorList *color_list, ColorObject *color_object); /**< Called with nullptr color object when text representation of all colors has changed */
 	int (*on_clear)(ColorList *color_list);
 	int (*on_get_positions)(ColorList *color_list);
 	void* userdata;
@@ -51,5 +53,23 @@ int color_list_remove_selected(ColorList *color_list);
 int color_list_remove_all(ColorList *color_list);
 size_t color_list_get_count(ColorList *color_list);
 int color_list_get_positions(ColorList *color_list);
+/**
+ * Notify color list owner that text representation of all colors has changed, for example after color list converter switch.
+ * @param[in] color_list Color list.
+ */
+void color_list_notify_text_change(ColorList *color_list);
+/**
+ * Get spatial index of colors in color list. Index is created on first call and then kept up to date by color list functions.
+ * @param[in] color_list Color list.
+ * @return Spatial index.
+ */
+ColorListIndex &color_list_get_index(ColorList *color_list);
+/**
+ * Remove near-duplicate colors, keeping first color of each cluster found by ColorListIndex::cluster().
+ * @param[in] color_list Color list.
+ * @param[in] threshold Maximum distance between kept color and removed colors.
+ * @return Number of removed colors.
+ */
+size_t color_list_remove_duplicates(ColorList *color_list, float threshold);
 
 #endif /* GPICK_COLOR_LIST_H_ */
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ColorListIndex.h"
+#include "ColorObject.h"
+#include "ColorDistance.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+using namespace std;
+
+struct ColorListIndex::Impl
+{
+	/** Grid cell size in units of distance metric. */
+	static constexpr float cell_size = 8;
+	/** Lists smaller than this are searched without the grid. */
+	static const size_t linear_search_limit = 64;
+	/** Color objects in one grid cell, with colors prepared for distance metric stored contiguously for batch distance kernel. */
+	struct Cell
+	{
+		vector<ColorObject*> color_objects;
+		vector<Color> colors;
+	};
+	struct Object
+	{
+		Color color; /**< Color in RGB color space at the time of insertion, used to detect color changes */
+		int64_t key;
+		size_t count;
+	};
+	const ColorDistance &m_distance;
+	unordered_map<int64_t, Cell> m_cells;
+	unordered_map<ColorObject*, Object> m_objects;
+	uint64_t m_synced_changes;
+	int m_min[3], m_max[3];
+	vector<float> m_distances;
+	Impl(const ColorDistance &distance):
+		m_distance(distance),
+		m_synced_changes(ColorObject::getIndexedColorChanges())
+	{
+		resetBounds();
+	}
+	~Impl()
+	{
+		clear();
+	}
+	void resetBounds()
+	{
+		for (int i = 0; i < 3; i++){
+			m_min[i] = 0;
+			m_max[i] = -1;
+		}
+	}
+	/** Grid is built in color space of the metric when distances are Euclidean there, and in Lab color space otherwise. Only the former allows bounding search by grid cells. */
+	bool gridBounded() const
+	{
+		return m_distance.euclidean;
+	}
+	static int cellCoordinate(float value)
+	{
+		return static_cast<int>(floor(value / cell_size));
+	}
+	static int64_t cellKey(int x, int y, int z)
+	{
+		return (int64_t(x & 0x1fffff) << 42) | (int64_t(y & 0x1fffff) << 21) | int64_t(z & 0x1fffff);
+	}
+	void insert(ColorObject *color_object, Object &object)
+	{
+		Color prepared;
+		const Color &lab = color_object->getLab();
+		m_distance.prepare(m_distance.lab_input ? &lab : &color_object->getColor(), &prepared);
+		const Color &position = gridBounded() ? prepared : lab;
+		int cell[3];
+		for (int i = 0; i < 3; i++){
+			cell[i] = cellCoordinate(position.ma[i]);
+			if (m_min[i] > m_max[i]){
+				m_min[i] = m_max[i] = cell[i];
+			}else{
+				m_min[i] = std::min(m_min[i], cell[i]);
+				m_max[i] = std::max(m_max[i], cell[i]);
+			}
+		}
+		object.key = cellKey(cell[0], cell[1], cell[2]);
+		Cell &grid_cell = m_cells[object.key];
+		grid_cell.color_objects.push_back(color_object);
+		grid_cell.colors.push_back(prepared);
+	}
+	void erase(ColorObject *color_object, const Object &object)
+	{
+		auto cell = m_cells.find(object.key);
+		if (cell == m_cells.end()) return;
+		auto &color_objects = cell->second.color_objects;
+		auto &colors = cell->second.colors;
+		for (size_t i = 0; i < color_objects.size(); i++){
+			if (color_objects[i] == color_object){
+				color_objects[i] = color_objects.back();
+				color_objects.pop_back();
+				colors[i] = colors.back();
+				colors.pop_back();
+				break;
+			}
+		}
+		if (color_objects.empty())
+			m_cells.erase(cell);
+	}
+	void add(ColorObject *color_object)
+	{
+		auto i = m_objects.find(color_object);
+		if (i != m_objects.end()){
+			i->second.count++;
+			return;
+		}
+		Object &object = m_objects[color_object];
+		object.color = color_object->getColor();
+		object.count = 1;
+		insert(color_object, object);
+		color_object->addIndexReference();
+	}
+	void remove(ColorObject *color_object)
+	{
+		auto i = m_objects.find(color_object);
+		if (i == m_objects.end()) return;
+		if (--i->second.count > 0) return;
+		erase(color_object, i->second);
+		color_object->releaseIndexReference();
+		m_objects.erase(i);
+		if (m_objects.empty())
+			resetBounds();
+	}
+	void clear()
+	{
+		for (auto &object: m_objects)
+			object.first->releaseIndexReference();
+		m_objects.clear();
+		m_cells.clear();
+		resetBounds();
+	}
+	/** Move color objects changed by ColorObject::setColor into their new cells. */
+	void sync()
+	{
+		uint64_t changes = ColorObject::getIndexedColorChanges();
+		if (changes == m_synced_changes) return;
+		m_synced_changes = changes;
+		for (auto &object: m_objects){
+			const Color &color = object.first->getColor();
+			if (memcmp(&color, &object.second.color, sizeof(Color)) == 0) continue;
+			erase(object.first, object.second);
+			object.second.color = color;
+			insert(object.first, object.second);
+		}
+	}
+	/** Compute squared distances from query to all colors in cell and call callback for each of them. */
+	template<typename Callback>
+	void visitCell(const Color &query, const Cell &cell, Callback callback)
+	{
+		size_t count = cell.colors.size();
+		m_distances.resize(count);
+		m_distance.distances(query, cell.colors.data(), count, m_distances.data());
+		for (size_t i = 0; i < count; i++)
+			callback(m_distances[i], cell.color_objects[i]);
+	}
+	template<typename Callback>
+	void forCell(const Color &query, int x, int y, int z, Callback callback)
+	{
+		if (x < m_min[0] || x > m_max[0] || y < m_min[1] || y > m_max[1] || z < m_min[2] || z > m_max[2]) return;
+		auto cell = m_cells.find(cellKey(x, y, z));
+		if (cell == m_cells.end()) return;
+		visitCell(query, cell->second, callback);
+	}
+	template<typename Callback>
+	void forAll(const Color &query, Callback callback)
+	{
+		for (auto &cell: m_cells)
+			visitCell(query, cell.second, callback);
+	}
+	void nearest(const Color &color, size_t count, vector<Result> &result)
+	{
+		result.clear();
+		sync();
+		if (count == 0 || m_objects.empty()) return;
+		Color query;
+		m_distance.prepareRgb(color, query);
+		//max heap of best squared distances found so far
+		auto compare = [](const Result &a, const Result &b){ return a.first < b.first; };
+		auto consider = [&](float distance, ColorObject *color_object){
+			if (result.size() < count){
+				result.push_back(Result(distance, color_object));
+				push_heap(result.begin(), result.end(), compare);
+			}else if (distance < result.front().first){
+				pop_heap(result.begin(), result.end(), compare);
+				result.back() = Result(distance, color_object);
+				push_heap(result.begin(), result.end(), compare);
+			}
+		};
+		if (m_objects.size() <= linear_search_limit || !gridBounded()){
+			forAll(query, consider);
+		}else{
+			int cell[3], max_ring = 0;
+			for (int i = 0; i < 3; i++){
+				cell[i] = cellCoordinate(query.ma[i]);
+				max_ring = std::max(max_ring, std::max(cell[i] - m_min[i], m_max[i] - cell[i]));
+			}
+			for (int ring = 0; ring <= max_ring; ring++){
+				for (int x = cell[0] - ring; x <= cell[0] + ring; x++){
+					bool x_edge = x == cell[0] - ring || x == cell[0] + ring;
+					for (int y = cell[1] - ring; y <= cell[1] + ring; y++){
+						bool y_edge = y == cell[1] - ring || y == cell[1] + ring;
+						if (x_edge || y_edge){
+							for (int z = cell[2] - ring; z <= cell[2] + ring; z++)
+								forCell(query, x, y, z, consider);
+						}else{
+							forCell(query, x, y, cell[2] - ring, consider);
+							if (ring > 0) forCell(query, x, y, cell[2] + ring, consider);
+						}
+					}
+				}
+				//colors in further rings are at least ring * cell_size away
+				float bound = ring * cell_size;
+				if (result.size() == count && result.front().first <= bound * bound)
+					break;
+			}
+		}
+		sort_heap(result.begin(), result.end(), compare);
+		for (auto &item: result)
+			item.first = sqrt(item.first);
+	}
+	void withinRadius(const Color &color, float radius, vector<Result> &result)
+	{
+		result.clear();
+		sync();
+		if (m_objects.empty() || radius < 0) return;
+		Color query;
+		m_distance.prepareRgb(color, query);
+		float squared_radius = radius * radius;
+		auto consider = [&](float distance, ColorObject *color_object){
+			if (distance <= squared_radius)
+				result.push_back(Result(distance, color_object));
+		};
+		if (m_objects.size() <= linear_search_limit || !gridBounded()){
+			forAll(query, consider);
+		}else{
+			int from[3], to[3];
+			for (int i = 0; i < 3; i++){
+				from[i] = std::max(cellCoordinate(query.ma[i] - radius), m_min[i]);
+				to[i] = std::min(cellCoordinate(query.ma[i] + radius), m_max[i]);
+			}
+			for (int x = from[0]; x <= to[0]; x++)
+				for (int y = from[1]; y <= to[1]; y++)
+					for (int z = from[2]; z <= to[2]; z++)
+						forCell(query, x, y, z, consider);
+		}
+		sort(result.begin(), result.end(), [](const Result &a, const Result &b){ return a.first < b.first; });
+		for (auto &item: result)
+			item.first = sqrt(item.first);
+	}
+	void cluster(const list<ColorObject*> &color_objects, float threshold, vector<Cluster> &clusters)
+	{
+		clusters.clear();
+		unordered_set<ColorObject*> assigned;
+		assigned.reserve(m_objects.size());
+		vector<Result> result;
+		for (auto color_object: color_objects){
+			if (assigned.count(color_object) != 0 || m_objects.count(color_object) == 0) continue;
+			assigned.insert(color_object);
+			withinRadius(color_object->getColor(), threshold, result);
+			Cluster cluster;
+			cluster.representative = color_object;
+			for (auto &item: result){
+				if (assigned.insert(item.second).second)
+					cluster.members.push_back(item.second);
+			}
+			if (!cluster.members.empty())
+				clusters.push_back(std::move(cluster));
+		}
+	}
+};
+ColorListIndex::ColorListIndex():
+	m_impl(new Impl(color_distance_cie76_metric))
+{
+}
+ColorListIndex::ColorListIndex(const ColorDistance &distance):
+	m_impl(new Impl(distance))
+{
+}
+ColorListIndex::~ColorListIndex()
+{
+}
+void ColorListIndex::add(ColorObject *color_object)
+{
+	m_impl->add(color_object);
+}
+void ColorListIndex::remove(ColorObject *color_object)
+{
+	m_impl->remove(color_object);
+}
+void ColorListIndex::clear()
+{
+	m_impl->clear();
+}
+size_t ColorListIndex::size() const
+{
+	return m_impl->m_objects.size();
+}
+void ColorListIndex::nearest(const Color &color, size_t count, std::vector<Result> &result)
+{
+	m_impl->nearest(color, count, result);
+}
+void ColorListIndex::withinRadius(const Color &color, float radius, std::vector<Result> &result)
+{
+	m_impl->withinRadius(color, radius, result);
+}
+void ColorListIndex::cluster(const std::list<ColorObject*> &color_objects, float threshold, std::vector<Cluster> &clusters)
+{
+	m_impl->cluster(color_objects, threshold, clusters);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_COLOR_LIST_INDEX_H_
+#define GPICK_COLOR_LIST_INDEX_H_
+#include "Color.h"
+#include <memory>
+#include <vector>
+#include <utility>
+#include <list>
+#include <cstddef>
+struct ColorObject;
+struct ColorDistance;
+/** \struct ColorListIndex
+ * \brief Spatial index over color objects.
+ *
+ * Colors are stored in a uniform grid, so insertion and removal take constant time and nearest neighbour queries only check cells around the query color.
+ * Distance is measured with a ColorDistance metric, CIE76 color difference by default.
+ * Grid search is only used for metrics which are Euclidean in their color space, other metrics compare query color with every indexed color using batch distance kernel.
+ * Color changes made through ColorObject::setColor are picked up by the next query.
+ */
+struct ColorListIndex
+{
+	typedef std::pair<float, ColorObject*> Result;
+	/** Group of near-duplicate colors. */
+	struct Cluster
+	{
+		ColorObject *representative;
+		std::vector<ColorObject*> members; /**< Color objects not further than threshold from representative, excluding representative itself */
+	};
+	ColorListIndex();
+	ColorListIndex(const ColorDistance &distance);
+	~ColorListIndex();
+	void add(ColorObject *color_object);
+	void remove(ColorObject *color_object);
+	void clear();
+	size_t size() const;
+	/**
+	 * Find nearest color objects.
+	 * @param[in] color Color in RGB color space.
+	 * @param[in] count Maximum number of color objects to find.
+	 * @param[out] result Distances and color objects sorted by distance.
+	 */
+	void nearest(const Color &color, size_t count, std::vector<Result> &result);
+	/**
+	 * Find all color objects not further than radius.
+	 * @param[in] color Color in RGB color space.
+	 * @param[in] radius Maximum distance.
+	 * @param[out] result Distances and color objects sorted by distance.
+	 */
+	void withinRadius(const Color &color, float radius, std::vector<Result> &result);
+	/**
+	 * Group indexed color objects into clusters of near-duplicate colors.
+	 * Color objects are visited in the given order, and each color object not yet assigned to a cluster becomes a representative of a new cluster containing all unassigned color objects within threshold.
+	 * @param[in] color_objects Color objects in order of preference for cluster representatives. Color objects not in the index are ignored.
+	 * @param[in] threshold Maximum distance between cluster representative and cluster members.
+	 * @param[out] clusters Clusters with at least one member, in order of their representatives.
+	 */
+	void cluster(const std::list<ColorObject*> &color_objects, float threshold, std::vector<Cluster> &clusters);
+	private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+#endif /* GPICK_COLOR_LIST_INDEX_H_ */
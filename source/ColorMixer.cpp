@@ -107,7 +107,7 @@ struct ColorMixerColorNameAssigner: public ToolColorNameAssigner {
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color)
 		{
 			m_stream.str("");
-			m_stream << color_names_get(m_gs->getColorNames(), color, false) << " " << _("color mixer") << " " << m_ident;
+			m_stream << getColorName(color) << " " << _("color mixer") << " " << m_ident;
 			return m_stream.str();
 		}
 };
@@ -17,12 +17,18 @@
  */
 
 #include "ColorObject.h"
+#include <atomic>
 using namespace std;
 
+static atomic<uint64_t> indexed_color_changes(0);
+
 ColorObject::ColorObject():
 	m_refcnt(0),
+	m_index_references(0),
 	m_name(),
 	m_color(),
+	m_lab_valid(false),
+	m_lch_valid(false),
 	m_position(0),
 	m_position_set(false),
 	m_selected(false),
@@ -32,8 +38,11 @@ ColorObject::ColorObject():
 }
 ColorObject::ColorObject(const char *name, const Color &color):
 	m_refcnt(0),
+	m_index_references(0),
 	m_name(name),
 	m_color(color),
+	m_lab_valid(false),
+	m_lch_valid(false),
 	m_position(0),
 	m_position_set(false),
 	m_selected(false),
@@ -43,8 +52,11 @@ ColorObject::ColorObject(const char *name, const Color &color):
 }
 ColorObject::ColorObject(const std::string &name, const Color &color):
 	m_refcnt(0),
+	m_index_references(0),
 	m_name(name),
 	m_color(color),
+	m_lab_valid(false),
+	m_lch_valid(false),
 	m_position(0),
 	m_position_set(false),
 	m_selected(false),
@@ -72,6 +84,25 @@ const Color &ColorObject::getColor() const
 void ColorObject::setColor(const Color &color)
 {
 	m_color = color;
+	m_lab_valid = m_lch_valid = false;
+	if (m_index_references > 0)
+		indexed_color_changes.fetch_add(1, memory_order_relaxed);
+}
+const Color &ColorObject::getLab() const
+{
+	if (!m_lab_valid){
+		color_rgb_to_lab_d50(&m_color, &m_lab);
+		m_lab_valid = true;
+	}
+	return m_lab;
+}
+const Color &ColorObject::getLch() const
+{
+	if (!m_lch_valid){
+		color_lab_to_lch(&getLab(), &m_lch);
+		m_lch_valid = true;
+	}
+	return m_lch;
 }
 const std::string &ColorObject::getName() const
 {
@@ -135,3 +166,16 @@ size_t ColorObject::getReferenceCount() const
 {
 	return m_refcnt;
 }
+void ColorObject::addIndexReference()
+{
+	m_index_references++;
+}
+void ColorObject::releaseIndexReference()
+{
+	if (m_index_references > 0)
+		m_index_references--;
+}
+uint64_t ColorObject::getIndexedColorChanges()
+{
+	return indexed_color_changes.load(memory_order_relaxed);
+}
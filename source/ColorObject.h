@@ -20,6 +20,7 @@
 #define GPICK_COLOR_OBJECT_H_
 #include "Color.h"
 #include <string>
+#include <cstdint>
 struct ColorObject
 {
 	ColorObject();
@@ -29,6 +30,13 @@ struct ColorObject
 	void release();
 	const Color &getColor() const;
 	void setColor(const Color &color);
+	/**
+	 * Get color in CIE Lab D50 color space.
+	 * Value is computed on first call and cached until color is changed, so it must not be called from multiple threads at the same time.
+	 */
+	const Color &getLab() const;
+	/** Get color in CIE LCh D50 color space. Cached like getLab(). */
+	const Color &getLch() const;
 	const std::string &getName() const;
 	void setName(const std::string &name);
 	ColorObject* copy() const;
@@ -43,10 +51,18 @@ struct ColorObject
 	size_t getReferenceCount() const;
 	void setVisible(bool visible);
 	bool isVisible() const;
+	/** Called by ColorListIndex when color object is added to or removed from index. */
+	void addIndexReference();
+	void releaseIndexReference();
+	/** Number of color changes made to color objects contained in any ColorListIndex. Indexes use it to detect that they must be updated. */
+	static uint64_t getIndexedColorChanges();
 	private:
 	size_t m_refcnt;
+	size_t m_index_references;
 	std::string m_name;
 	Color m_color;
+	mutable Color m_lab, m_lch;
+	mutable bool m_lab_valid, m_lch_valid;
 	size_t m_position;
 	bool m_position_set;
 	bool m_selected;
@@ -45,6 +45,7 @@
 #include "color_names/ColorNames.h"
 #include "ScreenReader.h"
 #include "Sampler.h"
+#include "Tracing.h"
 #include <gdk/gdkkeysyms.h>
 #include <math.h>
 #ifdef _MSC_VER
@@ -105,6 +106,7 @@ static int source_get_nth_color(ColorPickerArgs *args, uint32_t color_n, ColorOb
 
 static void updateMainColorNow(ColorPickerArgs* args)
 {
+	TRACE_SCOPE("ColorPicker::updateMainColorNow");
 	if (!dynv_get_bool_wd(args->params, "zoomed_enabled", true)){
 		Color c;
 		gtk_swatch_get_active_color(GTK_SWATCH(args->swatch_display), &c);
@@ -115,6 +117,7 @@ static void updateMainColorNow(ColorPickerArgs* args)
 }
 
 static gboolean updateMainColor( gpointer data ){
+	TRACE_SCOPE("ColorPicker::updateMainColor");
 	ColorPickerArgs* args=(ColorPickerArgs*)data;
 	GdkScreen *screen;
 	GdkModifierType state;
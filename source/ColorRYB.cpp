@@ -26,35 +26,27 @@
 #include <math.h>
 #include <stdio.h>
 #include <list>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
 typedef math::Vec2<double> point;
 typedef math::BezierCubicCurve<point, double> bezier;
 
-double bezier_eval_at_x(list<bezier*>& channel, double x, double delta){
+static double bezier_eval_at_x(list<bezier*>& channel, double x){
 	for (list<bezier*>::iterator i=channel.begin(); i != channel.end(); ++i){
 		if (x>=(*i)->p0.x && x<=(*i)->p3.x){
-			double width = ((*i)->p3.x-(*i)->p0.x);
-			double t = (x-(*i)->p0.x)/width;
-			double d;
-			point v;
-
-
+			//x is monotonic in t for all curve segments, so bisection always converges
+			double t_min = 0, t_max = 1;
 			for (int limit=50; limit>0; --limit){
-				v = (**i)(t);
-				d = v.x - x;
-
-				if (fabs(d)<delta) return v.y;
-
-				//printf("%f %f %f %f\n", t, v.x, v.y, d);
-
-				t -= d/width;
-				if (t>1)
-					t=1;
-				else if (t<0)
-					t=0;
+				double t = (t_min + t_max) / 2;
+				if ((**i)(t).x < x)
+					t_min = t;
+				else
+					t_max = t;
 			}
+			return (**i)((t_min + t_max) / 2).y;
 		}
 	}
 	return 0;
@@ -112,7 +104,7 @@ static void color_get_ryb_curves(list<bezier*> &red, list<bezier*> &green, list<
 	);*/
 }
 
-int color_rgbhue_to_rybhue(double rgb_hue, double* ryb_hue){
+int color_rgbhue_to_rybhue_exact(double rgb_hue, double* ryb_hue){
 	list<bezier*> red, green, blue;
 	color_get_ryb_curves(red, green, blue);
 
@@ -123,9 +115,9 @@ int color_rgbhue_to_rybhue(double rgb_hue, double* ryb_hue){
 
 	Color color, color2;
 	for (int limit=100; limit>0; --limit){
-		color.rgb.red = bezier_eval_at_x(red, hue*36, 0.01),
-		color.rgb.green = bezier_eval_at_x(green, hue*36, 0.01),
-		color.rgb.blue = bezier_eval_at_x(blue, hue*36, 0.01);
+		color.rgb.red = bezier_eval_at_x(red, hue*36),
+		color.rgb.green = bezier_eval_at_x(green, hue*36),
+		color.rgb.blue = bezier_eval_at_x(blue, hue*36);
 
 		color_rgb_to_hsv(&color, &color2);
 
@@ -143,6 +135,92 @@ int color_rgbhue_to_rybhue(double rgb_hue, double* ryb_hue){
 	return -1;
 }
 
+void color_rybhue_to_rgb_exact(double hue, Color* color){
+	list<bezier*> red, green, blue;
+	color_get_ryb_curves(red, green, blue);
+
+	color->rgb.red = bezier_eval_at_x(red, hue*36),
+	color->rgb.green = bezier_eval_at_x(green, hue*36),
+	color->rgb.blue = bezier_eval_at_x(blue, hue*36);
+}
+
+/** Number of intervals in RYB hue lookup tables. Multiple of 36 so that curve segment joins fall on table nodes. */
+static const int ryb_table_size = 36 * 32;
+/** Forward mapping is sampled this many times more densely for inverse lookups. */
+static const int ryb_table_oversampling = 16;
+static const int ryb_inverse_samples = ryb_table_size * ryb_table_oversampling;
+
+struct RybTables
+{
+	Color rgb[ryb_table_size + 1]; /**< RGB colors for uniformly spaced RYB hues */
+	vector<double> rgb_hues; /**< RGB hues for densely and uniformly spaced RYB hues, monotonic */
+	int buckets[ryb_table_size + 2]; /**< First rgb_hues index for each uniformly spaced RGB hue */
+	RybTables():
+		rgb_hues(ryb_inverse_samples + 1)
+	{
+		for (int i = 0; i <= ryb_table_size; i++){
+			color_rybhue_to_rgb_exact(i / double(ryb_table_size), &rgb[i]);
+		}
+		Color color, hsv;
+		for (int i = 0; i <= ryb_inverse_samples; i++){
+			color_rybhue_to_rgb_exact(i / double(ryb_inverse_samples), &color);
+			color_rgb_to_hsv(&color, &hsv);
+			rgb_hues[i] = hsv.hsv.hue;
+		}
+		//both ends are pure red, which has RGB hue 0
+		rgb_hues[0] = 0;
+		rgb_hues[ryb_inverse_samples] = 1;
+		for (int i = 1; i <= ryb_inverse_samples; i++){
+			if (rgb_hues[i] < rgb_hues[i - 1])
+				rgb_hues[i] = rgb_hues[i - 1];
+		}
+		int i = 0;
+		for (int j = 0; j <= ryb_table_size; j++){
+			double rgb_hue = j / double(ryb_table_size);
+			while (i < ryb_inverse_samples - 1 && rgb_hues[i + 1] < rgb_hue)
+				i++;
+			buckets[j] = i;
+		}
+		buckets[ryb_table_size + 1] = ryb_inverse_samples - 1;
+	}
+};
+
+static const RybTables &get_ryb_tables()
+{
+	static RybTables tables;
+	return tables;
+}
+
+void color_ryb_init(){
+	get_ryb_tables();
+}
+
+int color_rgbhue_to_rybhue(double rgb_hue, double* ryb_hue){
+	const RybTables &tables = get_ryb_tables();
+	rgb_hue = clamp_double(rgb_hue, 0, 1);
+	int bucket = std::min(int(rgb_hue * ryb_table_size), ryb_table_size - 1);
+	//find dense sample interval [i, i + 1] containing rgb_hue, bucket table limits search range
+	auto begin = tables.rgb_hues.begin() + tables.buckets[bucket] + 1;
+	auto end = tables.rgb_hues.begin() + tables.buckets[bucket + 1] + 1;
+	int i = std::lower_bound(begin, end, rgb_hue) - tables.rgb_hues.begin() - 1;
+	i = clamp_int(i, 0, ryb_inverse_samples - 1);
+	double span = tables.rgb_hues[i + 1] - tables.rgb_hues[i];
+	double mix = span > 0 ? clamp_double((rgb_hue - tables.rgb_hues[i]) / span, 0, 1) : 0;
+	*ryb_hue = (i + mix) / ryb_inverse_samples;
+	return 0;
+}
+
+void color_rybhue_to_rgb(double hue, Color* color){
+	const RybTables &tables = get_ryb_tables();
+	double x = clamp_double(hue, 0, 1) * ryb_table_size;
+	int index = std::min(int(x), ryb_table_size - 1);
+	float mix = static_cast<float>(x - index);
+	const Color &a = tables.rgb[index], &b = tables.rgb[index + 1];
+	color->rgb.red = mix_float(a.rgb.red, b.rgb.red, mix);
+	color->rgb.green = mix_float(a.rgb.green, b.rgb.green, mix);
+	color->rgb.blue = mix_float(a.rgb.blue, b.rgb.blue, mix);
+}
+
 double color_rybhue_to_rgbhue_f(double hue){
 	if (hue>=4.0/6.0 && hue<=6.0/6.0){
 		return ((285.12*hue*hue)-(81.252*hue)+155.18)/360.0;
@@ -181,15 +259,6 @@ int color_rgbhue_to_rybhue_f(double rgb_hue, double* ryb_hue){
 }
 
 
-void color_rybhue_to_rgb(double hue, Color* color){
-	list<bezier*> red, green, blue;
-	color_get_ryb_curves(red, green, blue);
-
-	color->rgb.red = bezier_eval_at_x(red, hue*36, 0.01),
-	color->rgb.green = bezier_eval_at_x(green, hue*36, 0.01),
-	color->rgb.blue = bezier_eval_at_x(blue, hue*36, 0.01);
-}
-
 double color_ryb_transform_lightness(double hue1, double hue2){
 
 	double t;
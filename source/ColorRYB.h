@@ -29,9 +29,31 @@
 double color_ryb_transform_lightness(double hue1, double hue2);
 double color_ryb_transform_hue(double hue, bool forward);
 
+/**
+ * Build RYB hue lookup tables. Called from color_init(), tables are also built on first use if needed.
+ */
+void color_ryb_init();
+
+/**
+ * Convert RYB hue to RGB color using lookup table.
+ * Maximum channel error compared to color_rybhue_to_rgb_exact() is below 0.0001.
+ * @param[in] hue RYB hue in range [0, 1].
+ * @param[out] color RGB color.
+ */
 void color_rybhue_to_rgb(double hue, Color* color);
+
+/**
+ * Convert RGB hue to RYB hue using lookup table.
+ * Maximum hue error compared to exact inverse of color_rybhue_to_rgb_exact() is below 0.00001.
+ * @param[in] rgb_hue RGB hue in range [0, 1].
+ * @param[out] ryb_hue RYB hue.
+ * @return Always 0.
+ */
 int color_rgbhue_to_rybhue(double rgb_hue, double* ryb_hue);
 
+void color_rybhue_to_rgb_exact(double hue, Color* color);
+int color_rgbhue_to_rybhue_exact(double rgb_hue, double* ryb_hue);
+
 double color_rybhue_to_rgbhue_f(double hue);
 int color_rgbhue_to_rybhue_f(double rgb_hue, double* ryb_hue);
 
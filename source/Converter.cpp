@@ -22,6 +22,8 @@
 #include "lua/Color.h"
 #include "lua/ColorObject.h"
 #include "lua/Script.h"
+#include "lua/UserdataPool.h"
+#include "Tracing.h"
 #include <string.h>
 #include <stdlib.h>
 #include <glib.h>
@@ -33,25 +35,60 @@
 #include <vector>
 #include <iostream>
 #include <functional>
+#include <algorithm>
 using namespace std;
 extern "C"{
 #include <lualib.h>
 #include <lauxlib.h>
 }
-Converter::Converter(const char *name, const char *label, lua::Ref &&serialize, lua::Ref &&deserialize):
+namespace {
+/** Records Lua memory allocated while serializing colors, so that garbage collector pressure can be checked in traces. */
+struct AllocationTrace
+{
+	AllocationTrace(lua_State *L, size_t count):
+		m_L(L),
+		m_count(count),
+		m_active(tracing::active() != nullptr),
+		m_allocated(m_active ? lua::allocatedBytes(L) : 0)
+	{
+	}
+	~AllocationTrace()
+	{
+		if (!m_active || m_count == 0)
+			return;
+		uint64_t allocated = lua::allocatedBytes(m_L) - m_allocated;
+		tracing::count("converter.serialized_colors", m_count);
+		tracing::count("converter.lua_allocated_bytes", allocated);
+		tracing::sample("converter.lua_allocated_bytes_per_color", static_cast<double>(allocated) / m_count);
+		tracing::sample("converter.lua_heap_kilobytes", lua_gc(m_L, LUA_GCCOUNT, 0));
+	}
+	private:
+	lua_State *m_L;
+	size_t m_count;
+	bool m_active;
+	uint64_t m_allocated;
+};
+}
+/** Number of color objects passed to Lua in one call by batch serialization. */
+static const size_t serialize_chunk_size = 1024;
+Converter::Converter(const char *name, const char *label, lua::Ref &&serialize, lua::Ref &&deserialize, lua::Ref &&serialize_many):
 	m_name(name),
 	m_label(label),
 	m_serialize(move(serialize)),
 	m_deserialize(move(deserialize)),
+	m_serialize_many(move(serialize_many)),
 	m_copy(false),
 	m_paste(false)
 {
 }
 std::string Converter::serialize(const ColorObject *color_object, const ConverterSerializePosition &position)
 {
+	TRACE_SCOPE("Converter::serialize");
 	if (!m_serialize.valid())
 		return "";
 	lua_State *L = m_serialize.script();
+	AllocationTrace allocation_trace(L, 1);
+	lua::UserdataPool pool(L);
 	int stack_top = lua_gettop(L);
 	m_serialize.get();
 	lua::pushColorObject(L, const_cast<ColorObject*>(color_object));
@@ -79,11 +116,133 @@ std::string Converter::serialize(const ColorObject *color_object, const Converte
 	lua_settop(L, stack_top);
 	return "";
 }
+namespace {
+struct SerializeEachArgs
+{
+	const ColorObject *const *color_objects;
+	size_t count;
+	size_t index, total_count;
+	std::vector<std::string> *result;
+	const std::string *name;
+	lua::UserdataPool *pool;
+};
+}
+/** Calls serialize function (argument 2) for each color object. Called through lua_pcall, so that errors in any color object abort whole chunk, which is then serialized one color object at a time. */
+static int serializeEach(lua_State *L)
+{
+	auto &args = *reinterpret_cast<SerializeEachArgs*>(lua_touserdata(L, 1));
+	//position table is reused for all color objects
+	lua_newtable(L);
+	int position_table = lua_gettop(L);
+	for (size_t i = 0; i < args.count; i++){
+		size_t index = args.index + i;
+		lua_pushvalue(L, 2);
+		lua::pushColorObject(L, const_cast<ColorObject*>(args.color_objects[i]));
+		lua_pushboolean(L, index == 0);
+		lua_setfield(L, position_table, "first");
+		lua_pushboolean(L, index + 1 >= args.total_count);
+		lua_setfield(L, position_table, "last");
+		lua_pushinteger(L, index);
+		lua_setfield(L, position_table, "index");
+		lua_pushinteger(L, args.total_count);
+		lua_setfield(L, position_table, "count");
+		lua_pushvalue(L, position_table);
+		lua_call(L, 2, 1);
+		if (lua_type(L, -1) == LUA_TSTRING){
+			size_t length;
+			const char *text = lua_tolstring(L, -1, &length);
+			args.result->emplace_back(text, length);
+		}else{
+			cerr << "serialize: returned not a string value \"" << *args.name << "\"" << endl;
+			args.result->emplace_back();
+		}
+		lua_pop(L, 1);
+		args.pool->release();
+	}
+	return 0;
+}
+void Converter::serialize(const ColorObject *const *color_objects, size_t count, const ConverterSerializePosition &position, std::vector<std::string> &result)
+{
+	TRACE_SCOPE("Converter::serializeMany");
+	result.reserve(result.size() + count);
+	if (!m_serialize_many.valid() && !m_serialize.valid()){
+		result.resize(result.size() + count);
+		return;
+	}
+	lua_State *L = m_serialize_many.valid() ? m_serialize_many.script() : m_serialize.script();
+	AllocationTrace allocation_trace(L, count);
+	lua::UserdataPool pool(L);
+	for (size_t offset = 0; offset < count; offset += serialize_chunk_size){
+		size_t chunk_size = std::min(serialize_chunk_size, count - offset);
+		size_t result_size = result.size();
+		int stack_top = lua_gettop(L);
+		int status;
+		if (m_serialize_many.valid()){
+			m_serialize_many.get();
+			lua_createtable(L, chunk_size, 0);
+			for (size_t i = 0; i < chunk_size; i++){
+				lua::pushColorObject(L, const_cast<ColorObject*>(color_objects[offset + i]));
+				lua_rawseti(L, -2, i + 1);
+			}
+			lua_createtable(L, 0, 2);
+			lua_pushinteger(L, position.index() + offset);
+			lua_setfield(L, -2, "index");
+			lua_pushinteger(L, position.count());
+			lua_setfield(L, -2, "count");
+			status = lua_pcall(L, 2, 1, 0);
+			if (status == 0){
+				if (lua_type(L, -1) == LUA_TTABLE){
+					for (size_t i = 0; i < chunk_size; i++){
+						lua_rawgeti(L, -1, i + 1);
+						if (lua_type(L, -1) == LUA_TSTRING){
+							size_t length;
+							const char *text = lua_tolstring(L, -1, &length);
+							result.emplace_back(text, length);
+						}else{
+							result.emplace_back();
+						}
+						lua_pop(L, 1);
+					}
+				}else{
+					cerr << "serializeMany: returned not a table value \"" << m_name << "\"" << endl;
+					//not a Lua error, but results of whole chunk are missing
+					status = -1;
+				}
+			}
+		}else{
+			SerializeEachArgs args{color_objects + offset, chunk_size, position.index() + offset, position.count(), &result, &m_name, &pool};
+			lua_pushcfunction(L, serializeEach);
+			lua_pushlightuserdata(L, &args);
+			m_serialize.get();
+			status = lua_pcall(L, 2, 0, 0);
+		}
+		if (status != 0){
+			if (status != -1)
+				cerr << "serialize: " << lua_tostring(L, -1) << endl;
+			lua_settop(L, stack_top);
+			pool.release();
+			//failing color object is not known, so chunk is serialized again one color object at a time and only failing color objects are left empty
+			result.resize(result_size);
+			for (size_t i = 0; i < chunk_size; i++){
+				if (m_serialize.valid())
+					result.push_back(serialize(color_objects[offset + i], ConverterSerializePosition(position.index() + offset + i, position.count())));
+				else
+					result.emplace_back();
+			}
+			continue;
+		}
+		result.resize(result_size + chunk_size);
+		lua_settop(L, stack_top);
+		pool.release();
+	}
+}
 bool Converter::deserialize(const char *value, ColorObject *color_object, float &quality)
 {
+	TRACE_SCOPE("Converter::deserialize");
 	if (!m_deserialize.valid())
 		return "";
 	lua_State *L = m_deserialize.script();
+	lua::UserdataPool pool(L);
 	int stack_top = lua_gettop(L);
 	m_deserialize.get();
 	lua_pushstring(L, value);
@@ -130,6 +289,10 @@ bool Converter::hasDeserialize() const
 {
 	return m_deserialize.valid();
 }
+bool Converter::hasSerializeMany() const
+{
+	return m_serialize_many.valid();
+}
 void Converter::copy(bool value)
 {
 	m_copy = value;
@@ -161,6 +324,13 @@ ConverterSerializePosition::ConverterSerializePosition(size_t count):
 	m_count(count)
 {
 }
+ConverterSerializePosition::ConverterSerializePosition(size_t index, size_t count):
+	m_first(index == 0),
+	m_last(index + 1 >= count),
+	m_index(index),
+	m_count(count)
+{
+}
 bool ConverterSerializePosition::first() const
 {
 	return m_first;
@@ -19,6 +19,8 @@
 #ifndef GPICK_CONVERTER_H_
 #define GPICK_CONVERTER_H_
 #include <string>
+#include <vector>
+#include <cstddef>
 #include "lua/Ref.h"
 struct ColorObject;
 struct Color;
@@ -26,6 +28,8 @@ struct ConverterSerializePosition
 {
 	ConverterSerializePosition();
 	ConverterSerializePosition(size_t count);
+	/** Position of color object at index in a sequence of count color objects. */
+	ConverterSerializePosition(size_t index, size_t count);
 	bool first() const;
 	bool last() const;
 	size_t index() const;
@@ -39,11 +43,12 @@ struct ConverterSerializePosition
 };
 struct Converter
 {
-	Converter(const char *name, const char *label, lua::Ref &&serialize, lua::Ref &&deserialize);
+	Converter(const char *name, const char *label, lua::Ref &&serialize, lua::Ref &&deserialize, lua::Ref &&serialize_many);
 	const std::string &name() const;
 	const std::string &label() const;
 	bool hasSerialize() const;
 	bool hasDeserialize() const;
+	bool hasSerializeMany() const;
 	bool copy() const;
 	bool paste() const;
 	void copy(bool value);
@@ -51,11 +56,21 @@ struct Converter
 	std::string serialize(const ColorObject *color_object, const ConverterSerializePosition &position);
 	std::string serialize(const ColorObject *color_object);
 	std::string serialize(const Color &color);
+	/**
+	 * Serialize multiple color objects with one Lua call for each chunk of color objects.
+	 * Converter serializeMany function receives an array of color objects and a position table with index of the first color object and total color object count, and must return an array of strings.
+	 * If converter has no serializeMany function, serialize function is called for each color object from within a single protected call.
+	 * @param[in] color_objects Color objects.
+	 * @param[in] count Number of color objects.
+	 * @param[in] position Position of the first color object. Following color objects have consecutive indexes.
+	 * @param[out] result One string is appended for each color object. Empty string is appended when serialization fails.
+	 */
+	void serialize(const ColorObject *const *color_objects, size_t count, const ConverterSerializePosition &position, std::vector<std::string> &result);
 	bool deserialize(const char *value, ColorObject *color_object, float &quality);
 	private:
 	std::string m_name;
 	std::string m_label;
-	lua::Ref m_serialize, m_deserialize;
+	lua::Ref m_serialize, m_deserialize, m_serialize_many;
 	bool m_copy, m_paste;
 };
 #endif /* GPICK_CONVERTER_H_ */
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ConverterWorkers.h"
+#include "GlobalState.h"
+#include "Converters.h"
+#include "Converter.h"
+#include "ColorObject.h"
+#include "Tracing.h"
+#include "lua/Script.h"
+#include "lua/Callbacks.h"
+#include "lua/DynvSystem.h"
+#include "dynv/DynvSystem.h"
+extern "C"{
+#include <lualib.h>
+#include <lauxlib.h>
+}
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <iostream>
+using namespace std;
+
+/** Batches smaller than this are not split, as thread wake up and Lua call overhead would outweigh the gain. */
+static const size_t min_serialize_range = 4096;
+static const size_t min_deserialize_range = 512;
+struct ConverterWorkers::Impl
+{
+	struct Worker
+	{
+		//converters and callbacks hold references into script, so script is destroyed last
+		lua::Script script;
+		Converters converters;
+		lua::Callbacks callbacks;
+		thread worker_thread;
+	};
+	GlobalState &m_global_state;
+	size_t m_worker_count;
+	vector<unique_ptr<Worker>> m_workers;
+	mutex m_mutex;
+	condition_variable m_job_started, m_job_finished;
+	function<void(Converters &, size_t)> m_job;
+	size_t m_job_id, m_job_ranges, m_running;
+	bool m_stop;
+	Impl(GlobalState &global_state, size_t worker_count):
+		m_global_state(global_state),
+		m_worker_count(worker_count),
+		m_job_id(0),
+		m_job_ranges(0),
+		m_running(0),
+		m_stop(false)
+	{
+		if (m_worker_count == 0)
+			m_worker_count = min(max(thread::hardware_concurrency(), 2u) - 1, 7u);
+	}
+	~Impl()
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_job_started.notify_all();
+		for (auto &worker: m_workers)
+			worker->worker_thread.join();
+	}
+	/** Worker thread body. Waits for jobs and runs given range of each job which has enough ranges. */
+	void work(Worker &worker, size_t range, size_t job_id)
+	{
+		unique_lock<mutex> lock(m_mutex);
+		for (;;){
+			m_job_started.wait(lock, [&]{
+				return m_stop || m_job_id != job_id;
+			});
+			if (m_stop)
+				return;
+			job_id = m_job_id;
+			if (range >= m_job_ranges)
+				continue;
+			lock.unlock();
+			m_job(worker.converters, range);
+			lock.lock();
+			if (--m_running == 0)
+				m_job_finished.notify_one();
+		}
+	}
+	bool updateOptions(Worker &worker, dynvSystem *settings)
+	{
+		if (settings == nullptr || !worker.callbacks.optionChange().valid())
+			return false;
+		lua_State *L = worker.script;
+		int stack_top = lua_gettop(L);
+		worker.callbacks.optionChange().get();
+		lua::pushDynvSystem(L, settings);
+		int status = lua_pcall(L, 1, 0, 0);
+		dynv_system_release(settings);
+		if (status != 0)
+			cerr << "optionsUpdate: " << lua_tostring(L, -1) << endl;
+		lua_settop(L, stack_top);
+		return status == 0;
+	}
+	/** Create worker states until there are enough for given number of ranges. Returns number of ranges which can be used. */
+	size_t prepare(size_t ranges)
+	{
+		ranges = min(ranges, m_worker_count + 1);
+		while (m_workers.size() + 1 < ranges){
+			TRACE_SCOPE("converter_workers.create");
+			auto worker = make_unique<Worker>();
+			if (!m_global_state.initializeWorkerScript(worker->script, worker->converters, worker->callbacks)){
+				//do not try again, scripts which fail to load in worker state would fail every time
+				m_worker_count = m_workers.size();
+				break;
+			}
+			updateOptions(*worker, m_global_state.getSettings());
+			//worker thread lives as long as worker state, so batches do not pay for thread creation
+			worker->worker_thread = thread(&Impl::work, this, ref(*worker), m_workers.size() + 1, m_job_id);
+			m_workers.push_back(move(worker));
+		}
+		return min(ranges, m_workers.size() + 1);
+	}
+	/** Split count items into contiguous ranges and call job(converters, range, begin, end) for each of them. Range 0 uses main state converters on calling thread. */
+	template<typename Job>
+	void run(size_t count, size_t min_range, Job job)
+	{
+		size_t ranges = prepare(max<size_t>(count / min_range, 1));
+		function<void(Converters &, size_t)> range_job = [&job, count, ranges](Converters &converters, size_t range){
+			job(converters, range, count * range / ranges, count * (range + 1) / ranges);
+		};
+		if (ranges > 1){
+			{
+				lock_guard<mutex> lock(m_mutex);
+				m_job = range_job;
+				m_job_ranges = ranges;
+				m_running = ranges - 1;
+				m_job_id++;
+			}
+			m_job_started.notify_all();
+		}
+		range_job(m_global_state.converters(), 0);
+		if (ranges > 1){
+			unique_lock<mutex> lock(m_mutex);
+			m_job_finished.wait(lock, [this]{
+				return m_running == 0;
+			});
+			m_job = nullptr;
+		}
+		tracing::count("converter_workers.batches");
+		tracing::sample("converter_workers.ranges", ranges);
+	}
+	/** Worker states run the same scripts, but user scripts can register converters conditionally. */
+	bool allWorkersHave(const vector<string> &names)
+	{
+		for (auto &worker: m_workers){
+			for (auto &name: names){
+				if (worker->converters.byName(name.c_str()) == nullptr)
+					return false;
+			}
+		}
+		return true;
+	}
+	void serialize(Converter &converter, const ColorObject *const *color_objects, size_t count, const ConverterSerializePosition &position, vector<string> &result)
+	{
+		if (prepare(count / min_serialize_range) < 2 || !allWorkersHave({converter.name()})){
+			converter.serialize(color_objects, count, position, result);
+			return;
+		}
+		vector<vector<string>> range_results(m_workers.size() + 1);
+		run(count, min_serialize_range, [&](Converters &converters, size_t range, size_t begin, size_t end){
+			Converter *range_converter = range == 0 ? &converter : converters.byName(converter.name().c_str());
+			range_converter->serialize(color_objects + begin, end - begin, ConverterSerializePosition(position.index() + begin, position.count()), range_results[range]);
+		});
+		for (auto &range_result: range_results){
+			for (auto &text: range_result)
+				result.push_back(move(text));
+		}
+	}
+	void deserialize(const vector<Converter*> &converters, const vector<string> &texts, vector<Deserialized> &result)
+	{
+		result.resize(texts.size());
+		vector<string> names;
+		for (auto converter: converters){
+			if (converter->hasDeserialize())
+				names.push_back(converter->name());
+		}
+		//without all converters in every worker, results would depend on how lines are split, so main state does all the work
+		size_t min_range = min_deserialize_range;
+		if (prepare(texts.size() / min_range) >= 2 && !allWorkersHave(names))
+			min_range = numeric_limits<size_t>::max();
+		run(texts.size(), min_range, [&](Converters &worker_converters, size_t, size_t begin, size_t end){
+			vector<Converter*> range_converters;
+			for (auto &name: names){
+				Converter *converter = worker_converters.byName(name.c_str());
+				if (converter != nullptr && converter->hasDeserialize())
+					range_converters.push_back(converter);
+			}
+			for (size_t i = begin; i < end; i++){
+				Deserialized &deserialized = result[i];
+				deserialized.quality = 0;
+				for (auto converter: range_converters){
+					ColorObject color_object;
+					float quality;
+					//first converter wins when qualities are equal
+					if (converter->deserialize(texts[i].c_str(), &color_object, quality) && quality > deserialized.quality){
+						deserialized.color = color_object.getColor();
+						deserialized.name = color_object.getName();
+						deserialized.quality = quality;
+					}
+				}
+			}
+		});
+	}
+};
+ConverterWorkers::ConverterWorkers(GlobalState &global_state, size_t worker_count):
+	m_impl(make_unique<Impl>(global_state, worker_count))
+{
+}
+ConverterWorkers::~ConverterWorkers()
+{
+}
+void ConverterWorkers::serialize(Converter &converter, const ColorObject *const *color_objects, size_t count, const ConverterSerializePosition &position, std::vector<std::string> &result)
+{
+	m_impl->serialize(converter, color_objects, count, position, result);
+}
+void ConverterWorkers::deserialize(const std::vector<Converter*> &converters, const std::vector<std::string> &texts, std::vector<Deserialized> &result)
+{
+	m_impl->deserialize(converters, texts, result);
+}
+void ConverterWorkers::updateOptions(dynvSystem *settings)
+{
+	for (auto &worker: m_impl->m_workers)
+		m_impl->updateOptions(*worker, settings);
+}
+size_t ConverterWorkers::workerCount() const
+{
+	return m_impl->m_workers.size();
+}
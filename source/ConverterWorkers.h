@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_CONVERTER_WORKERS_H_
+#define GPICK_CONVERTER_WORKERS_H_
+#include "Color.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstddef>
+struct GlobalState;
+struct Converter;
+struct ConverterSerializePosition;
+struct ColorObject;
+struct dynvSystem;
+/** \struct ConverterWorkers
+ * \brief Worker Lua states which convert large batches of colors in parallel.
+ *
+ * Every worker has its own Lua state, loaded with the same scripts as the main state, its own converters and callbacks, and its own thread, which waits for ranges of the following batches until workers are destroyed.
+ * Batch is split into contiguous ranges. The first range is converted by the main state on the calling thread and the other ranges by worker threads, so results are always in input order.
+ * Worker states are created when the first batch large enough to be split is converted. Worker options are kept in sync by updateOptions().
+ * Functions must not be called concurrently, same as any other use of the main Lua state.
+ */
+struct ConverterWorkers
+{
+	/** \struct Deserialized
+	 * \brief Color deserialized by the paste converter with the highest quality.
+	 */
+	struct Deserialized
+	{
+		Color color;
+		std::string name;
+		float quality; /**< Zero when no converter recognized the text */
+	};
+	/**
+	 * Create workers.
+	 * @param[in] global_state Global state with loaded main Lua state.
+	 * @param[in] worker_count Maximum number of worker states. Zero selects count by hardware concurrency.
+	 */
+	ConverterWorkers(GlobalState &global_state, size_t worker_count = 0);
+	~ConverterWorkers();
+	/**
+	 * Serialize color objects, same as Converter::serialize(), splitting large batches between workers.
+	 * @param[in] converter Converter from global state converters.
+	 * @param[in] color_objects Color objects. They must not be modified until the call returns.
+	 * @param[in] count Number of color objects.
+	 * @param[in] position Position of the first color object in the whole output.
+	 * @param[out] result Serialized text is appended, one string for each color object.
+	 */
+	void serialize(Converter &converter, const ColorObject *const *color_objects, size_t count, const ConverterSerializePosition &position, std::vector<std::string> &result);
+	/**
+	 * Deserialize texts with given converters, splitting large batches between workers.
+	 * @param[in] converters Converters from global state converters. Converters without deserialize function are skipped.
+	 * @param[in] texts Texts to deserialize.
+	 * @param[out] result One entry for each text.
+	 */
+	void deserialize(const std::vector<Converter*> &converters, const std::vector<std::string> &texts, std::vector<Deserialized> &result);
+	/** Call option change callback of every created worker. Must be called whenever the main state option change callback is called. */
+	void updateOptions(dynvSystem *settings);
+	/** Number of worker states created so far. */
+	size_t workerCount() const;
+	private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+#endif /* GPICK_CONVERTER_WORKERS_H_ */
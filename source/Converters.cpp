@@ -22,7 +22,8 @@
 #include <map>
 #include <set>
 using namespace std;
-Converters::Converters()
+Converters::Converters():
+	m_revision(0)
 {
 }
 Converters::~Converters()
@@ -63,6 +64,14 @@ bool Converters::hasCopy() const
 {
 	return m_copy_converters.size() != 0;
 }
+void Converters::invalidate()
+{
+	m_revision++;
+}
+uint32_t Converters::revision() const
+{
+	return m_revision;
+}
 const std::vector<Converter*> &Converters::allPaste() const
 {
 	return m_paste_converters;
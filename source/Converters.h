@@ -20,6 +20,8 @@
 #define GPICK_CONVERTERS_H_
 #include <map>
 #include <vector>
+#include <cstdint>
+#include <string>
 struct ColorObject;
 struct Converter;
 struct Color;
@@ -53,6 +55,10 @@ struct Converters
 	void rebuildCopyPasteArrays();
 	void reorder(const char **names, size_t count);
 	bool hasCopy() const;
+	/** Mark previously serialized text as outdated, because converter options have changed. */
+	void invalidate();
+	/** Incremented by invalidate(). Serialized text caches compare it to detect outdated text. */
+	uint32_t revision() const;
 	private:
 	std::map<std::string, Converter*> m_converters;
 	std::vector<Converter*> m_all_converters;
@@ -60,5 +66,6 @@ struct Converters
 	std::vector<Converter*> m_paste_converters;
 	Converter *m_display_converter;
 	Converter *m_color_list_converter;
+	uint32_t m_revision;
 };
 #endif /* GPICK_CONVERTERS_H_ */
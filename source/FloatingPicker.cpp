@@ -73,7 +73,7 @@ struct PickerColorNameAssigner: public ToolColorNameAssigner
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color)
 		{
 			m_stream.str("");
-			m_stream << color_names_get(m_gs->getColorNames(), color, false);
+			m_stream << getColorName(color);
 			return m_stream.str();
 		}
 };
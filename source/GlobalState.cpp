@@ -23,6 +23,7 @@
 #include "Converter.h"
 #include "Random.h"
 #include "color_names/ColorNames.h"
+#include "ColorDistance.h"
 #include "Sampler.h"
 #include "ColorList.h"
 #include "layout/Layout.h"
@@ -42,6 +43,11 @@
 #include "lua/Script.h"
 #include "lua/Extensions.h"
 #include "lua/Callbacks.h"
+#include "lua/BytecodeCache.h"
+#include "Tracing.h"
+#include "TaskExecutor.h"
+#include "ConverterWorkers.h"
+#include "ToolColorNaming.h"
 #include <stdlib.h>
 #include <glib/gstdio.h>
 extern "C"{
@@ -50,6 +56,8 @@ extern "C"{
 }
 #include <fstream>
 #include <iostream>
+#include <vector>
+#include <future>
 using namespace std;
 
 struct GlobalState::Impl
@@ -68,6 +76,15 @@ struct GlobalState::Impl
 	transformation::Chain *m_transformation_chain;
 	GtkWidget *m_status_bar;
 	ColorSource *m_color_source;
+	tracing::Tracer m_tracer;
+	string m_trace_filename;
+	unique_ptr<TaskExecutor> m_task_executor;
+	unique_ptr<ConverterWorkers> m_converter_workers;
+	ToolColorNameCache m_tool_color_name_cache;
+	shared_future<void> m_color_names_loaded;
+	bool m_lua_initialized;
+	bool m_layouts_loaded;
+	vector<StartupStep> m_startup_steps;
 	Impl(GlobalState *decl):
 		m_decl(decl),
 		m_color_names(nullptr),
@@ -78,11 +95,17 @@ struct GlobalState::Impl
 		m_random(nullptr),
 		m_transformation_chain(nullptr),
 		m_status_bar(nullptr),
-		m_color_source(nullptr)
+		m_color_source(nullptr),
+		m_lua_initialized(false),
+		m_layouts_loaded(false)
 	{
 	}
 	~Impl()
 	{
+		m_task_executor.reset();
+		m_converter_workers.reset();
+		waitForColorNames();
+		stopTracing();
 		if (m_transformation_chain != nullptr)
 			delete m_transformation_chain;
 		if (m_color_list != nullptr)
@@ -100,18 +123,29 @@ struct GlobalState::Impl
 	}
 	bool writeSettings()
 	{
+		//settings are written into a temporary file first and then renamed over the old file, so that
+		//an interrupted write never leaves a truncated settings file behind
 		gchar* config_file = build_config_path("settings.xml");
-		ofstream settings_file(config_file);
+		gchar* temporary_file = build_config_path("settings.xml.tmp");
+		vector<char> buffer(65536);
+		ofstream settings_file;
+		settings_file.rdbuf()->pubsetbuf(&buffer.front(), buffer.size());
+		settings_file.open(temporary_file, ios::out | ios::trunc);
 		if (!settings_file.is_open()){
+			g_free(temporary_file);
 			g_free(config_file);
 			return false;
 		}
-		settings_file << "<?xml version=\"1.0\" encoding='UTF-8'?><root>" << endl;
+		settings_file << "<?xml version=\"1.0\" encoding='UTF-8'?><root>\n";
 		dynv_xml_serialize(m_settings, settings_file);
-		settings_file << "</root>" << endl;
+		settings_file << "</root>\n";
 		settings_file.close();
+		bool result = settings_file.good() && g_rename(temporary_file, config_file) == 0;
+		if (!result)
+			g_unlink(temporary_file);
+		g_free(temporary_file);
 		g_free(config_file);
-		return true;
+		return result;
 	}
 	bool loadSettings()
 	{
@@ -127,7 +161,10 @@ struct GlobalState::Impl
 		m_settings = dynv_system_create(handler_map);
 		dynv_handler_map_release(handler_map);
 		gchar* config_file = build_config_path("settings.xml");
-		ifstream settings_file(config_file);
+		vector<char> buffer(65536);
+		ifstream settings_file;
+		settings_file.rdbuf()->pubsetbuf(&buffer.front(), buffer.size());
+		settings_file.open(config_file, ios::in | ios::binary);
 		if (!settings_file.is_open()){
 			g_free(config_file);
 			return false;
@@ -175,11 +212,43 @@ struct GlobalState::Impl
 	{
 		if (m_color_names != nullptr) return false;
 		m_color_names = color_names_new();
+		//dictionary file names are read from settings here, so that the loader thread does not access settings
 		dynvSystem *params = dynv_get_dynv(m_settings, "gpick");
-		color_names_load(m_color_names, params);
+		vector<string> filenames;
+		color_names_get_dictionary_filenames(params, filenames);
+		color_names_set_distance(m_color_names, color_distance_get_metric(dynv_get_string_wd(params, "color_names.distance", "cie94"), color_distance_cie94_metric));
 		dynv_system_release(params);
+		ColorNames *color_names = m_color_names;
+		m_color_names_loaded = async(launch::async, [color_names, filenames]{
+			TRACE_SCOPE("startup.color_names");
+			for (auto &filename: filenames)
+				color_names_load_from_file(color_names, filename.c_str());
+		}).share();
 		return true;
 	}
+	void waitForColorNames()
+	{
+		if (!m_color_names_loaded.valid()) return;
+		if (m_color_names_loaded.wait_for(chrono::seconds(0)) == future_status::ready) return;
+		int64_t start = tracing::Tracer::now();
+		m_color_names_loaded.wait();
+		tracing::sample("startup.color_names_wait", tracing::Tracer::now() - start);
+	}
+	bool loadLayouts()
+	{
+		//layout registration calls GlobalState::layouts(), so the flag is set before loading
+		if (m_layouts_loaded || !m_lua_initialized) return false;
+		m_layouts_loaded = true;
+		TRACE_SCOPE("startup.layouts");
+		lua_State *L = m_script;
+		int top = lua_gettop(L);
+		bool result = m_script.load("layouts");
+		if (!result){
+			cerr << m_script.getLastError() << endl;
+		}
+		lua_settop(L, top);
+		return result;
+	}
 	bool initializeRandomGenerator()
 	{
 		m_random = random_new("SHR3");
@@ -202,20 +271,47 @@ struct GlobalState::Impl
 		g_free(value);
 		return result;
 	}
-	bool initializeLua()
+	bool enableBytecodeCache(lua::Script &script)
+	{
+		if (!lua::bytecodeCacheEnabled())
+			return false;
+		gchar *cache_path = build_cache_path("lua");
+		bool result = g_mkdir_with_parents(cache_path, 0700) == 0;
+		if (result)
+			lua::installBytecodeCache(script, cache_path);
+		g_free(cache_path);
+		return result;
+	}
+	void setupScript(lua::Script &script)
 	{
-		lua_State *L = m_script;
-		lua::registerAll(L, *m_decl);
 		vector<string> paths;
 		paths.push_back(gcharToString(build_filename("")));
 		paths.push_back(gcharToString(build_config_path("")));
-		m_script.setPaths(paths);
+		script.setPaths(paths);
+		enableBytecodeCache(script);
+	}
+	bool initializeLua()
+	{
+		lua_State *L = m_script;
+		lua::registerAll(L, *m_decl);
+		setupScript(m_script);
 		bool result = m_script.load("init");
 		if (!result){
 			cerr << m_script.getLastError() << endl;
 		}
+		m_lua_initialized = true;
 		return result;
 	}
+	bool initializeWorkerScript(lua::Script &script, Converters &converters, lua::Callbacks &callbacks)
+	{
+		lua::registerWorker(script, *m_decl, converters, callbacks);
+		setupScript(script);
+		if (!script.load("init")){
+			cerr << script.getLastError() << endl;
+			return false;
+		}
+		return true;
+	}
 	bool loadConverters()
 	{
 		char** source_array;
@@ -301,19 +397,79 @@ struct GlobalState::Impl
 		m_transformation_chain = chain;
 		return true;
 	}
+	bool startTracing()
+	{
+		//tracing is enabled by GPICK_TRACE environment variable, which contains trace file name, or by gpick.debug.tracing setting
+		const char *trace_filename = g_getenv("GPICK_TRACE");
+		if (trace_filename != nullptr && *trace_filename != 0){
+			m_trace_filename = trace_filename;
+		}else if (m_settings != nullptr && dynv_get_bool_wd(m_settings, "gpick.debug.tracing", false)){
+			trace_filename = dynv_get_string_wd(m_settings, "gpick.debug.trace_file", "");
+			if (*trace_filename != 0)
+				m_trace_filename = trace_filename;
+			else
+				m_trace_filename = gcharToString(build_config_path("trace.json"));
+		}else{
+			return false;
+		}
+		m_tracer.start();
+		return true;
+	}
+	bool stopTracing()
+	{
+		if (!m_tracer.started()) return false;
+		m_tracer.stop();
+		if (!m_tracer.write(m_trace_filename.c_str())){
+			cerr << "failed to write trace file \"" << m_trace_filename << "\"" << endl;
+			return false;
+		}
+		return true;
+	}
+	template<typename Step>
+	bool timeStartupStep(const char *name, Step step)
+	{
+		int64_t start = tracing::Tracer::now();
+		bool result = step();
+		m_startup_steps.push_back(StartupStep{name, start, tracing::Tracer::now() - start});
+		return result;
+	}
+	void reportStartupSteps()
+	{
+		//tracer is started in the middle of loadAll(), so steps are recorded after all of them are done
+		if (m_tracer.started()){
+			for (auto &step: m_startup_steps)
+				m_tracer.complete(step.name, step.start, step.duration);
+		}
+		const char *startup_times = g_getenv("GPICK_STARTUP_TIMES");
+		if (startup_times == nullptr || *startup_times == 0)
+			return;
+		int64_t total = 0;
+		for (auto &step: m_startup_steps){
+			cerr << step.name << ": " << step.duration / 1000.0 << " ms" << endl;
+			total += step.duration;
+		}
+		cerr << "startup.total: " << total / 1000.0 << " ms" << endl;
+	}
 	bool loadAll()
 	{
-		checkConfigurationDirectory();
-		checkUserInitFile();
-		m_screen_reader = screen_reader_new();
-		m_sampler = sampler_new(m_screen_reader);
-		initializeRandomGenerator();
-		loadSettings();
-		loadColorNames();
-		createColorList();
-		initializeLua();
-		loadConverters();
-		loadTransformationChain();
+		m_startup_steps.clear();
+		timeStartupStep("startup.configuration_directory", [this]{
+			checkConfigurationDirectory();
+			return checkUserInitFile();
+		});
+		timeStartupStep("startup.screen_reader", [this]{
+			m_screen_reader = screen_reader_new();
+			m_sampler = sampler_new(m_screen_reader);
+			return initializeRandomGenerator();
+		});
+		timeStartupStep("startup.settings", [this]{ return loadSettings(); });
+		startTracing();
+		timeStartupStep("startup.color_names_start", [this]{ return loadColorNames(); });
+		timeStartupStep("startup.color_list", [this]{ return createColorList(); });
+		timeStartupStep("startup.lua", [this]{ return initializeLua(); });
+		timeStartupStep("startup.converters", [this]{ return loadConverters(); });
+		timeStartupStep("startup.transformations", [this]{ return loadTransformationChain(); });
+		reportStartupSteps();
 		return true;
 	}
 };
@@ -339,6 +495,7 @@ bool GlobalState::writeSettings()
 }
 ColorNames *GlobalState::getColorNames()
 {
+	m_impl->waitForColorNames();
 	return m_impl->m_color_names;
 }
 Sampler *GlobalState::getSampler()
@@ -375,8 +532,37 @@ Converters &GlobalState::converters()
 }
 layout::Layouts &GlobalState::layouts()
 {
+	m_impl->loadLayouts();
 	return m_impl->m_layouts;
 }
+TaskExecutor &GlobalState::taskExecutor()
+{
+	if (!m_impl->m_task_executor)
+		m_impl->m_task_executor = make_unique<TaskExecutor>();
+	return *m_impl->m_task_executor;
+}
+ConverterWorkers &GlobalState::converterWorkers()
+{
+	if (!m_impl->m_converter_workers)
+		m_impl->m_converter_workers = make_unique<ConverterWorkers>(*this);
+	return *m_impl->m_converter_workers;
+}
+bool GlobalState::initializeWorkerScript(lua::Script &script, Converters &converters, lua::Callbacks &callbacks)
+{
+	return m_impl->initializeWorkerScript(script, converters, callbacks);
+}
+tracing::Tracer &GlobalState::tracer()
+{
+	return m_impl->m_tracer;
+}
+ToolColorNameCache &GlobalState::toolColorNameCache()
+{
+	return m_impl->m_tool_color_name_cache;
+}
+const std::vector<GlobalState::StartupStep> &GlobalState::startupSteps() const
+{
+	return m_impl->m_startup_steps;
+}
 transformation::Chain *GlobalState::getTransformationChain()
 {
 	return m_impl->m_transformation_chain;
@@ -20,6 +20,8 @@
 #define GPICK_GLOBAL_STATE_H_
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 struct ColorNames;
 struct Sampler;
 struct ScreenReader;
@@ -28,6 +30,9 @@ struct dynvSystem;
 struct Random;
 struct Converters;
 struct ColorSource;
+struct TaskExecutor;
+struct ConverterWorkers;
+struct ToolColorNameCache;
 typedef struct _GtkWidget GtkWidget;
 namespace layout {
 	struct Layouts;
@@ -39,13 +44,27 @@ namespace lua {
 	struct Script;
 	struct Callbacks;
 }
+namespace tracing {
+	struct Tracer;
+}
 struct GlobalState
 {
+	/** \struct StartupStep
+	 * \brief Time taken by one loadAll() step.
+	 */
+	struct StartupStep
+	{
+		const char *name;
+		int64_t start; /**< Monotonic time in microseconds */
+		int64_t duration; /**< Duration in microseconds */
+	};
 	GlobalState();
 	~GlobalState();
 	bool loadSettings();
+	/** Load settings, scripts and converters. Color dictionaries are loaded in a background thread and layouts are loaded on first use. */
 	bool loadAll();
 	bool writeSettings();
+	/** Get color dictionary. Waits for background color dictionary loading to finish. */
 	ColorNames *getColorNames();
 	Sampler *getSampler();
 	ScreenReader *getScreenReader();
@@ -55,8 +74,21 @@ struct GlobalState
 	lua::Callbacks &callbacks();
 	Converters &converters();
 	Random *getRandom();
+	/** Get layouts. Layout scripts are loaded on first call. */
 	layout::Layouts &layouts();
 	transformation::Chain *getTransformationChain();
+	/** Background task executor shared by tools which compute previews off the main loop. Worker threads are not started until first task is submitted. */
+	TaskExecutor &taskExecutor();
+	/** Worker Lua states for converting large batches in parallel. Worker states are not created until first large batch is converted. */
+	ConverterWorkers &converterWorkers();
+	/** Load scripts into a worker Lua state. Converters and callbacks registered by scripts are added into given objects. */
+	bool initializeWorkerScript(lua::Script &script, Converters &converters, lua::Callbacks &callbacks);
+	/** Instrumentation data collector. Started during loadAll() if GPICK_TRACE environment variable or gpick.debug.tracing setting is set, trace is written when global state is destroyed. */
+	tracing::Tracer &tracer();
+	/** Color name lookups memoized for tools generating named colors. */
+	ToolColorNameCache &toolColorNameCache();
+	/** Startup timing breakdown recorded by loadAll(). Printed to standard error when GPICK_STARTUP_TIMES environment variable is set. */
+	const std::vector<StartupStep> &startupSteps() const;
 	GtkWidget *getStatusBar();
 	void setStatusBar(GtkWidget *status_bar);
 	ColorSource *getCurrentColorSource();
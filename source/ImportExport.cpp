@@ -27,6 +27,7 @@
 #include "StringUtils.h"
 #include "HtmlUtils.h"
 #include "GlobalState.h"
+#include "ConverterWorkers.h"
 #include "DynvHelpers.h"
 #include "version/Version.h"
 #include "parser/TextFile.h"
@@ -34,11 +35,16 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include <boost/math/special_functions/round.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 using namespace std;
 
+/** Number of colors serialized at once by text exporters, limits memory used for serialized text. */
+static const size_t export_chunk_size = 16384;
 static bool getOrderedColors(ColorList *color_list, vector<ColorObject*> &ordered)
 {
 	color_list_get_positions(color_list);
@@ -75,6 +81,7 @@ ImportExport::ImportExport(ColorList *color_list, const char* filename, GlobalSt
 	m_background(Background::none),
 	m_gs(gs),
 	m_include_color_names(true),
+	m_parser_thread_count(0),
 	m_last_error(Error::none)
 {
 }
@@ -154,6 +161,10 @@ void ImportExport::setIncludeColorNames(bool include_color_names)
 {
 	m_include_color_names = include_color_names;
 }
+void ImportExport::setParserThreadCount(size_t parser_thread_count)
+{
+	m_parser_thread_count = parser_thread_count;
+}
 static void gplColor(ColorObject* color_object, ostream &stream)
 {
 	using boost::math::iround;
@@ -255,16 +266,13 @@ bool ImportExport::exportTXT()
 	}
 	vector<ColorObject*> ordered;
 	getOrderedColors(m_color_list, ordered);
-	ConverterSerializePosition position(ordered.size());
-	for (auto color: ordered){
-		string line = m_converter->serialize(color, position);
-		f << line << endl;
-		position.incrementIndex();
-		if (position.index() + 1 == position.count()){
-			position.last(true);
-		}
-		if (position.first())
-			position.first(false);
+	vector<string> lines;
+	for (size_t offset = 0; offset < ordered.size(); offset += export_chunk_size){
+		size_t count = min(export_chunk_size, ordered.size() - offset);
+		lines.clear();
+		m_gs->converterWorkers().serialize(*m_converter, ordered.data() + offset, count, ConverterSerializePosition(offset, ordered.size()), lines);
+		for (auto &line: lines)
+			f << line << '\n';
 		if (!f.good()){
 			f.close();
 			m_last_error = Error::file_write_error;
@@ -281,42 +289,14 @@ bool ImportExport::importTXT()
 		m_last_error = Error::could_not_open_file;
 		return false;
 	}
-	ColorObject *color_object;
-	Color dummy_color;
-	multimap<float, ColorObject*, greater<float>> valid_converters;
+	vector<string> lines;
 	string line;
 	string strip_chars = " \t";
-	bool imported = false;
 	for(;;){
 		getline(f, line);
 		stripLeadingTrailingChars(line, strip_chars);
-		if (!line.empty()){
-			for (auto &converter: m_converters->allPaste()){
-				if (!converter->hasDeserialize())
-					continue;
-				color_object = color_list_new_color_object(m_color_list, &dummy_color);
-				float quality;
-				if (converter->deserialize(line.c_str(), color_object, quality)){
-					if (quality > 0){
-						valid_converters.insert(make_pair(quality, color_object));
-					}else{
-						color_object->release();
-					}
-				}else{
-					color_object->release();
-				}
-			}
-			bool first = true;
-			for (auto result: valid_converters){
-				if (first){
-					first = false;
-					color_list_add_color_object(m_color_list, result.second, true);
-					imported = true;
-				}
-				result.second->release();
-			}
-			valid_converters.clear();
-		}
+		if (!line.empty())
+			lines.push_back(line);
 		if (!f.good()) {
 			if (f.eof()) break;
 			f.close();
@@ -325,6 +305,19 @@ bool ImportExport::importTXT()
 		}
 	}
 	f.close();
+	//lines are deserialized by worker Lua states in parallel, colors are added in file order
+	vector<ConverterWorkers::Deserialized> colors;
+	m_gs->converterWorkers().deserialize(m_converters->allPaste(), lines, colors);
+	bool imported = false;
+	for (auto &color: colors){
+		if (color.quality <= 0)
+			continue;
+		ColorObject *color_object = color_list_new_color_object(m_color_list, &color.color);
+		color_object->setName(color.name);
+		color_list_add_color_object(m_color_list, color_object, true);
+		color_object->release();
+		imported = true;
+	}
 	if (!imported){
 		m_last_error = Error::no_colors_imported;
 	}
@@ -887,19 +880,36 @@ ImportExport::Error ImportExport::getLastError() const
 struct ImportTextFile: public text_file_parser::TextFile
 {
 	ifstream m_file;
-	list<Color> m_colors;
+	GMappedFile *m_mapped_file;
+	vector<Color> m_colors;
 	bool m_failed;
 	ImportTextFile(const string &filename)
 	{
 		m_failed = false;
-		m_file.open(filename, ios::in);
+		m_mapped_file = g_mapped_file_new(filename.c_str(), FALSE, nullptr);
+		if (m_mapped_file == nullptr)
+			m_file.open(filename, ios::in);
 	}
 	bool isOpen()
 	{
-		return m_file.is_open();
+		return m_mapped_file != nullptr || m_file.is_open();
+	}
+	bool parse(const text_file_parser::Configuration &configuration, size_t thread_count)
+	{
+		if (m_mapped_file == nullptr)
+			return text_file_parser::TextFile::parse(configuration);
+		const char *data = g_mapped_file_get_contents(m_mapped_file);
+		size_t length = g_mapped_file_get_length(m_mapped_file);
+		if (data == nullptr || length == 0)
+			return true;
+		if (thread_count == 0)
+			thread_count = thread::hardware_concurrency();
+		return text_file_parser::TextFile::parse(configuration, data, length, thread_count);
 	}
 	virtual ~ImportTextFile()
 	{
+		if (m_mapped_file != nullptr)
+			g_mapped_file_unref(m_mapped_file);
 		m_file.close();
 	}
 	virtual void outOfMemory()
@@ -925,6 +935,10 @@ struct ImportTextFile: public text_file_parser::TextFile
 	{
 		m_colors.push_back(color);
 	}
+	virtual void addColors(const Color *colors, size_t count)
+	{
+		m_colors.insert(m_colors.end(), colors, colors + count);
+	}
 };
 bool ImportExport::importTextFile(const text_file_parser::Configuration &configuration)
 {
@@ -933,7 +947,7 @@ bool ImportExport::importTextFile(const text_file_parser::Configuration &configu
 		m_last_error = Error::could_not_open_file;
 		return false;
 	}
-	if (!import_text_file.parse(configuration)){
+	if (!import_text_file.parse(configuration, m_parser_thread_count)){
 		m_last_error = Error::parsing_failed;
 		return false;
 	}
@@ -945,8 +959,8 @@ bool ImportExport::importTextFile(const text_file_parser::Configuration &configu
 		m_last_error = Error::no_colors_imported;
 		return false;
 	}
-	for (auto color: import_text_file.m_colors){
-		auto color_object = new ColorObject("" ,color);
+	for (auto &color: import_text_file.m_colors){
+		auto color_object = new ColorObject("", color);
 		color_list_add_color_object(m_color_list, color_object, true);
 		color_object->release();
 	}
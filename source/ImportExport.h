@@ -75,6 +75,8 @@ struct ImportExport
 	void setBackground(Background background);
 	void setBackground(const char *background);
 	void setIncludeColorNames(bool include_color_names);
+	/** Set number of threads used by importTextFile() to parse mapped files. Zero, which is the default, uses one thread for each hardware thread. */
+	void setParserThreadCount(size_t parser_thread_count);
 	bool exportGPL();
 	bool importGPL();
 	bool exportASE();
@@ -105,6 +107,7 @@ struct ImportExport
 	Background m_background;
 	GlobalState *m_gs;
 	bool m_include_color_names;
+	size_t m_parser_thread_count;
 	Error m_last_error;
 };
 
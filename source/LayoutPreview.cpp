@@ -72,7 +72,7 @@ struct LayoutPreviewColorNameAssigner: public ToolColorNameAssigner
 		}
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color){
 			m_stream.str("");
-			m_stream << _("layout preview") << " " << m_ident << " [" << color_names_get(m_gs->getColorNames(), color, false) << "]";
+			m_stream << _("layout preview") << " " << m_ident << " [" << getColorName(color) << "]";
 			return m_stream.str();
 		}
 };
@@ -60,6 +60,14 @@ float clamp_float(float x, float a, float b) {
 	return x;
 }
 
+double clamp_double(double x, double a, double b) {
+	if (x < a)
+		return a;
+	if (x > b)
+		return b;
+	return x;
+}
+
 
 int clamp_int(int x, int a, int b) {
 	if (x < a)
@@ -33,6 +33,8 @@ int wrap_int(int x, int a, int b);
 
 float clamp_float(float x, float a, float b);
 
+double clamp_double(double x, double a, double b);
+
 float wrap_float(float x);
 
 float mix_float(float a, float b, float mix);
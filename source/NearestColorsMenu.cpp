@@ -22,22 +22,17 @@
 #include "Color.h"
 #include "ColorList.h"
 #include "ColorObject.h"
-#include <map>
+#include "ColorListIndex.h"
+#include <vector>
 using namespace std;
 
 GtkWidget* NearestColorsMenu::newMenu(ColorObject *color_object, GlobalState *gs)
 {
 	GtkWidget *menu = gtk_menu_new();
-	multimap<float, ColorObject *> color_distances;
-	Color source_color = color_object->getColor();
-	for (auto color_object: gs->getColorList()->colors){
-		Color target_color = color_object->getColor();
-		color_distances.insert(pair<float, ColorObject *>(color_distance_lch(&source_color, &target_color), color_object));
-	}
-	int count = 0;
-	for (auto item: color_distances){
+	vector<ColorListIndex::Result> nearest_colors;
+	color_list_get_index(gs->getColorList()).nearest(color_object->getColor(), 3, nearest_colors);
+	for (auto item: nearest_colors){
 		gtk_menu_shell_append(GTK_MENU_SHELL(menu), CopyMenuItem::newItem(item.second, gs, true));
-		if (++count >= 3) break;
 	}
 	return menu;
 }
@@ -65,3 +65,10 @@ gchar* build_config_path(const gchar *filename)
 	else
 		return g_build_filename(g_get_user_config_dir(), "gpick", nullptr);
 }
+gchar* build_cache_path(const gchar *filename)
+{
+	if (filename)
+		return g_build_filename(g_get_user_cache_dir(), "gpick", filename, nullptr);
+	else
+		return g_build_filename(g_get_user_cache_dir(), "gpick", nullptr);
+}
@@ -39,4 +39,11 @@ gchar* build_filename(const gchar* filename);
  */
 gchar* build_config_path(const gchar *filename);
 
+/**
+ * Construct filename to a cache file.
+ * @param[in] filename Relative cache file name.
+ * @return Filename to the cache file. This value must be released by using g_free.
+ */
+gchar* build_cache_path(const gchar *filename);
+
 #endif /* PATHS_H_ */
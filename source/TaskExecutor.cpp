@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "TaskExecutor.h"
+#include <glib.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+TaskExecutor::Task::Task():
+	m_cancelled(false)
+{
+}
+TaskExecutor::Task::~Task()
+{
+}
+void TaskExecutor::Task::cancel()
+{
+	m_cancelled = true;
+}
+bool TaskExecutor::Task::cancelled() const
+{
+	return m_cancelled;
+}
+struct TaskExecutor::Impl
+{
+	size_t m_thread_count;
+	vector<thread> m_threads;
+	deque<shared_ptr<Task>> m_queue;
+	mutex m_mutex;
+	condition_variable m_condition;
+	bool m_stop;
+	Impl(size_t thread_count):
+		m_thread_count(thread_count),
+		m_stop(false)
+	{
+		if (m_thread_count == 0)
+			m_thread_count = min(max(thread::hardware_concurrency(), 2u) - 1, 4u);
+	}
+	~Impl()
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_stop = true;
+			for (auto &task: m_queue)
+				task->cancel();
+			m_queue.clear();
+		}
+		m_condition.notify_all();
+		for (auto &worker: m_threads)
+			worker.join();
+	}
+	static gboolean finish(shared_ptr<Task> *task)
+	{
+		if (!(*task)->cancelled())
+			(*task)->finish();
+		delete task;
+		return FALSE;
+	}
+	void work()
+	{
+		for (;;){
+			shared_ptr<Task> task;
+			{
+				unique_lock<mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]{ return m_stop || !m_queue.empty(); });
+				if (m_stop)
+					return;
+				task = m_queue.front();
+				m_queue.pop_front();
+			}
+			if (task->cancelled())
+				continue;
+			task->run();
+			if (task->cancelled())
+				continue;
+			g_idle_add((GSourceFunc)finish, new shared_ptr<Task>(task));
+		}
+	}
+	void submit(const shared_ptr<Task> &task)
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_queue.push_back(task);
+			if (m_threads.size() < m_thread_count)
+				m_threads.emplace_back(&Impl::work, this);
+		}
+		m_condition.notify_one();
+	}
+};
+TaskExecutor::TaskExecutor(size_t thread_count):
+	m_impl(make_unique<Impl>(thread_count))
+{
+}
+TaskExecutor::~TaskExecutor()
+{
+}
+void TaskExecutor::submit(const shared_ptr<Task> &task)
+{
+	m_impl->submit(task);
+}
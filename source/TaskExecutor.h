@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_TASK_EXECUTOR_H_
+#define GPICK_TASK_EXECUTOR_H_
+#include <memory>
+#include <atomic>
+#include <cstddef>
+/** \struct TaskExecutor
+ * \brief Runs tasks in background threads and hands their results back to the GTK main loop.
+ *
+ * Tasks must not use GTK, Lua or dynv settings in run(), these can only be used in finish(), which is called from the main loop through g_idle_add.
+ */
+struct TaskExecutor
+{
+	struct Task
+	{
+		Task();
+		virtual ~Task();
+		/** Do the work. Called in a worker thread. Long running tasks should return early when cancelled() becomes true. */
+		virtual void run() = 0;
+		/** Use task results. Called in the main loop after run() has finished, unless the task was cancelled. */
+		virtual void finish() = 0;
+		/** Request cancellation. When called from the main loop, it is guaranteed that finish() will not be called anymore. */
+		void cancel();
+		bool cancelled() const;
+		private:
+		std::atomic<bool> m_cancelled;
+	};
+	/**
+	 * Create executor.
+	 * @param[in] thread_count Maximum number of worker threads. Zero selects count by hardware concurrency.
+	 */
+	TaskExecutor(size_t thread_count = 0);
+	/** Cancel queued tasks and wait until running tasks finish. */
+	~TaskExecutor();
+	/** Queue task for execution. Worker threads are started when the first task is submitted. */
+	void submit(const std::shared_ptr<Task> &task);
+	private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+#endif /* GPICK_TASK_EXECUTOR_H_ */
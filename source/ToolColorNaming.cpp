@@ -22,7 +22,13 @@
 #include "I18N.h"
 #include "color_names/ColorNames.h"
 #include "ColorObject.h"
+#include "Color.h"
+#include "Tracing.h"
 #include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
 using namespace std;
 
 const ToolColorNamingOption options[] = {
@@ -47,8 +53,92 @@ ToolColorNamingType tool_color_naming_name_to_type(const char *name)
 	}
 	return TOOL_COLOR_NAMING_UNKNOWN;
 }
+struct ToolColorNameCache::Impl
+{
+	/** Cache is cleared when it grows over this number of names. */
+	static const size_t max_size = 65536;
+	struct Key
+	{
+		uint32_t rgb[3];
+		bool imprecision_postfix;
+		bool operator==(const Key &key) const
+		{
+			return rgb[0] == key.rgb[0] && rgb[1] == key.rgb[1] && rgb[2] == key.rgb[2] && imprecision_postfix == key.imprecision_postfix;
+		}
+	};
+	struct KeyHash
+	{
+		size_t operator()(const Key &key) const
+		{
+			size_t hash = key.imprecision_postfix;
+			for (int i = 0; i < 3; i++)
+				hash = hash * 0x9e3779b1u + key.rgb[i];
+			return hash;
+		}
+	};
+	mutable mutex m_mutex;
+	unordered_map<Key, string, KeyHash> m_names;
+	Statistics m_last_recompute, m_total;
+	Impl()
+	{
+		m_last_recompute.lookups = m_last_recompute.saved_lookups = 0;
+		m_total = m_last_recompute;
+	}
+};
+ToolColorNameCache::ToolColorNameCache():
+	m_impl(new Impl())
+{
+}
+ToolColorNameCache::~ToolColorNameCache()
+{
+}
+string ToolColorNameCache::get(ColorNames *color_names, const Color *color, bool imprecision_postfix, bool &cached)
+{
+	Impl::Key key;
+	memcpy(key.rgb, &color->rgb, sizeof(key.rgb));
+	key.imprecision_postfix = imprecision_postfix;
+	{
+		lock_guard<mutex> lock(m_impl->m_mutex);
+		auto i = m_impl->m_names.find(key);
+		if (i != m_impl->m_names.end()){
+			cached = true;
+			return i->second;
+		}
+	}
+	cached = false;
+	string name = color_names_get(color_names, color, imprecision_postfix);
+	lock_guard<mutex> lock(m_impl->m_mutex);
+	if (m_impl->m_names.size() >= Impl::max_size)
+		m_impl->m_names.clear();
+	m_impl->m_names[key] = name;
+	return name;
+}
+void ToolColorNameCache::clear()
+{
+	lock_guard<mutex> lock(m_impl->m_mutex);
+	m_impl->m_names.clear();
+}
+void ToolColorNameCache::addRecompute(const Statistics &statistics)
+{
+	lock_guard<mutex> lock(m_impl->m_mutex);
+	m_impl->m_last_recompute = statistics;
+	m_impl->m_total.lookups += statistics.lookups;
+	m_impl->m_total.saved_lookups += statistics.saved_lookups;
+}
+ToolColorNameCache::Statistics ToolColorNameCache::lastRecompute() const
+{
+	lock_guard<mutex> lock(m_impl->m_mutex);
+	return m_impl->m_last_recompute;
+}
+ToolColorNameCache::Statistics ToolColorNameCache::total() const
+{
+	lock_guard<mutex> lock(m_impl->m_mutex);
+	return m_impl->m_total;
+}
 ToolColorNameAssigner::ToolColorNameAssigner(GlobalState *gs):
-	m_gs(gs)
+	m_gs(gs),
+	m_lookups(0),
+	m_saved_lookups(0)
 {
 	m_color_naming_type = tool_color_naming_name_to_type(dynv_get_string_wd(m_gs->getSettings(), "gpick.color_names.tool_color_naming", "tool_specific"));
 	if (m_color_naming_type == TOOL_COLOR_NAMING_AUTOMATIC_NAME){
@@ -59,6 +149,34 @@ ToolColorNameAssigner::ToolColorNameAssigner(GlobalState *gs):
 }
 ToolColorNameAssigner::~ToolColorNameAssigner()
 {
+	//assigner lives for one recompute of tool colors
+	if (m_lookups + m_saved_lookups == 0)
+		return;
+	ToolColorNameCache::Statistics statistics;
+	statistics.lookups = m_lookups;
+	statistics.saved_lookups = m_saved_lookups;
+	m_gs->toolColorNameCache().addRecompute(statistics);
+	tracing::count("tool_color_naming.lookups", m_lookups);
+	tracing::count("tool_color_naming.saved_lookups", m_saved_lookups);
+	tracing::sample("tool_color_naming.saved_lookups_per_recompute", m_saved_lookups);
+}
+string ToolColorNameAssigner::getColorName(const Color *color, bool imprecision_postfix)
+{
+	bool cached;
+	string name = m_gs->toolColorNameCache().get(m_gs->getColorNames(), color, imprecision_postfix, cached);
+	if (cached)
+		m_saved_lookups++;
+	else
+		m_lookups++;
+	return name;
+}
+size_t ToolColorNameAssigner::lookups() const
+{
+	return m_lookups;
+}
+size_t ToolColorNameAssigner::savedLookups() const
+{
+	return m_saved_lookups;
 }
 void ToolColorNameAssigner::assign(ColorObject *color_object, const Color *color)
 {
@@ -69,7 +187,7 @@ void ToolColorNameAssigner::assign(ColorObject *color_object, const Color *color
 			color_object->setName("");
 			break;
 		case TOOL_COLOR_NAMING_AUTOMATIC_NAME:
-			name = color_names_get(m_gs->getColorNames(), color, m_imprecision_postfix);
+			name = getColorName(color, m_imprecision_postfix);
 			color_object->setName(name);
 			break;
 		case TOOL_COLOR_NAMING_TOOL_SPECIFIC:
@@ -20,9 +20,12 @@
 #define GPICK_TOOL_COLOR_NAMING_H_
 
 #include <string>
+#include <memory>
+#include <cstddef>
 struct GlobalState;
 struct Color;
 struct ColorObject;
+struct ColorNames;
 enum ToolColorNamingType {
 	TOOL_COLOR_NAMING_UNKNOWN = 0,
 	TOOL_COLOR_NAMING_EMPTY,
@@ -38,17 +41,69 @@ typedef struct ToolColorNamingOption{
 const ToolColorNamingOption* tool_color_naming_get_options();
 ToolColorNamingType tool_color_naming_name_to_type(const char *name);
 
+/** \struct ToolColorNameCache
+ * \brief Memoized color dictionary lookups shared by all tools which generate named colors.
+ *
+ * Tools regenerate all colors on every settings change, but most of the generated colors usually stay the same, so their names are taken from this cache.
+ * Cache must be cleared when color dictionaries are reloaded.
+ */
+struct ToolColorNameCache
+{
+	/** Color dictionary lookup counts. */
+	struct Statistics
+	{
+		/** Number of names found in color dictionary. */
+		size_t lookups;
+		/** Number of names found in cache, each one is a color dictionary lookup saved. */
+		size_t saved_lookups;
+	};
+	ToolColorNameCache();
+	~ToolColorNameCache();
+	/**
+	 * Get color name from color dictionary or from cache.
+	 * @param[in] color_names Color dictionary.
+	 * @param[in] color Color in RGB color space.
+	 * @param[in] imprecision_postfix Add imprecision postfix to the name.
+	 * @param[out] cached Set to true, when name was found in cache.
+	 * @return Color name.
+	 */
+	std::string get(ColorNames *color_names, const Color *color, bool imprecision_postfix, bool &cached);
+	/** Remove all cached names. Statistics are kept. */
+	void clear();
+	/**
+	 * Add lookup counts of one tool colors recompute.
+	 * @param[in] statistics Lookup counts of recompute.
+	 */
+	void addRecompute(const Statistics &statistics);
+	/** Lookup counts of the last recompute, which did any lookups. */
+	Statistics lastRecompute() const;
+	/** Lookup counts of all recomputes. */
+	Statistics total() const;
+	private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
 struct ToolColorNameAssigner
 {
 	protected:
 		ToolColorNamingType m_color_naming_type;
 		GlobalState* m_gs;
 		bool m_imprecision_postfix;
+		size_t m_lookups;
+		size_t m_saved_lookups;
 	public:
 		ToolColorNameAssigner(GlobalState *gs);
+		/** Adds lookup counts of this assigner to shared tool color name cache statistics. */
 		virtual ~ToolColorNameAssigner();
 		void assign(ColorObject *color_object, const Color *color);
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color) = 0;
+		/** Get color name from color dictionary through shared tool color name cache. */
+		std::string getColorName(const Color *color, bool imprecision_postfix = false);
+		/** Number of color dictionary lookups done by this assigner. */
+		size_t lookups() const;
+		/** Number of color dictionary lookups avoided by this assigner, because names were found in cache. */
+		size_t savedLookups() const;
 };
 
 #endif /* GPICK_TOOL_COLOR_NAMING_H_ */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Tracing.h"
+#include <glib.h>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+using namespace std;
+
+namespace tracing
+{
+	std::atomic<Tracer*> active_tracer(nullptr);
+	/** Maximal number of stored trace events. Counters and histograms are still updated when limit is reached. */
+	const size_t max_events = 1000000;
+	/** Histogram bucket i contains values in range [2^(i-1), 2^i), bucket 0 contains values smaller than 1. */
+	const int histogram_buckets = 32;
+	struct Event
+	{
+		const char *name;
+		char phase;
+		uint32_t thread;
+		int64_t timestamp;
+		int64_t value;
+	};
+	struct Histogram
+	{
+		uint64_t count;
+		double sum, min, max;
+		uint64_t buckets[histogram_buckets];
+		Histogram():
+			count(0),
+			sum(0),
+			min(numeric_limits<double>::max()),
+			max(numeric_limits<double>::lowest()),
+			buckets()
+		{
+		}
+		void add(double value)
+		{
+			count++;
+			sum += value;
+			if (value < min) min = value;
+			if (value > max) max = value;
+			int bucket = 0;
+			while (bucket < histogram_buckets - 1 && value >= static_cast<double>(uint64_t(1) << bucket))
+				bucket++;
+			buckets[bucket]++;
+		}
+	};
+	static uint32_t threadId()
+	{
+		static std::atomic<uint32_t> next_thread_id(1);
+		thread_local uint32_t thread_id = next_thread_id++;
+		return thread_id;
+	}
+	struct Tracer::Impl
+	{
+		mutable mutex m_mutex;
+		int64_t m_start_time;
+		vector<Event> m_events;
+		size_t m_dropped_events;
+		map<string, int64_t> m_counters;
+		map<string, Histogram> m_histograms;
+		bool m_started;
+		Impl():
+			m_start_time(Tracer::now()),
+			m_dropped_events(0),
+			m_started(false)
+		{
+		}
+		void addEvent(const char *name, char phase, int64_t timestamp, int64_t value)
+		{
+			if (m_events.size() >= max_events){
+				m_dropped_events++;
+				return;
+			}
+			Event event;
+			event.name = name;
+			event.phase = phase;
+			event.thread = threadId();
+			event.timestamp = timestamp;
+			event.value = value;
+			m_events.push_back(event);
+		}
+		static void writeString(ostream &stream, const char *value)
+		{
+			stream << '"';
+			for (const char *i = value; *i; ++i){
+				if (*i == '"' || *i == '\\')
+					stream << '\\' << *i;
+				else if (static_cast<unsigned char>(*i) < 0x20)
+					stream << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(*i) << dec << setfill(' ');
+				else
+					stream << *i;
+			}
+			stream << '"';
+		}
+		bool write(const char *filename) const
+		{
+			lock_guard<mutex> lock(m_mutex);
+			ofstream file(filename, ios::out | ios::trunc);
+			if (!file.is_open())
+				return false;
+			file << setprecision(12);
+			file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+			file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"main\"}}";
+			for (auto &event: m_events){
+				file << ",\n{\"name\": ";
+				writeString(file, event.name);
+				file << ", \"ph\": \"" << event.phase << "\", \"pid\": 1, \"tid\": " << event.thread << ", \"ts\": " << event.timestamp - m_start_time;
+				if (event.phase == 'X')
+					file << ", \"dur\": " << event.value;
+				else
+					file << ", \"args\": {\"value\": " << event.value << "}";
+				file << "}";
+			}
+			file << "\n], \"otherData\": {\"dropped_events\": " << m_dropped_events << ", \"counters\": {";
+			bool first = true;
+			for (auto &counter: m_counters){
+				file << (first ? "" : ", ");
+				writeString(file, counter.first.c_str());
+				file << ": " << counter.second;
+				first = false;
+			}
+			file << "}, \"histograms\": {";
+			first = true;
+			for (auto &item: m_histograms){
+				const Histogram &histogram = item.second;
+				file << (first ? "\n" : ",\n");
+				writeString(file, item.first.c_str());
+				file << ": {\"count\": " << histogram.count << ", \"sum\": " << histogram.sum << ", \"min\": " << histogram.min << ", \"max\": " << histogram.max;
+				file << ", \"mean\": " << histogram.sum / histogram.count << ", \"buckets\": [";
+				int last_bucket = histogram_buckets - 1;
+				while (last_bucket > 0 && histogram.buckets[last_bucket] == 0)
+					last_bucket--;
+				for (int i = 0; i <= last_bucket; i++)
+					file << (i ? ", " : "") << histogram.buckets[i];
+				file << "]}";
+				first = false;
+			}
+			file << "}}}\n";
+			file.close();
+			return file.good();
+		}
+	};
+	Tracer::Tracer():
+		m_impl(make_unique<Impl>())
+	{
+	}
+	Tracer::~Tracer()
+	{
+		stop();
+	}
+	void Tracer::start()
+	{
+		m_impl->m_started = true;
+		active_tracer = this;
+	}
+	void Tracer::stop()
+	{
+		Tracer *tracer = this;
+		active_tracer.compare_exchange_strong(tracer, nullptr);
+		m_impl->m_started = false;
+	}
+	bool Tracer::started() const
+	{
+		return m_impl->m_started;
+	}
+	bool Tracer::write(const char *filename) const
+	{
+		return m_impl->write(filename);
+	}
+	void Tracer::complete(const char *name, int64_t start, int64_t duration)
+	{
+		lock_guard<mutex> lock(m_impl->m_mutex);
+		m_impl->addEvent(name, 'X', start, duration);
+		m_impl->m_histograms[name].add(static_cast<double>(duration));
+	}
+	void Tracer::count(const char *name, int64_t value)
+	{
+		lock_guard<mutex> lock(m_impl->m_mutex);
+		int64_t &total = m_impl->m_counters[name];
+		total += value;
+		m_impl->addEvent(name, 'C', now(), total);
+	}
+	void Tracer::sample(const char *name, double value)
+	{
+		lock_guard<mutex> lock(m_impl->m_mutex);
+		m_impl->m_histograms[name].add(value);
+	}
+	int64_t Tracer::now()
+	{
+		return g_get_monotonic_time();
+	}
+}
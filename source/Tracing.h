@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_TRACING_H_
+#define GPICK_TRACING_H_
+#include <cstdint>
+#include <atomic>
+#include <memory>
+namespace tracing
+{
+	/** \struct Tracer
+	 * \brief Collects scoped timers, counters and histograms and writes them in Chrome trace event format.
+	 *
+	 * Event and counter names are not copied, so only string literals can be used as names.
+	 * Recording is thread safe. When tracer is not started, instrumentation costs one relaxed atomic load.
+	 */
+	struct Tracer
+	{
+		Tracer();
+		~Tracer();
+		/** Make this tracer active, so that TRACE_SCOPE and tracing::count/tracing::sample calls are recorded. */
+		void start();
+		/** Stop recording, collected data is kept. */
+		void stop();
+		bool started() const;
+		/** Write all collected events, counters and histograms into a JSON file, which can be opened by chrome://tracing. */
+		bool write(const char *filename) const;
+		/** Record finished timed event. Duration is also added into histogram with the same name. */
+		void complete(const char *name, int64_t start, int64_t duration);
+		/** Add value to named counter. */
+		void count(const char *name, int64_t value);
+		/** Add value to named histogram. */
+		void sample(const char *name, double value);
+		/** Current monotonic time in microseconds. */
+		static int64_t now();
+		private:
+		struct Impl;
+		std::unique_ptr<Impl> m_impl;
+	};
+	extern std::atomic<Tracer*> active_tracer;
+	inline Tracer *active()
+	{
+		return active_tracer.load(std::memory_order_relaxed);
+	}
+	inline void count(const char *name, int64_t value = 1)
+	{
+		Tracer *tracer = active();
+		if (tracer) tracer->count(name, value);
+	}
+	inline void sample(const char *name, double value)
+	{
+		Tracer *tracer = active();
+		if (tracer) tracer->sample(name, value);
+	}
+	/** Measures time from construction until destruction and records it as complete event. */
+	struct Scope
+	{
+		Scope(const char *name):
+			m_tracer(active()),
+			m_name(name),
+			m_start(m_tracer ? Tracer::now() : 0)
+		{
+		}
+		~Scope()
+		{
+			if (m_tracer) m_tracer->complete(m_name, m_start, Tracer::now() - m_start);
+		}
+		private:
+		Tracer *m_tracer;
+		const char *m_name;
+		int64_t m_start;
+	};
+}
+#define TRACE_SCOPE_CONCAT_(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) tracing::Scope TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(name)
+#endif /* GPICK_TRACING_H_ */
@@ -105,7 +105,7 @@ struct VariationsColorNameAssigner: public ToolColorNameAssigner
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color)
 		{
 			m_stream.str("");
-			m_stream << color_names_get(m_gs->getColorNames(), color, false) << " " << _("variations") << " " << m_ident;
+			m_stream << getColorName(color) << " " << _("variations") << " " << m_ident;
 			return m_stream.str();
 		}
 };
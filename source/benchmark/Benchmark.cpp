@@ -0,0 +1,240 @@
+#include "Benchmark.h"
+#include "GlobalState.h"
+#include "Color.h"
+#include "version/Version.h"
+#include <glib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <algorithm>
+using namespace std;
+
+namespace benchmark
+{
+	State::State(size_t iterations):
+		m_iterations(iterations),
+		m_remaining(iterations),
+		m_items(0),
+		m_bytes(0),
+		m_started(false),
+		m_paused(false),
+		m_elapsed(chrono::steady_clock::duration::zero())
+	{
+	}
+	bool State::keepRunning()
+	{
+		if (!m_started){
+			m_started = true;
+			m_start = chrono::steady_clock::now();
+		}
+		if (m_remaining > 0){
+			m_remaining--;
+			return true;
+		}
+		if (!m_paused){
+			m_elapsed += chrono::steady_clock::now() - m_start;
+			m_paused = true;
+		}
+		return false;
+	}
+	void State::pauseTiming()
+	{
+		if (m_paused) return;
+		m_elapsed += chrono::steady_clock::now() - m_start;
+		m_paused = true;
+	}
+	void State::resumeTiming()
+	{
+		if (!m_paused) return;
+		m_start = chrono::steady_clock::now();
+		m_paused = false;
+	}
+	void State::setItemsProcessed(size_t items)
+	{
+		m_items = items;
+	}
+	void State::setBytesProcessed(size_t bytes)
+	{
+		m_bytes = bytes;
+	}
+	size_t State::iterations() const
+	{
+		return m_iterations;
+	}
+	size_t State::itemsProcessed() const
+	{
+		return m_items;
+	}
+	size_t State::bytesProcessed() const
+	{
+		return m_bytes;
+	}
+	double State::elapsed() const
+	{
+		return chrono::duration<double>(m_elapsed).count();
+	}
+	static map<string, Function> &benchmarks()
+	{
+		static map<string, Function> benchmarks;
+		return benchmarks;
+	}
+	bool add(const char *name, Function function)
+	{
+		benchmarks()[name] = function;
+		return true;
+	}
+	GlobalState &globalState()
+	{
+		static GlobalState *global_state = nullptr;
+		if (!global_state){
+			color_init();
+			global_state = new GlobalState();
+			global_state->loadAll();
+		}
+		return *global_state;
+	}
+	void randomColors(size_t count, vector<Color> &colors)
+	{
+		mt19937 generator(0x67706963);
+		uniform_real_distribution<float> distribution(0.0f, 1.0f);
+		colors.resize(count);
+		for (auto &color: colors){
+			color.rgb.red = distribution(generator);
+			color.rgb.green = distribution(generator);
+			color.rgb.blue = distribution(generator);
+			color.ma[3] = 0;
+		}
+	}
+	struct Result
+	{
+		string name;
+		size_t iterations;
+		double real_time;
+		double items_per_second;
+		double bytes_per_second;
+	};
+	static Result runBenchmark(const string &name, Function function, double min_time)
+	{
+		size_t iterations = 1;
+		for (;;){
+			State state(iterations);
+			function(state);
+			double elapsed = state.elapsed();
+			if (elapsed >= min_time || iterations >= 1000000000){
+				Result result;
+				result.name = name;
+				result.iterations = iterations;
+				result.real_time = elapsed * 1e9 / iterations;
+				result.items_per_second = elapsed > 0 ? state.itemsProcessed() / elapsed : 0;
+				result.bytes_per_second = elapsed > 0 ? state.bytesProcessed() / elapsed : 0;
+				return result;
+			}
+			double multiplier = elapsed > 0 ? min_time * 1.4 / elapsed : 10;
+			multiplier = min(max(multiplier, 2.0), 10.0);
+			iterations = static_cast<size_t>(iterations * multiplier);
+		}
+	}
+	static string jsonString(const string &value)
+	{
+		stringstream result;
+		result << '"';
+		for (char c: value){
+			if (c == '"' || c == '\\')
+				result << '\\' << c;
+			else if (static_cast<unsigned char>(c) < 0x20)
+				result << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec << setfill(' ');
+			else
+				result << c;
+		}
+		result << '"';
+		return result.str();
+	}
+	static void writeJson(ostream &stream, const vector<Result> &results)
+	{
+		GDateTime *now = g_date_time_new_now_local();
+		gchar *date = g_date_time_format(now, "%Y-%m-%dT%H:%M:%S%z");
+		g_date_time_unref(now);
+		stream << setprecision(10);
+		stream << "{" << endl;
+		stream << "\t\"context\": {" << endl;
+		stream << "\t\t\"date\": " << jsonString(date) << "," << endl;
+		stream << "\t\t\"version\": " << jsonString(gpick_build_version) << "," << endl;
+		stream << "\t\t\"revision\": " << jsonString(gpick_build_revision) << "," << endl;
+		stream << "\t\t\"platform\": " << jsonString(gpick_build_platform) << "," << endl;
+		stream << "\t\t\"num_cpus\": " << thread::hardware_concurrency() << endl;
+		stream << "\t}," << endl;
+		stream << "\t\"benchmarks\": [" << endl;
+		g_free(date);
+		for (size_t i = 0; i < results.size(); i++){
+			const Result &result = results[i];
+			stream << "\t\t{";
+			stream << "\"name\": " << jsonString(result.name);
+			stream << ", \"iterations\": " << result.iterations;
+			stream << ", \"real_time\": " << result.real_time;
+			stream << ", \"time_unit\": \"ns\"";
+			if (result.items_per_second > 0)
+				stream << ", \"items_per_second\": " << result.items_per_second;
+			if (result.bytes_per_second > 0)
+				stream << ", \"bytes_per_second\": " << result.bytes_per_second;
+			stream << "}" << (i + 1 < results.size() ? "," : "") << endl;
+		}
+		stream << "\t]" << endl;
+		stream << "}" << endl;
+	}
+	static gchar *filter = nullptr;
+	static gchar *output_filename = nullptr;
+	static gboolean list_only = FALSE;
+	static gdouble min_time = 0.5;
+	static GOptionEntry entries[] =
+	{
+		{"filter", 'f', 0, G_OPTION_ARG_STRING, &filter, "Run only benchmarks which contain given text in their name", "TEXT"},
+		{"output", 'o', 0, G_OPTION_ARG_FILENAME, &output_filename, "Write JSON results into file instead of standard output", "FILE"},
+		{"min-time", 't', 0, G_OPTION_ARG_DOUBLE, &min_time, "Minimal measured time of every benchmark in seconds", "SECONDS"},
+		{"list", 'l', 0, G_OPTION_ARG_NONE, &list_only, "List benchmarks and exit", nullptr},
+		{nullptr}
+	};
+	int run(int argc, char **argv)
+	{
+		GError *error = nullptr;
+		GOptionContext *context = g_option_context_new("- run gpick benchmarks");
+		g_option_context_add_main_entries(context, entries, 0);
+		if (!g_option_context_parse(context, &argc, &argv, &error)){
+			cerr << "option parsing failed: " << error->message << endl;
+			g_clear_error(&error);
+			g_option_context_free(context);
+			return -1;
+		}
+		g_option_context_free(context);
+		vector<Result> results;
+		for (auto &benchmark: benchmarks()){
+			if (filter && benchmark.first.find(filter) == string::npos)
+				continue;
+			if (list_only){
+				cout << benchmark.first << endl;
+				continue;
+			}
+			Result result = runBenchmark(benchmark.first, benchmark.second, min_time);
+			cerr << left << setw(40) << result.name << right << setw(16) << fixed << setprecision(1) << result.real_time << " ns" << setw(14) << result.iterations << endl;
+			results.push_back(result);
+		}
+		if (list_only)
+			return 0;
+		if (output_filename){
+			ofstream file(output_filename, ios::out | ios::trunc);
+			if (!file.is_open()){
+				cerr << "could not open output file: " << output_filename << endl;
+				return -1;
+			}
+			writeJson(file, results);
+		}else{
+			writeJson(cout, results);
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef GPICK_BENCHMARK_BENCHMARK_H_
+#define GPICK_BENCHMARK_BENCHMARK_H_
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+struct GlobalState;
+struct Color;
+namespace benchmark
+{
+	/** Benchmark run state. Benchmark function body must loop while keepRunning() returns true, only time spent inside the loop is measured. */
+	struct State
+	{
+		State(size_t iterations);
+		bool keepRunning();
+		/** Exclude following code from measured time until resumeTiming() is called. */
+		void pauseTiming();
+		void resumeTiming();
+		/** Set total number of items (colors, lookups, etc.) processed during all iterations. */
+		void setItemsProcessed(size_t items);
+		/** Set total number of bytes processed during all iterations. */
+		void setBytesProcessed(size_t bytes);
+		size_t iterations() const;
+		size_t itemsProcessed() const;
+		size_t bytesProcessed() const;
+		/** Measured time in seconds. */
+		double elapsed() const;
+		private:
+		size_t m_iterations, m_remaining, m_items, m_bytes;
+		bool m_started, m_paused;
+		std::chrono::steady_clock::time_point m_start;
+		std::chrono::steady_clock::duration m_elapsed;
+	};
+	typedef void (*Function)(State &state);
+	/** Register benchmark function. Used through BENCHMARK macro. */
+	bool add(const char *name, Function function);
+	/** Run all registered benchmarks which match command line filter. */
+	int run(int argc, char **argv);
+	/** Global state with loaded settings, color names and Lua converters, shared between benchmarks. */
+	GlobalState &globalState();
+	/** Generate deterministic pseudo random RGB colors. */
+	void randomColors(size_t count, std::vector<Color> &colors);
+}
+#define BENCHMARK(group, function) static const bool group##_##function##_registered = benchmark::add(#group "/" #function, function)
+#endif /* GPICK_BENCHMARK_BENCHMARK_H_ */
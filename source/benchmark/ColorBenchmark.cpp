@@ -0,0 +1,167 @@
+#include "Benchmark.h"
+#include "Color.h"
+#include "ColorDistance.h"
+#include "ColorRYB.h"
+#include "MathUtil.h"
+#include <cmath>
+#include <vector>
+using namespace std;
+
+static const size_t color_count = 4096;
+template<typename Convert>
+static void convert(benchmark::State &state, Convert convert)
+{
+	color_init();
+	vector<Color> input, output(color_count);
+	benchmark::randomColors(color_count, input);
+	while (state.keepRunning()){
+		for (size_t i = 0; i < color_count; i++)
+			convert(&input[i], &output[i]);
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static void rgb_to_hsv(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_to_hsv(a, b); });
+}
+static void hsv_to_rgb(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_hsv_to_rgb(a, b); });
+}
+static void rgb_to_hsl(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_to_hsl(a, b); });
+}
+static void hsl_to_rgb(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_hsl_to_rgb(a, b); });
+}
+static void rgb_to_lab_d50(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_to_lab_d50(a, b); });
+}
+static void lab_to_rgb_d50(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){
+		Color lab;
+		lab.lab.L = a->rgb.red * 100;
+		lab.lab.a = a->rgb.green * 200 - 100;
+		lab.lab.b = a->rgb.blue * 200 - 100;
+		color_lab_to_rgb_d50(&lab, b);
+	});
+}
+static void rgb_to_lch_d50(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_to_lch_d50(a, b); });
+}
+static void rgb_to_cmyk(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_to_cmyk(a, b); });
+}
+static void rgb_get_linear(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_get_linear(a, b); });
+}
+template<typename Distance>
+static void distance(benchmark::State &state, void (*convert)(const Color *a, Color *b), Distance distance)
+{
+	color_init();
+	vector<Color> input, colors(color_count);
+	vector<float> distances(color_count);
+	benchmark::randomColors(color_count, input);
+	for (size_t i = 0; i < color_count; i++)
+		convert(&input[i], &colors[i]);
+	while (state.keepRunning()){
+		for (size_t i = 0; i < color_count; i++)
+			distances[i] = distance(&colors[0], &colors[i]);
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static void distance_batch(benchmark::State &state, const ColorDistance &metric)
+{
+	color_init();
+	vector<Color> input, colors(color_count);
+	vector<float> distances(color_count);
+	benchmark::randomColors(color_count, input);
+	for (size_t i = 0; i < color_count; i++)
+		metric.prepareRgb(input[i], colors[i]);
+	while (state.keepRunning()){
+		metric.distances(colors[0], colors.data(), color_count, distances.data());
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static void distance_lch(benchmark::State &state)
+{
+	distance(state, color_rgb_to_lab_d50, color_distance_lch);
+}
+static void distance_ciede2000(benchmark::State &state)
+{
+	distance(state, color_rgb_to_lab_d50, color_distance_ciede2000);
+}
+static void distance_cam16ucs(benchmark::State &state)
+{
+	distance(state, color_rgb_to_cam16ucs, color_distance_cam16ucs);
+}
+static void distance_batch_cie76(benchmark::State &state)
+{
+	distance_batch(state, color_distance_cie76_metric);
+}
+static void distance_batch_cie94(benchmark::State &state)
+{
+	distance_batch(state, color_distance_cie94_metric);
+}
+static void distance_batch_ciede2000(benchmark::State &state)
+{
+	distance_batch(state, color_distance_ciede2000_metric);
+}
+static void distance_batch_cam16ucs(benchmark::State &state)
+{
+	distance_batch(state, color_distance_cam16ucs_metric);
+}
+static void rgb_to_cam16ucs(benchmark::State &state)
+{
+	convert(state, [](const Color *a, Color *b){ color_rgb_to_cam16ucs(a, b); });
+}
+template<typename HueToRgb>
+static void ryb_wheel(benchmark::State &state, HueToRgb hue_to_rgb)
+{
+	color_init();
+	const int size = 256;
+	Color color;
+	while (state.keepRunning()){
+		for (int y = 0; y < size; y++){
+			for (int x = 0; x < size; x++){
+				double hue = atan2(y - size / 2.0, x - size / 2.0) / (2 * PI) + 0.5;
+				hue_to_rgb(hue, &color);
+			}
+		}
+	}
+	state.setItemsProcessed(state.iterations() * size * size);
+}
+static void ryb_wheel_exact(benchmark::State &state)
+{
+	ryb_wheel(state, color_rybhue_to_rgb_exact);
+}
+static void ryb_wheel_table(benchmark::State &state)
+{
+	ryb_wheel(state, color_rybhue_to_rgb);
+}
+BENCHMARK(color, rgb_to_hsv);
+BENCHMARK(color, hsv_to_rgb);
+BENCHMARK(color, rgb_to_hsl);
+BENCHMARK(color, hsl_to_rgb);
+BENCHMARK(color, rgb_to_lab_d50);
+BENCHMARK(color, lab_to_rgb_d50);
+BENCHMARK(color, rgb_to_lch_d50);
+BENCHMARK(color, rgb_to_cmyk);
+BENCHMARK(color, rgb_get_linear);
+BENCHMARK(color, rgb_to_cam16ucs);
+BENCHMARK(color, distance_lch);
+BENCHMARK(color, distance_ciede2000);
+BENCHMARK(color, distance_cam16ucs);
+BENCHMARK(color, distance_batch_cie76);
+BENCHMARK(color, distance_batch_cie94);
+BENCHMARK(color, distance_batch_ciede2000);
+BENCHMARK(color, distance_batch_cam16ucs);
+BENCHMARK(color, ryb_wheel_exact);
+BENCHMARK(color, ryb_wheel_table);
@@ -0,0 +1,35 @@
+#include "Benchmark.h"
+#include "GlobalState.h"
+#include "color_names/ColorNames.h"
+#include <vector>
+#include <string>
+using namespace std;
+
+static const size_t color_count = 256;
+static void get(benchmark::State &state)
+{
+	ColorNames *color_names = benchmark::globalState().getColorNames();
+	vector<Color> colors;
+	benchmark::randomColors(color_count, colors);
+	while (state.keepRunning()){
+		for (auto &color: colors)
+			color_names_get(color_names, &color, true);
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static void find_nearest(benchmark::State &state)
+{
+	ColorNames *color_names = benchmark::globalState().getColorNames();
+	vector<Color> colors;
+	benchmark::randomColors(color_count, colors);
+	vector<pair<const char*, Color>> nearest;
+	while (state.keepRunning()){
+		for (auto &color: colors){
+			nearest.clear();
+			color_names_find_nearest(color_names, color, 10, nearest);
+		}
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+BENCHMARK(color_names, get);
+BENCHMARK(color_names, find_nearest);
@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "GlobalState.h"
+#include "Converters.h"
+#include "Converter.h"
+#include "ColorObject.h"
+#include <vector>
+#include <string>
+using namespace std;
+
+static const size_t color_count = 256;
+static void serialize(benchmark::State &state, const char *converter_name)
+{
+	Converter *converter = benchmark::globalState().converters().byName(converter_name);
+	if (!converter || !converter->hasSerialize()){
+		while (state.keepRunning());
+		return;
+	}
+	vector<Color> colors;
+	benchmark::randomColors(color_count, colors);
+	size_t bytes = 0;
+	while (state.keepRunning()){
+		for (auto &color: colors)
+			bytes += converter->serialize(color).length();
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+	state.setBytesProcessed(bytes);
+}
+static void serializeMany(benchmark::State &state, const char *converter_name)
+{
+	Converter *converter = benchmark::globalState().converters().byName(converter_name);
+	if (!converter || !converter->hasSerialize()){
+		while (state.keepRunning());
+		return;
+	}
+	vector<Color> colors;
+	benchmark::randomColors(color_count, colors);
+	vector<ColorObject*> color_objects;
+	for (auto &color: colors)
+		color_objects.push_back(new ColorObject("", color));
+	vector<string> result;
+	size_t bytes = 0;
+	while (state.keepRunning()){
+		result.clear();
+		converter->serialize(color_objects.data(), color_objects.size(), ConverterSerializePosition(0, color_objects.size()), result);
+		for (auto &text: result)
+			bytes += text.length();
+	}
+	for (auto color_object: color_objects)
+		color_object->release();
+	state.setItemsProcessed(state.iterations() * color_count);
+	state.setBytesProcessed(bytes);
+}
+static void deserialize(benchmark::State &state, const char *converter_name)
+{
+	Converter *converter = benchmark::globalState().converters().byName(converter_name);
+	if (!converter || !converter->hasSerialize() || !converter->hasDeserialize()){
+		while (state.keepRunning());
+		return;
+	}
+	vector<Color> colors;
+	benchmark::randomColors(color_count, colors);
+	vector<string> values;
+	for (auto &color: colors)
+		values.push_back(converter->serialize(color));
+	ColorObject *color_object = new ColorObject();
+	float quality;
+	size_t bytes = 0;
+	while (state.keepRunning()){
+		for (auto &value: values){
+			converter->deserialize(value.c_str(), color_object, quality);
+			bytes += value.length();
+		}
+	}
+	color_object->release();
+	state.setItemsProcessed(state.iterations() * color_count);
+	state.setBytesProcessed(bytes);
+}
+static void serialize_web_hex(benchmark::State &state)
+{
+	serialize(state, "color_web_hex");
+}
+static void serialize_css_hsl(benchmark::State &state)
+{
+	serialize(state, "color_css_hsl");
+}
+static void serialize_many_web_hex(benchmark::State &state)
+{
+	serializeMany(state, "color_web_hex");
+}
+static void serialize_many_css_hsl(benchmark::State &state)
+{
+	serializeMany(state, "color_css_hsl");
+}
+static void deserialize_web_hex(benchmark::State &state)
+{
+	deserialize(state, "color_web_hex");
+}
+static void deserialize_css_rgb(benchmark::State &state)
+{
+	deserialize(state, "color_css_rgb");
+}
+BENCHMARK(converter, serialize_web_hex);
+BENCHMARK(converter, serialize_css_hsl);
+BENCHMARK(converter, serialize_many_web_hex);
+BENCHMARK(converter, serialize_many_css_hsl);
+BENCHMARK(converter, deserialize_web_hex);
+BENCHMARK(converter, deserialize_css_rgb);
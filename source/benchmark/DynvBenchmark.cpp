@@ -0,0 +1,73 @@
+#include "Benchmark.h"
+#include "GlobalState.h"
+#include "DynvHelpers.h"
+#include "dynv/DynvSystem.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+static const size_t key_count = 64;
+static dynvSystem *createSystem(vector<string> &keys)
+{
+	dynvSystem *dynv = dynv_system_create(benchmark::globalState().getSettings());
+	for (size_t i = 0; i < key_count; i++)
+		keys.push_back("benchmark.group" + to_string(i % 8) + ".value" + to_string(i));
+	return dynv;
+}
+static void set_int32(benchmark::State &state)
+{
+	vector<string> keys;
+	dynvSystem *dynv = createSystem(keys);
+	int32_t value = 0;
+	while (state.keepRunning()){
+		for (auto &key: keys)
+			dynv_set_int32(dynv, key.c_str(), value++);
+	}
+	dynv_system_release(dynv);
+	state.setItemsProcessed(state.iterations() * key_count);
+}
+static void get_int32(benchmark::State &state)
+{
+	vector<string> keys;
+	dynvSystem *dynv = createSystem(keys);
+	for (auto &key: keys)
+		dynv_set_int32(dynv, key.c_str(), 1);
+	int32_t sum = 0;
+	while (state.keepRunning()){
+		for (auto &key: keys)
+			sum += dynv_get_int32_wd(dynv, key.c_str(), 0);
+	}
+	dynv_system_release(dynv);
+	state.setItemsProcessed(sum);
+}
+static void set_string(benchmark::State &state)
+{
+	vector<string> keys;
+	dynvSystem *dynv = createSystem(keys);
+	while (state.keepRunning()){
+		for (auto &key: keys)
+			dynv_set_string(dynv, key.c_str(), "benchmark");
+	}
+	dynv_system_release(dynv);
+	state.setItemsProcessed(state.iterations() * key_count);
+}
+static void get_color(benchmark::State &state)
+{
+	vector<string> keys;
+	dynvSystem *dynv = createSystem(keys);
+	Color color;
+	color_set(&color, 0.5f);
+	for (auto &key: keys)
+		dynv_set_color(dynv, key.c_str(), &color);
+	size_t found = 0;
+	while (state.keepRunning()){
+		for (auto &key: keys)
+			if (dynv_get_color_wd(dynv, key.c_str(), nullptr)) found++;
+	}
+	dynv_system_release(dynv);
+	state.setItemsProcessed(found);
+}
+BENCHMARK(dynv, set_int32);
+BENCHMARK(dynv, get_int32);
+BENCHMARK(dynv, set_string);
+BENCHMARK(dynv, get_color);
@@ -0,0 +1,128 @@
+#include "Benchmark.h"
+#include "GlobalState.h"
+#include "ImportExport.h"
+#include "Converters.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "DynvHelpers.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <vector>
+#include <string>
+using namespace std;
+
+static const size_t color_count = 1024;
+static string temporaryFilename(const char *name = "gpick-benchmark.gpa")
+{
+	gchar *filename = g_build_filename(g_get_tmp_dir(), name, nullptr);
+	string result = filename;
+	g_free(filename);
+	return result;
+}
+static ColorList *createEmptyColorList()
+{
+	dynvHandlerMap *handler_map = dynv_system_get_handler_map(benchmark::globalState().getSettings());
+	ColorList *color_list = color_list_new(handler_map);
+	dynv_handler_map_release(handler_map);
+	return color_list;
+}
+static ColorList *createColorList(size_t count = color_count)
+{
+	vector<Color> colors;
+	benchmark::randomColors(count, colors);
+	ColorList *color_list = createEmptyColorList();
+	for (size_t i = 0; i < colors.size(); i++){
+		ColorObject *color_object = color_list_add_color(color_list, &colors[i]);
+		color_object->setName("color " + to_string(i));
+	}
+	return color_list;
+}
+static void save_gpa(benchmark::State &state)
+{
+	GlobalState &gs = benchmark::globalState();
+	string filename = temporaryFilename();
+	ColorList *color_list = createColorList();
+	while (state.keepRunning()){
+		ImportExport import_export(color_list, filename.c_str(), &gs);
+		import_export.exportGPA();
+	}
+	color_list_destroy(color_list);
+	g_unlink(filename.c_str());
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static void load_gpa(benchmark::State &state)
+{
+	GlobalState &gs = benchmark::globalState();
+	string filename = temporaryFilename();
+	ColorList *color_list = createColorList();
+	ImportExport import_export(color_list, filename.c_str(), &gs);
+	import_export.exportGPA();
+	color_list_destroy(color_list);
+	while (state.keepRunning()){
+		state.pauseTiming();
+		ColorList *loaded_color_list = createEmptyColorList();
+		state.resumeTiming();
+		ImportExport import_export(loaded_color_list, filename.c_str(), &gs);
+		import_export.importGPA();
+		state.pauseTiming();
+		color_list_destroy(loaded_color_list);
+		state.resumeTiming();
+	}
+	g_unlink(filename.c_str());
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static const size_t txt_color_count = 1000000;
+static void save_txt(benchmark::State &state, const char *converter_name)
+{
+	GlobalState &gs = benchmark::globalState();
+	string filename = temporaryFilename("gpick-benchmark.txt");
+	ColorList *color_list = createColorList(txt_color_count);
+	while (state.keepRunning()){
+		ImportExport import_export(color_list, filename.c_str(), &gs);
+		import_export.setConverter(gs.converters().byName(converter_name));
+		import_export.exportTXT();
+	}
+	color_list_destroy(color_list);
+	g_unlink(filename.c_str());
+	state.setItemsProcessed(state.iterations() * txt_color_count);
+}
+/** Converter with serializeMany function. */
+static void save_txt_web_hex(benchmark::State &state)
+{
+	save_txt(state, "color_web_hex");
+}
+/** Converter without serializeMany function, serialize function is called in a loop inside one Lua call. */
+static void save_txt_css_rgb(benchmark::State &state)
+{
+	save_txt(state, "color_css_rgb");
+}
+/** Every line is deserialized by all paste converters, large files are split between worker Lua states. */
+static void load_txt(benchmark::State &state)
+{
+	GlobalState &gs = benchmark::globalState();
+	const size_t count = 100000;
+	string filename = temporaryFilename("gpick-benchmark.txt");
+	ColorList *color_list = createColorList(count);
+	ImportExport import_export(color_list, filename.c_str(), &gs);
+	import_export.setConverter(gs.converters().byName("color_web_hex"));
+	import_export.exportTXT();
+	color_list_destroy(color_list);
+	while (state.keepRunning()){
+		state.pauseTiming();
+		ColorList *loaded_color_list = createEmptyColorList();
+		state.resumeTiming();
+		ImportExport import_export(loaded_color_list, filename.c_str(), &gs);
+		import_export.setConverters(&gs.converters());
+		import_export.importTXT();
+		state.pauseTiming();
+		color_list_destroy(loaded_color_list);
+		state.resumeTiming();
+	}
+	g_unlink(filename.c_str());
+	state.setItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(import_export, save_gpa);
+BENCHMARK(import_export, load_gpa);
+BENCHMARK(import_export, save_txt_web_hex);
+BENCHMARK(import_export, save_txt_css_rgb);
+BENCHMARK(import_export, load_txt);
@@ -0,0 +1,63 @@
+#include "Benchmark.h"
+#include "Paths.h"
+#include "lua/Script.h"
+#include "lua/BytecodeCache.h"
+#include <glib/gstdio.h>
+#include <string>
+#include <vector>
+extern "C"{
+#include <lualib.h>
+#include <lauxlib.h>
+}
+using namespace std;
+
+/** Scripts loaded during startup, including --pick mode. */
+static const char *startup_scripts[] = {"init.lua", "helpers.lua", "options.lua", "converters.lua"};
+static const size_t startup_script_count = sizeof(startup_scripts) / sizeof(startup_scripts[0]);
+static vector<string> startupScriptFilenames()
+{
+	vector<string> result;
+	for (size_t i = 0; i < startup_script_count; i++){
+		gchar *filename = build_filename(startup_scripts[i]);
+		result.push_back(filename);
+		g_free(filename);
+	}
+	return result;
+}
+/** Compile startup scripts from source text, as it is done without bytecode cache. */
+static void load_source(benchmark::State &state)
+{
+	vector<string> filenames = startupScriptFilenames();
+	lua::Script script;
+	lua_State *L = script;
+	while (state.keepRunning()){
+		for (auto &filename: filenames){
+			luaL_loadfile(L, filename.c_str());
+			lua_pop(L, 1);
+		}
+	}
+	state.setItemsProcessed(state.iterations() * filenames.size());
+}
+/** Load startup scripts from bytecode cache. Cache is filled before measurement. */
+static void load_cached(benchmark::State &state)
+{
+	vector<string> filenames = startupScriptFilenames();
+	gchar *cache_path = g_build_filename(g_get_tmp_dir(), "gpick-benchmark-lua", nullptr);
+	g_mkdir_with_parents(cache_path, 0700);
+	lua::Script script;
+	lua_State *L = script;
+	for (auto &filename: filenames){
+		lua::loadCachedFile(L, filename.c_str(), cache_path);
+		lua_pop(L, 1);
+	}
+	while (state.keepRunning()){
+		for (auto &filename: filenames){
+			lua::loadCachedFile(L, filename.c_str(), cache_path);
+			lua_pop(L, 1);
+		}
+	}
+	g_free(cache_path);
+	state.setItemsProcessed(state.iterations() * filenames.size());
+}
+BENCHMARK(lua, load_source);
+BENCHMARK(lua, load_cached);
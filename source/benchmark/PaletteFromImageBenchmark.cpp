@@ -0,0 +1,44 @@
+#include "Benchmark.h"
+#include "tools/PaletteFromImage.h"
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib/gstdio.h>
+#include <vector>
+#include <string>
+using namespace std;
+
+static const int image_size = 512;
+static string createImage()
+{
+	gchar *filename = g_build_filename(g_get_tmp_dir(), "gpick-benchmark.png", nullptr);
+	string result = filename;
+	g_free(filename);
+	GdkPixbuf *pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, image_size, image_size);
+	vector<Color> colors;
+	benchmark::randomColors(image_size * image_size, colors);
+	guchar *pixels = gdk_pixbuf_get_pixels(pixbuf);
+	int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+	for (int y = 0; y < image_size; y++){
+		guchar *row = pixels + y * rowstride;
+		for (int x = 0; x < image_size; x++){
+			const Color &color = colors[y * image_size + x];
+			row[x * 3 + 0] = static_cast<guchar>((x * 255 / image_size + color.rgb.red * 32) / 1.125);
+			row[x * 3 + 1] = static_cast<guchar>((y * 255 / image_size + color.rgb.green * 32) / 1.125);
+			row[x * 3 + 2] = static_cast<guchar>(color.rgb.blue * 255);
+		}
+	}
+	gdk_pixbuf_save(pixbuf, result.c_str(), "png", nullptr, nullptr);
+	g_object_unref(pixbuf);
+	return result;
+}
+static void extract_16_colors(benchmark::State &state)
+{
+	string filename = createImage();
+	vector<Color> colors;
+	while (state.keepRunning()){
+		colors.clear();
+		tools_palette_from_image_extract(filename.c_str(), 16, colors);
+	}
+	g_unlink(filename.c_str());
+	state.setItemsProcessed(state.iterations() * image_size * image_size);
+}
+BENCHMARK(octree_quantization, extract_16_colors);
@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+#include "parser/TextFile.h"
+#include "Color.h"
+#include <string>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+using namespace std;
+
+struct TextFile: public text_file_parser::TextFile
+{
+	istream *m_stream;
+	size_t m_count;
+	TextFile(istream *stream = nullptr):
+		m_stream(stream),
+		m_count(0)
+	{
+	}
+	virtual ~TextFile()
+	{
+	}
+	virtual void outOfMemory()
+	{
+	}
+	virtual void syntaxError(size_t start_line, size_t start_column, size_t end_line, size_t end_colunn)
+	{
+	}
+	virtual size_t read(char *buffer, size_t length)
+	{
+		if (m_stream == nullptr)
+			return 0;
+		m_stream->read(buffer, length);
+		return m_stream->gcount();
+	}
+	virtual void addColor(const Color &color)
+	{
+		m_count++;
+	}
+	virtual void addColors(const Color *colors, size_t count)
+	{
+		m_count += count;
+	}
+};
+static const string &buildText()
+{
+	static string text;
+	if (!text.empty())
+		return text;
+	vector<Color> colors;
+	benchmark::randomColors(32768, colors);
+	stringstream stream;
+	for (size_t i = 0; i < colors.size(); i++){
+		int r = static_cast<int>(colors[i].rgb.red * 255), g = static_cast<int>(colors[i].rgb.green * 255), b = static_cast<int>(colors[i].rgb.blue * 255);
+		switch (i % 4){
+			case 0:
+				stream << "color: #" << hex << (r << 16 | g << 8 | b) << dec << ";\n";
+				break;
+			case 1:
+				stream << "background: rgb(" << r << ", " << g << ", " << b << ");\n";
+				break;
+			case 2:
+				stream << "/* comment */ rgba(" << r << ", " << g << ", " << b << ", 0.5)\n";
+				break;
+			case 3:
+				stream << colors[i].rgb.red << " " << colors[i].rgb.green << " " << colors[i].rgb.blue << "\n";
+				break;
+		}
+	}
+	text = stream.str();
+	return text;
+}
+static void parse(benchmark::State &state, size_t threads)
+{
+	const string &text = buildText();
+	text_file_parser::Configuration configuration;
+	while (state.keepRunning()){
+		TextFile text_file;
+		text_file.parse(configuration, text.c_str(), text.length(), threads);
+	}
+	state.setBytesProcessed(state.iterations() * text.length());
+}
+static void parse_stream(benchmark::State &state)
+{
+	const string &text = buildText();
+	text_file_parser::Configuration configuration;
+	while (state.keepRunning()){
+		istringstream stream(text);
+		TextFile text_file(&stream);
+		text_file.parse(configuration);
+	}
+	state.setBytesProcessed(state.iterations() * text.length());
+}
+static void parse_single_thread(benchmark::State &state)
+{
+	parse(state, 1);
+}
+static void parse_multiple_threads(benchmark::State &state)
+{
+	parse(state, max(thread::hardware_concurrency(), 1u));
+}
+BENCHMARK(text_file_parser, parse_stream);
+BENCHMARK(text_file_parser, parse_single_thread);
+BENCHMARK(text_file_parser, parse_multiple_threads);
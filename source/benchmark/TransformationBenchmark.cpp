@@ -0,0 +1,43 @@
+#include "Benchmark.h"
+#include "Color.h"
+#include "transformation/Chain.h"
+#include "transformation/GammaModification.h"
+#include "transformation/Quantization.h"
+#include <boost/shared_ptr.hpp>
+#include <vector>
+using namespace std;
+using namespace transformation;
+
+static const size_t color_count = 4096;
+static void apply(benchmark::State &state, Chain &chain)
+{
+	color_init();
+	vector<Color> input, output(color_count);
+	benchmark::randomColors(color_count, input);
+	while (state.keepRunning()){
+		chain.apply(&input.front(), &output.front(), color_count);
+	}
+	state.setItemsProcessed(state.iterations() * color_count);
+}
+static void gamma_modification(benchmark::State &state)
+{
+	Chain chain;
+	chain.add(boost::shared_ptr<Transformation>(new GammaModification(0.3f)));
+	apply(state, chain);
+}
+static void quantization(benchmark::State &state)
+{
+	Chain chain;
+	chain.add(boost::shared_ptr<Transformation>(new Quantization(16)));
+	apply(state, chain);
+}
+static void gamma_modification_quantization(benchmark::State &state)
+{
+	Chain chain;
+	chain.add(boost::shared_ptr<Transformation>(new GammaModification(2.2f)));
+	chain.add(boost::shared_ptr<Transformation>(new Quantization(16)));
+	apply(state, chain);
+}
+BENCHMARK(transformation, gamma_modification);
+BENCHMARK(transformation, quantization);
+BENCHMARK(transformation, gamma_modification_quantization);
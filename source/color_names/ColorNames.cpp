@@ -19,6 +19,8 @@
 #include "ColorNames.h"
 #include "../Color.h"
 #include "../Paths.h"
+#include "../Tracing.h"
+#include "../ColorDistance.h"
 #include <string.h>
 #include <sstream>
 #include <fstream>
@@ -33,25 +35,48 @@ struct ColorNameEntry
 };
 struct ColorEntry
 {
-	Color color;
+	Color color; /**< Color in Lab color space, used to find grid cell */
 	Color original_color;
 	ColorNameEntry* name;
 };
+struct ColorCell
+{
+	std::vector<ColorEntry*> entries;
+	std::vector<Color> colors; /**< Entry colors prepared for distance metric, stored contiguously for batch distance kernel */
+};
 const int SpaceDivisions = 8;
 struct ColorNames
 {
 	std::list<ColorNameEntry*> names;
-	std::vector<ColorEntry*> colors[SpaceDivisions][SpaceDivisions][SpaceDivisions];
-	void (*color_space_convert)(const Color* a, Color* b);
-	float (*color_space_distance)(const Color* a, const Color* b);
+	ColorCell colors[SpaceDivisions][SpaceDivisions][SpaceDivisions];
+	const ColorDistance *distance;
 };
 ColorNames* color_names_new()
 {
 	ColorNames* color_names = new ColorNames;
-	color_names->color_space_convert = color_rgb_to_lab_d50;
-	color_names->color_space_distance = color_distance_lch;
+	color_names->distance = &color_distance_cie94_metric;
 	return color_names;
 }
+static void color_names_prepare(ColorNames *color_names, const ColorEntry *color_entry, Color &result)
+{
+	if (color_names->distance->lab_input)
+		color_names->distance->prepare(&color_entry->color, &result);
+	else
+		color_names->distance->prepare(&color_entry->original_color, &result);
+}
+void color_names_set_distance(ColorNames *color_names, const ColorDistance &distance)
+{
+	color_names->distance = &distance;
+	for (int x = 0; x < SpaceDivisions; x++){
+		for (int y = 0; y < SpaceDivisions; y++){
+			for (int z = 0; z < SpaceDivisions; z++){
+				ColorCell &cell = color_names->colors[x][y][z];
+				for (size_t i = 0; i < cell.entries.size(); i++)
+					color_names_prepare(color_names, cell.entries[i], cell.colors[i]);
+			}
+		}
+	}
+}
 void color_names_clear(ColorNames *color_names)
 {
 	for (auto i = color_names->names.begin(); i != color_names->names.end(); i++){
@@ -61,10 +86,11 @@ void color_names_clear(ColorNames *color_names)
 	for (int x = 0; x < SpaceDivisions; x++){
 		for (int y = 0; y < SpaceDivisions; y++){
 			for (int z = 0; z < SpaceDivisions; z++){
-				for (auto i = color_names->colors[x][y][z].begin(); i != color_names->colors[x][y][z].end(); ++i){
+				for (auto i = color_names->colors[x][y][z].entries.begin(); i != color_names->colors[x][y][z].entries.end(); ++i){
 					delete *i;
 				}
-				color_names->colors[x][y][z].clear();
+				color_names->colors[x][y][z].entries.clear();
+				color_names->colors[x][y][z].colors.clear();
 			}
 		}
 	}
@@ -96,7 +122,7 @@ void color_names_get_color_xyz(ColorNames* color_names, Color* c, int* x1, int*
 	*y2 = clamp_int(int((c->xyz.y + 100) / 200 * SpaceDivisions + 0.5), 0, SpaceDivisions - 1);
 	*z2 = clamp_int(int((c->xyz.z + 100) / 200 * SpaceDivisions + 0.5), 0, SpaceDivisions - 1);
 }
-static vector<ColorEntry*>* color_names_get_color_list(ColorNames* color_names, Color* c)
+static ColorCell* color_names_get_color_list(ColorNames* color_names, Color* c)
 {
 	int x,y,z;
 	x = clamp_int(int(c->xyz.x / 100 * SpaceDivisions), 0, SpaceDivisions - 1);
@@ -135,9 +161,12 @@ int color_names_load_from_file(ColorNames* color_names, const char* filename)
 				color_names->names.push_back(name_entry);
 				ColorEntry* color_entry = new ColorEntry;
 				color_entry->name = name_entry;
-				color_names->color_space_convert(&color, &color_entry->color);
+				color_rgb_to_lab_d50(&color, &color_entry->color);
 				color_copy(&color, &color_entry->original_color);
-				color_names_get_color_list(color_names, &color_entry->color)->push_back(color_entry);
+				ColorCell *cell = color_names_get_color_list(color_names, &color_entry->color);
+				cell->entries.push_back(color_entry);
+				cell->colors.emplace_back();
+				color_names_prepare(color_names, color_entry, cell->colors.back());
 			}
 		}
 		file.close();
@@ -150,10 +179,13 @@ void color_names_destroy(ColorNames* color_names)
 	color_names_clear(color_names);
 	delete color_names;
 }
+/** Call on_color with every color entry near color and squared distance to it. */
 static void color_names_iterate(ColorNames* color_names, const Color* color, function<bool(ColorEntry*, float)> on_color, function<bool()> on_expansion)
 {
-	Color c1;
-	color_names->color_space_convert(color, &c1);
+	Color c1, query;
+	color_rgb_to_lab_d50(color, &c1);
+	color_names->distance->prepare(color_names->distance->lab_input ? &c1 : color, &query);
+	vector<float> distances;
 	int x1, y1, z1, x2, y2, z2;
 	color_names_get_color_xyz(color_names, &c1, &x1, &y1, &z1, &x2, &y2, &z2);
 	char skip_mask[SpaceDivisions][SpaceDivisions][SpaceDivisions];
@@ -171,9 +203,11 @@ static void color_names_iterate(ColorNames* color_names, const Color* color, fun
 				for (int z_i = z_start; z_i <= z_end; ++z_i){
 					if (skip_mask[x_i][y_i][z_i]) continue; // skip checked items
 					skip_mask[x_i][y_i][z_i] = 1;
-					for (auto i = color_names->colors[x_i][y_i][z_i].begin(); i != color_names->colors[x_i][y_i][z_i].end(); ++i){
-						float delta = color_names->color_space_distance(&(*i)->color, &c1);
-						if (!on_color(*i, delta)) return;
+					ColorCell &cell = color_names->colors[x_i][y_i][z_i];
+					distances.resize(cell.colors.size());
+					color_names->distance->distances(query, cell.colors.data(), cell.colors.size(), distances.data());
+					for (size_t i = 0; i < cell.entries.size(); i++){
+						if (!on_color(cell.entries[i], distances[i])) return;
 					}
 				}
 			}
@@ -183,7 +217,8 @@ static void color_names_iterate(ColorNames* color_names, const Color* color, fun
 }
 string color_names_get(ColorNames* color_names, const Color* color, bool imprecision_postfix)
 {
-	float result_delta = 1e5;
+	TRACE_SCOPE("color_names_get");
+	float result_delta = 1e5f * 1e5f;
 	ColorEntry* found_color_entry = nullptr;
 	color_names_iterate(color_names, color, [&](ColorEntry *color_entry, float delta){
 		if (delta < result_delta){
@@ -197,12 +232,12 @@ string color_names_get(ColorNames* color_names, const Color* color, bool impreci
 	if (found_color_entry){
 		stringstream s;
 		s << found_color_entry->name->name;
-		if (imprecision_postfix) if (result_delta > 0.1) s << " ~";
+		if (imprecision_postfix) if (result_delta > 0.1 * 0.1) s << " ~";
 		return s.str();
 	}
 	return string("");
 }
-void color_names_load(ColorNames *color_names, dynvSystem *params)
+void color_names_get_dictionary_filenames(dynvSystem *params, std::vector<std::string> &filenames)
 {
 	uint32_t dictionary_count = 0;
 	struct dynvSystem** dictionaries = dynv_get_dynv_array_wd(params, "color_dictionaries.items", nullptr, 0, &dictionary_count);
@@ -215,11 +250,11 @@ void color_names_load(ColorNames *color_names, dynvSystem *params)
 				if (built_in){
 					if (path == "built_in_0"){
 						gchar *tmp;
-						color_names_load_from_file(color_names, tmp = build_filename("color_dictionary_0.txt"));
+						filenames.push_back(tmp = build_filename("color_dictionary_0.txt"));
 						g_free(tmp);
 					}
 				}else{
-					color_names_load_from_file(color_names, path.c_str());
+					filenames.push_back(path);
 				}
 			}
 			dynv_system_release(dictionaries[i]);
@@ -227,6 +262,13 @@ void color_names_load(ColorNames *color_names, dynvSystem *params)
 		if (dictionaries) delete [] dictionaries;
 	}
 }
+void color_names_load(ColorNames *color_names, dynvSystem *params)
+{
+	vector<string> filenames;
+	color_names_get_dictionary_filenames(params, filenames);
+	for (auto &filename: filenames)
+		color_names_load_from_file(color_names, filename.c_str());
+}
 void color_names_find_nearest(ColorNames *color_names, const Color &color, size_t count, std::vector<std::pair<const char*, Color>> &colors)
 {
 	multimap<float, ColorEntry*> found_colors;
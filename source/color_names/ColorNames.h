@@ -23,9 +23,23 @@
 #include <string>
 #include <vector>
 struct ColorNames;
+struct ColorDistance;
 ColorNames *color_names_new();
+/**
+ * Set color difference metric used to find color names. Default metric is CIE94.
+ * @param[in] color_names Color names.
+ * @param[in] distance Color difference metric.
+ */
+void color_names_set_distance(ColorNames *color_names, const ColorDistance &distance);
 void color_names_clear(ColorNames *color_names);
 void color_names_load(ColorNames *color_names, dynvSystem *params);
+/**
+ * Get file names of all enabled color dictionaries.
+ * Loading color dictionaries from these files with color_names_load_from_file does not access settings, so it can be done in a worker thread.
+ * @param[in] params Color dictionary settings.
+ * @param[out] filenames Color dictionary file names.
+ */
+void color_names_get_dictionary_filenames(dynvSystem *params, std::vector<std::string> &filenames);
 int color_names_load_from_file(ColorNames *color_names, const char *filename);
 void color_names_destroy(ColorNames *color_names);
 std::string color_names_get(ColorNames *color_names, const Color *color, bool imprecision_postfix);
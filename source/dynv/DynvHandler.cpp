@@ -64,8 +64,9 @@ struct dynvHandlerMap* dynv_handler_map_create(){
 }
 
 int dynv_handler_map_release(struct dynvHandlerMap* handler_map){
-	if (handler_map->refcnt){
-		handler_map->refcnt--;
+	uint32_t refcnt = handler_map->refcnt;
+	while (refcnt && !handler_map->refcnt.compare_exchange_weak(refcnt, refcnt - 1));
+	if (refcnt){
 		return -1;
 	}else{
 		dynvHandlerMap::HandlerMap::iterator i;
@@ -23,6 +23,7 @@
 #include <vector>
 #include <ostream>
 #include <istream>
+#include <atomic>
 
 #include <stdint.h>
 #ifndef _MSC_VER
@@ -60,7 +61,7 @@ struct dynvHandlerMap{
 	};
 	typedef std::map<const char*, struct dynvHandler*, dynvKeyCompare> HandlerMap;
 	typedef std::vector<struct dynvHandler*> HandlerVec;
-	uint32_t refcnt;
+	std::atomic<uint32_t> refcnt; /**< Handler map is shared by all dynv systems, so references can be taken from multiple threads. */
 	HandlerMap handlers;
 };
 
@@ -59,7 +59,7 @@ static int dynv_var_dynv_get(struct dynvVariable* variable, void** value, bool *
 static int serialize_xml(struct dynvVariable* variable, ostream& out)
 {
 	if (variable->ptr_value){
-		out << endl;
+		out << '\n';
 		dynv_xml_serialize((struct dynvSystem*)variable->ptr_value, out);
 	}
 	return 0;
@@ -23,7 +23,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <iostream>
-#include <sstream>
 #include <stack>
 using namespace std;
 
@@ -42,11 +41,11 @@ int dynv_xml_serialize(struct dynvSystem* dynv_system, ostream& out)
 					out << "</li>";
 					v = v->next;
 				}
-				out << "</" << variable->name << ">" << endl;
+				out << "</" << variable->name << ">\n";
 			}else{
 				out << "<" << variable->name << " type=\"" << variable->handler->name << "\">";
 				variable->handler->serialize_xml(variable, out);
-				out << "</" << variable->name << ">" << endl;
+				out << "</" << variable->name << ">\n";
 			}
 		}
 	}
@@ -56,14 +55,12 @@ int dynv_xml_serialize(struct dynvSystem* dynv_system, ostream& out)
 struct XmlEntity
 {
 	public:
-		stringstream entity_data;
 		dynvVariable *variable;
 		dynvSystem* dynv;
 		dynvHandler *list_handler;
 		bool list_expected;
 		bool first_item;
 		XmlEntity(dynvVariable *_variable, dynvSystem* _dynv, bool _list_expected):
-			entity_data(stringstream::out),
 			variable(_variable),
 			dynv(_dynv),
 			list_expected(_list_expected)
@@ -78,9 +75,11 @@ struct XmlCtx
 		bool root_found;
 		stack<XmlEntity*> entity;
 		dynvHandlerMap *handler_map;
+		string entity_data; //character data of the innermost element, reused for all elements
 		XmlCtx(){
 			root_found = false;
 			handler_map = 0;
+			entity_data.reserve(256);
 		};
 		~XmlCtx(){
 			if (handler_map) dynv_handler_map_release(handler_map);
@@ -102,6 +101,7 @@ static char* get_attribute(const XML_Char **atts, const char *attribute)
 }
 static void start_element_handler(XmlCtx *xml, const XML_Char *name, const XML_Char **atts)
 {
+	xml->entity_data.clear();
 	if (xml->root_found){
 		XmlEntity *entity = xml->entity.top();
 		if (!entity) return;
@@ -191,20 +191,20 @@ static void end_element_handler(XmlCtx *xml, const XML_Char *name)
 				}
 			}else if (entity->variable){
 				if (entity->variable->handler->deserialize_xml){
-					string value = entity->entity_data.str();
-					entity->variable->handler->deserialize_xml(entity->variable, value.c_str());
+					entity->variable->handler->deserialize_xml(entity->variable, xml->entity_data.c_str());
 				}
 			}
 			delete entity;
 		}
 		xml->entity.pop();
 	}
+	xml->entity_data.clear();
 }
 static void character_data_handler(XmlCtx *xml, const XML_Char *s, int len)
 {
 	XmlEntity *entity = xml->entity.top();
 	if (entity){
-		entity->entity_data.write(s, len);
+		xml->entity_data.append(s, len);
 	}
 }
 int dynv_xml_deserialize(struct dynvSystem* dynv_system, istream& in)
@@ -216,9 +216,10 @@ int dynv_xml_deserialize(struct dynvSystem* dynv_system, istream& in)
 	ctx.entity.push(new XmlEntity(0, dynv_system, false));
 	ctx.handler_map = dynv_system_get_handler_map(dynv_system);
 	XML_SetUserData(p, &ctx);
+	const size_t buffer_size = 65536;
 	for (;;){
-		void *buffer = XML_GetBuffer(p, 4096);
-		in.read((char*)buffer, 4096);
+		void *buffer = XML_GetBuffer(p, buffer_size);
+		in.read((char*)buffer, buffer_size);
 		size_t bytes_read = in.gcount();
 		if (!XML_ParseBuffer(p, bytes_read, bytes_read == 0)) {
 
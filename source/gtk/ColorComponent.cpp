@@ -21,6 +21,7 @@
 #include "../Color.h"
 #include "../MathUtil.h"
 #include "../Paths.h"
+#include "../Tracing.h"
 #include <math.h>
 #include <string.h>
 #include <vector>
@@ -47,6 +48,7 @@ enum
 	LAST_SIGNAL
 };
 static const int MaxNumberOfComponents = 4;
+static const int GradientSteps = 100;
 static guint signals[LAST_SIGNAL] = {};
 struct GtkColorComponentPrivate
 {
@@ -66,6 +68,14 @@ struct GtkColorComponentPrivate
 	gchar *text[MaxNumberOfComponents];
 	double range[MaxNumberOfComponents];
 	double offset[MaxNumberOfComponents];
+	cairo_surface_t *strip_surface;
+	bool strip_valid[MaxNumberOfComponents];
+	Color strip_color[MaxNumberOfComponents];
+	bool out_of_gamut[MaxNumberOfComponents][GradientSteps + 1];
+	int out_of_gamut_points[MaxNumberOfComponents];
+	uint32_t frame_count;
+	gint64 last_frame_time;
+	gint64 total_frame_time;
 #if GTK_MAJOR_VERSION >= 3
 	GdkDevice *pointer_grab;
 #endif
@@ -122,6 +132,8 @@ static void finalize(GObject *color_obj)
 		cairo_surface_destroy(ns->pattern_surface);
 	if (ns->pattern)
 		cairo_pattern_destroy(ns->pattern);
+	if (ns->strip_surface)
+		cairo_surface_destroy(ns->strip_surface);
 	gpointer parent_class = g_type_class_peek_parent(G_OBJECT_CLASS(GTK_COLOR_COMPONENT_GET_CLASS(color_obj)));
 	G_OBJECT_CLASS(parent_class)->finalize(color_obj);
 }
@@ -140,12 +152,20 @@ GtkWidget *gtk_color_component_new(GtkColorComponentComp component)
 	ns->lab_illuminant = REFERENCE_ILLUMINANT_D50;
 	ns->lab_observer= REFERENCE_OBSERVER_2;
 	ns->out_of_gamut_mask = false;
+	ns->strip_surface = nullptr;
+	ns->frame_count = 0;
+	ns->last_frame_time = 0;
+	ns->total_frame_time = 0;
 #if GTK_MAJOR_VERSION >= 3
 	ns->pointer_grab = nullptr;
 #endif
 	for (int i = 0; i != sizeof(ns->text) / sizeof(gchar*); i++){
 		ns->text[i] = 0;
 	}
+	for (int i = 0; i != MaxNumberOfComponents; i++){
+		ns->strip_valid[i] = false;
+		ns->out_of_gamut_points[i] = 0;
+	}
 	for (int i = 0; i != sizeof(ns->label) / sizeof(const char*[2]); i++){
 		ns->label[i][0] = 0;
 		ns->label[i][1] = 0;
@@ -295,238 +315,101 @@ static int get_x_offset(GtkWidget *widget)
 	return widget->allocation.width - widget->style->xthickness * 2 - 240;
 #endif
 }
-static gboolean draw(GtkWidget *widget, cairo_t *cr)
+static void get_component_rgb(GtkColorComponentPrivate *ns, Color *color, Color *rgb, matrix3x3 *adaptation_matrix)
 {
-	GtkColorComponentPrivate *ns = GET_PRIVATE(widget);
-	Color c[MaxNumberOfComponents];
-	double pointer_pos[MaxNumberOfComponents];
-	float steps;
-	int i, j;
-	for (int i = 0; i < ns->n_components; ++i){
-		pointer_pos[i] = (ns->color.ma[i] - ns->offset[i]) / ns->range[i];
-	}
-	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 200, ns->n_components * 16);
-	unsigned char *data = cairo_image_surface_get_data(surface);
-	int stride = cairo_image_surface_get_stride(surface);
-	int surface_width = cairo_image_surface_get_width(surface);
-	unsigned char *col_ptr;
-	Color *rgb_points = new Color[ns->n_components * 200];
-	double int_part;
-	matrix3x3 adaptation_matrix;
-	vector<vector<bool> > out_of_gamut(MaxNumberOfComponents, vector<bool>(false, 1));
-	switch (ns->component) {
+	switch (ns->component){
 		case GtkColorComponentComp::rgb:
-			steps = 1;
-			for (i = 0; i < 3; ++i){
-				color_copy(&ns->color, &c[i]);
-			}
-			for (i = 0; i < surface_width; ++i){
-				c[0].rgb.red = c[1].rgb.green = c[2].rgb.blue = (float)i / (float)(surface_width - 1);
-				col_ptr = data + i * 4;
-				for (int y = 0; y < ns->n_components * 16; ++y){
-					if ((y & 0x0f) != 0x0f){
-						col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-						col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-						col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-						col_ptr[3] = 0xff;
-					}else{
-						col_ptr[0] = 0x00;
-						col_ptr[1] = 0x00;
-						col_ptr[2] = 0x00;
-						col_ptr[3] = 0x00;
-					}
-					col_ptr += stride;
-				}
-			}
+			color_copy(color, rgb);
 			break;
 		case GtkColorComponentComp::hsv:
-			steps = 100;
-			for (i = 0; i < 3; ++i){
-				color_copy(&ns->color, &c[i]);
-			}
-			for (i = 0; i <= steps; ++i){
-				c[0].hsv.hue = c[1].hsv.saturation = c[2].hsv.value = i / steps;
-				for (j = 0; j < 3; ++j){
-					color_hsv_to_rgb(&c[j], &rgb_points[j * (int(steps) + 1) + i]);
-				}
-			}
-			for (i = 0; i < surface_width; ++i){
-				float position = modf(i * steps / surface_width, &int_part);
-				int index = i * int(steps) / surface_width;
-				interpolate_colors(&rgb_points[0 * (int(steps) + 1) + index], &rgb_points[0 * (int(steps) + 1) + index + 1], position, &c[0]);
-				interpolate_colors(&rgb_points[1 * (int(steps) + 1) + index], &rgb_points[1 * (int(steps) + 1) + index + 1], position, &c[1]);
-				interpolate_colors(&rgb_points[2 * (int(steps) + 1) + index], &rgb_points[2 * (int(steps) + 1) + index + 1], position, &c[2]);
-				col_ptr = data + i * 4;
-				for (int y = 0; y < ns->n_components * 16; ++y){
-					if ((y & 0x0f) != 0x0f){
-						col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-						col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-						col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-						col_ptr[3] = 0xff;
-					}else{
-						col_ptr[0] = 0x00;
-						col_ptr[1] = 0x00;
-						col_ptr[2] = 0x00;
-						col_ptr[3] = 0x00;
-					}
-					col_ptr += stride;
-				}
-			}
+			color_hsv_to_rgb(color, rgb);
 			break;
 		case GtkColorComponentComp::hsl:
-			steps = 100;
-			for (i = 0; i < 3; ++i){
-				color_copy(&ns->color, &c[i]);
-			}
-			for (i = 0; i <= steps; ++i){
-				c[0].hsl.hue = c[1].hsl.saturation = c[2].hsl.lightness = i / steps;
-				for (j = 0; j < 3; ++j){
-					color_hsl_to_rgb(&c[j], &rgb_points[j * (int(steps) + 1) + i]);
-				}
-			}
-			for (i = 0; i < surface_width; ++i){
-				float position = modf(i * steps / surface_width, &int_part);
-				int index = i * int(steps) / surface_width;
-				interpolate_colors(&rgb_points[0 * (int(steps) + 1) + index], &rgb_points[0 * (int(steps) + 1) + index + 1], position, &c[0]);
-				interpolate_colors(&rgb_points[1 * (int(steps) + 1) + index], &rgb_points[1 * (int(steps) + 1) + index + 1], position, &c[1]);
-				interpolate_colors(&rgb_points[2 * (int(steps) + 1) + index], &rgb_points[2 * (int(steps) + 1) + index + 1], position, &c[2]);
-				col_ptr = data + i * 4;
-				for (int y = 0; y < ns->n_components * 16; ++y){
-					if ((y & 0x0f) != 0x0f){
-						col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-						col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-						col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-						col_ptr[3] = 0xff;
-					}else{
-						col_ptr[0] = 0x00;
-						col_ptr[1] = 0x00;
-						col_ptr[2] = 0x00;
-						col_ptr[3] = 0x00;
-					}
-					col_ptr += stride;
-				}
-			}
+			color_hsl_to_rgb(color, rgb);
 			break;
 		case GtkColorComponentComp::cmyk:
-			steps = 100;
-			for (i = 0; i < 4; ++i){
-				color_copy(&ns->color, &c[i]);
-			}
-			for (i = 0; i <= steps; ++i){
-				c[0].cmyk.c = c[1].cmyk.m = c[2].cmyk.y = c[3].cmyk.k = i / steps;
-				for (j = 0; j < 4; ++j){
-					color_cmyk_to_rgb(&c[j], &rgb_points[j * (int(steps) + 1) + i]);
-				}
-			}
-			for (i = 0; i < surface_width; ++i){
-				float position = modf(i * steps / surface_width, &int_part);
-				int index = i * int(steps) / surface_width;
-				interpolate_colors(&rgb_points[0 * (int(steps) + 1) + index], &rgb_points[0 * (int(steps) + 1) + index + 1], position, &c[0]);
-				interpolate_colors(&rgb_points[1 * (int(steps) + 1) + index], &rgb_points[1 * (int(steps) + 1) + index + 1], position, &c[1]);
-				interpolate_colors(&rgb_points[2 * (int(steps) + 1) + index], &rgb_points[2 * (int(steps) + 1) + index + 1], position, &c[2]);
-				interpolate_colors(&rgb_points[3 * (int(steps) + 1) + index], &rgb_points[3 * (int(steps) + 1) + index + 1], position, &c[3]);
-				col_ptr = data + i * 4;
-				for (int y = 0; y < ns->n_components * 16; ++y){
-					if ((y & 0x0f) != 0x0f){
-						col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-						col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-						col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-						col_ptr[3] = 0xff;
-					}else{
-						col_ptr[0] = 0x00;
-						col_ptr[1] = 0x00;
-						col_ptr[2] = 0x00;
-						col_ptr[3] = 0x00;
-					}
-					col_ptr += stride;
-				}
-			}
+			color_cmyk_to_rgb(color, rgb);
 			break;
 		case GtkColorComponentComp::lab:
-			steps = 100;
-			color_get_chromatic_adaptation_matrix(color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_reference(REFERENCE_ILLUMINANT_D65, REFERENCE_OBSERVER_2), &adaptation_matrix);
-			for (j = 0; j < 3; ++j){
-				color_copy(&ns->color, &c[j]);
-				out_of_gamut[j] = vector<bool>(steps + 1, false);
-				for (i = 0; i <= steps; ++i){
-					c[j].ma[j] = (i / steps) * ns->range[j] + ns->offset[j];
-					color_lab_to_rgb(&c[j], &rgb_points[j * (int(steps) + 1) + i], color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_inverted_sRGB_transformation_matrix(), &adaptation_matrix);
-					if (color_is_rgb_out_of_gamut(&rgb_points[j * (int(steps) + 1) + i])){
-						out_of_gamut[j][i] = true;
-					}
-					color_rgb_normalize(&rgb_points[j * (int(steps) + 1) + i]);
-				}
-			}
-			for (i = 0; i < surface_width; ++i){
-				float position = modf(i * steps / surface_width, &int_part);
-				int index = i * int(steps) / surface_width;
-				interpolate_colors(&rgb_points[0 * (int(steps) + 1) + index], &rgb_points[0 * (int(steps) + 1) + index + 1], position, &c[0]);
-				interpolate_colors(&rgb_points[1 * (int(steps) + 1) + index], &rgb_points[1 * (int(steps) + 1) + index + 1], position, &c[1]);
-				interpolate_colors(&rgb_points[2 * (int(steps) + 1) + index], &rgb_points[2 * (int(steps) + 1) + index + 1], position, &c[2]);
-				col_ptr = data + i * 4;
-				for (int y = 0; y < ns->n_components * 16; ++y){
-					if ((y & 0x0f) != 0x0f){
-						col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-						col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-						col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-						col_ptr[3] = 0xff;
-					}else{
-						col_ptr[0] = 0x00;
-						col_ptr[1] = 0x00;
-						col_ptr[2] = 0x00;
-						col_ptr[3] = 0x00;
-					}
-					col_ptr += stride;
-				}
-			}
+			color_lab_to_rgb(color, rgb, color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_inverted_sRGB_transformation_matrix(), adaptation_matrix);
 			break;
 		case GtkColorComponentComp::lch:
-			steps = 100;
-			color_get_chromatic_adaptation_matrix(color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_reference(REFERENCE_ILLUMINANT_D65, REFERENCE_OBSERVER_2), &adaptation_matrix);
-			for (j = 0; j < 3; ++j){
-				color_copy(&ns->color, &c[j]);
-				out_of_gamut[j] = vector<bool>(steps + 1, false);
-				for (i = 0; i <= steps; ++i){
-					c[j].ma[j] = (i / steps) * ns->range[j] + ns->offset[j];
-					color_lch_to_rgb(&c[j], &rgb_points[j * (int(steps) + 1) + i], color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_inverted_sRGB_transformation_matrix(), &adaptation_matrix);
-					if (color_is_rgb_out_of_gamut(&rgb_points[j * (int(steps) + 1) + i])){
-						out_of_gamut[j][i] = true;
-					}
-					color_rgb_normalize(&rgb_points[j * (int(steps) + 1) + i]);
-				}
-			}
-			for (i = 0; i < surface_width; ++i){
-				float position = modf(i * steps / surface_width, &int_part);
-				int index = i * int(steps) / surface_width;
-				interpolate_colors(&rgb_points[0 * (int(steps) + 1) + index], &rgb_points[0 * (int(steps) + 1) + index + 1], position, &c[0]);
-				interpolate_colors(&rgb_points[1 * (int(steps) + 1) + index], &rgb_points[1 * (int(steps) + 1) + index + 1], position, &c[1]);
-				interpolate_colors(&rgb_points[2 * (int(steps) + 1) + index], &rgb_points[2 * (int(steps) + 1) + index + 1], position, &c[2]);
-				col_ptr = data + i * 4;
-				for (int y = 0; y < ns->n_components * 16; ++y){
-					if ((y & 0x0f) != 0x0f){
-						col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-						col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-						col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-						col_ptr[3] = 0xff;
-					}else{
-						col_ptr[0] = 0x00;
-						col_ptr[1] = 0x00;
-						col_ptr[2] = 0x00;
-						col_ptr[3] = 0x00;
-					}
-					col_ptr += stride;
-				}
-			}
+			color_lch_to_rgb(color, rgb, color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_inverted_sRGB_transformation_matrix(), adaptation_matrix);
 			break;
-		default:
+		case GtkColorComponentComp::xyz:
+			color_xyz_to_rgb(color, rgb, color_get_inverted_sRGB_transformation_matrix());
+			color_rgb_normalize(rgb);
 			break;
 	}
-	delete [] rgb_points;
-	cairo_surface_mark_dirty(surface);
+}
+static bool is_strip_valid(GtkColorComponentPrivate *ns, int component)
+{
+	if (!ns->strip_valid[component])
+		return false;
+	for (int i = 0; i < ns->n_components; ++i){
+		if (i != component && ns->strip_color[component].ma[i] != ns->color.ma[i])
+			return false;
+	}
+	return true;
+}
+static void update_strip(GtkColorComponentPrivate *ns, int component)
+{
+	int steps = ns->component == GtkColorComponentComp::rgb ? 1 : GradientSteps;
+	bool check_gamut = ns->component == GtkColorComponentComp::lab || ns->component == GtkColorComponentComp::lch;
+	matrix3x3 adaptation_matrix;
+	if (check_gamut)
+		color_get_chromatic_adaptation_matrix(color_get_reference(ns->lab_illuminant, ns->lab_observer), color_get_reference(REFERENCE_ILLUMINANT_D65, REFERENCE_OBSERVER_2), &adaptation_matrix);
+	Color c, points[GradientSteps + 1];
+	color_copy(&ns->color, &c);
+	for (int i = 0; i <= steps; ++i){
+		c.ma[component] = (i / float(steps)) * ns->range[component] + ns->offset[component];
+		get_component_rgb(ns, &c, &points[i], &adaptation_matrix);
+		if (check_gamut){
+			ns->out_of_gamut[component][i] = color_is_rgb_out_of_gamut(&points[i]);
+			color_rgb_normalize(&points[i]);
+		}
+	}
+	ns->out_of_gamut_points[component] = check_gamut ? steps + 1 : 0;
+	//render one row and replicate it, last row of each strip stays transparent
+	cairo_surface_flush(ns->strip_surface);
+	unsigned char *data = cairo_image_surface_get_data(ns->strip_surface);
+	int stride = cairo_image_surface_get_stride(ns->strip_surface);
+	int surface_width = cairo_image_surface_get_width(ns->strip_surface);
+	uint32_t *row = reinterpret_cast<uint32_t*>(data + stride * component * 16);
+	Color color;
+	for (int x = 0; x < surface_width; ++x){
+		float position = x * float(steps) / (surface_width - 1);
+		int index = min_int(int(position), steps - 1);
+		interpolate_colors(&points[index], &points[index + 1], position - index, &color);
+		row[x] = 0xff000000 | ((unsigned char)(color.rgb.red * 255) << 16) | ((unsigned char)(color.rgb.green * 255) << 8) | (unsigned char)(color.rgb.blue * 255);
+	}
+	for (int y = 1; y < 15; ++y){
+		memcpy(data + stride * (component * 16 + y), row, surface_width * sizeof(uint32_t));
+	}
+	cairo_surface_mark_dirty_rectangle(ns->strip_surface, 0, component * 16, surface_width, 15);
+	color_copy(&ns->color, &ns->strip_color[component]);
+	ns->strip_valid[component] = true;
+}
+static gboolean draw_components(GtkWidget *widget, cairo_t *cr)
+{
+	GtkColorComponentPrivate *ns = GET_PRIVATE(widget);
+	double pointer_pos[MaxNumberOfComponents];
+	int i;
+	for (int i = 0; i < ns->n_components; ++i){
+		pointer_pos[i] = (ns->color.ma[i] - ns->offset[i]) / ns->range[i];
+	}
+	if (!ns->strip_surface){
+		ns->strip_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 200, ns->n_components * 16);
+		for (i = 0; i < MaxNumberOfComponents; ++i)
+			ns->strip_valid[i] = false;
+	}
+	for (i = 0; i < ns->n_components; ++i){
+		if (!is_strip_valid(ns, i))
+			update_strip(ns, i);
+	}
 	cairo_save(cr);
 	int offset_x = get_x_offset(widget);
-	cairo_set_source_surface(cr, surface, offset_x, 0);
-	cairo_surface_destroy(surface);
+	cairo_set_source_surface(cr, ns->strip_surface, offset_x, 0);
 	for (i = 0; i < ns->n_components; ++i){
 		cairo_rectangle(cr, offset_x, 16 * i, 200, 15);
 		cairo_fill(cr);
@@ -540,22 +423,22 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 			int first_out_of_gamut = 0;
 			bool out_of_gamut_found = false;
 			cairo_set_source(cr, ns->pattern);
-			for (size_t j = 0; j < out_of_gamut[i].size(); j++){
-				if (out_of_gamut[i][j]){
+			for (int j = 0; j < ns->out_of_gamut_points[i]; j++){
+				if (ns->out_of_gamut[i][j]){
 					if (!out_of_gamut_found){
 						out_of_gamut_found = true;
 						first_out_of_gamut = j;
 					}
 				}else{
 					if (out_of_gamut_found){
-						cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / out_of_gamut[i].size()), 16 * i, (j - first_out_of_gamut) * 200.0 / out_of_gamut[i].size(), 15);
+						cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / ns->out_of_gamut_points[i]), 16 * i, (j - first_out_of_gamut) * 200.0 / ns->out_of_gamut_points[i], 15);
 						cairo_fill(cr);
 						out_of_gamut_found = false;
 					}
 				}
 			}
 			if (out_of_gamut_found){
-				cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / out_of_gamut[i].size()), 16 * i, (out_of_gamut[i].size() - first_out_of_gamut) * 200.0 / out_of_gamut[i].size(), 15);
+				cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / ns->out_of_gamut_points[i]), 16 * i, (ns->out_of_gamut_points[i] - first_out_of_gamut) * 200.0 / ns->out_of_gamut_points[i], 15);
 				cairo_fill(cr);
 			}
 		}
@@ -615,6 +498,17 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 	}
 	return TRUE;
 }
+static gboolean draw(GtkWidget *widget, cairo_t *cr)
+{
+	TRACE_SCOPE("GtkColorComponent::draw");
+	GtkColorComponentPrivate *ns = GET_PRIVATE(widget);
+	gint64 start = g_get_monotonic_time();
+	gboolean result = draw_components(widget, cr);
+	ns->last_frame_time = g_get_monotonic_time() - start;
+	ns->total_frame_time += ns->last_frame_time;
+	ns->frame_count++;
+	return result;
+}
 #if GTK_MAJOR_VERSION < 3
 static gboolean expose(GtkWidget *widget, GdkEventExpose *event)
 {
@@ -760,6 +654,8 @@ void gtk_color_component_set_lab_illuminant(GtkColorComponent* color_component,
 {
 	GtkColorComponentPrivate *ns = GET_PRIVATE(color_component);
 	ns->lab_illuminant = illuminant;
+	for (int i = 0; i != MaxNumberOfComponents; i++)
+		ns->strip_valid[i] = false;
 	gtk_color_component_set_color(color_component, &ns->orig_color);
 	gtk_widget_queue_draw(GTK_WIDGET(color_component));
 }
@@ -767,6 +663,8 @@ void gtk_color_component_set_lab_observer(GtkColorComponent* color_component, Re
 {
 	GtkColorComponentPrivate *ns = GET_PRIVATE(color_component);
 	ns->lab_observer = observer;
+	for (int i = 0; i != MaxNumberOfComponents; i++)
+		ns->strip_valid[i] = false;
 	gtk_color_component_set_color(color_component, &ns->orig_color);
 	gtk_widget_queue_draw(GTK_WIDGET(color_component));
 }
@@ -781,3 +679,10 @@ bool gtk_color_component_get_out_of_gamut_mask(GtkColorComponent* color_componen
 	GtkColorComponentPrivate *ns = GET_PRIVATE(color_component);
 	return ns->out_of_gamut_mask;
 }
+void gtk_color_component_get_frame_time(GtkColorComponent* color_component, uint32_t *frame_count, double *last_frame_time, double *average_frame_time)
+{
+	GtkColorComponentPrivate *ns = GET_PRIVATE(color_component);
+	*frame_count = ns->frame_count;
+	*last_frame_time = ns->last_frame_time / 1000.0;
+	*average_frame_time = ns->frame_count ? ns->total_frame_time / 1000.0 / ns->frame_count : 0;
+}
@@ -65,6 +65,7 @@ void gtk_color_component_set_lab_illuminant(GtkColorComponent* color_component,
 void gtk_color_component_set_lab_observer(GtkColorComponent* color_component, ReferenceObserver observer);
 GtkColorComponentComp gtk_color_component_get_component(GtkColorComponent* color_component);
 int gtk_color_component_get_component_id_at(GtkColorComponent* color_component, gint x, gint y);
+void gtk_color_component_get_frame_time(GtkColorComponent* color_component, uint32_t *frame_count, double *last_frame_time, double *average_frame_time);
 GType gtk_color_component_get_type();
 
 #endif /* GPICK_GTK_COLOR_COMPONENT_H_ */
@@ -20,12 +20,14 @@
 #include "../Color.h"
 #include "../ColorWheelType.h"
 #include "../MathUtil.h"
+#include "../Tracing.h"
 #include <math.h>
 #ifdef _MSC_VER
 #define M_PI 3.14159265359
 #endif
 #include <stdlib.h>
 #include <list>
+#include <vector>
 #include <iostream>
 using namespace std;
 
@@ -70,6 +72,10 @@ struct GtkColorWheelPrivate
 	bool block_editable;
 	const ColorWheelType *color_wheel_type;
 	cairo_surface_t *cache_color_wheel;
+	int cache_color_wheel_scale;
+	cairo_surface_t *cache_sat_val_block;
+	double cache_sat_val_block_hue;
+	int cache_sat_val_block_scale;
 #if GTK_MAJOR_VERSION >= 3
 	GdkDevice *pointer_grab;
 #endif
@@ -81,6 +87,10 @@ static void finalize(GObject *color_wheel_obj)
 		cairo_surface_destroy(ns->cache_color_wheel);
 		ns->cache_color_wheel = 0;
 	}
+	if (ns->cache_sat_val_block){
+		cairo_surface_destroy(ns->cache_sat_val_block);
+		ns->cache_sat_val_block = 0;
+	}
 	G_OBJECT_CLASS(parent_class)->finalize(color_wheel_obj);
 }
 static void gtk_color_wheel_class_init(GtkColorWheelClass *color_wheel_class)
@@ -125,6 +135,10 @@ GtkWidget* gtk_color_wheel_new()
 	ns->block_editable = true;
 	ns->color_wheel_type = &color_wheel_types_get()[0];
 	ns->cache_color_wheel = 0;
+	ns->cache_color_wheel_scale = 0;
+	ns->cache_sat_val_block = 0;
+	ns->cache_sat_val_block_hue = -1;
+	ns->cache_sat_val_block_scale = 0;
 #if GTK_MAJOR_VERSION >= 3
 	ns->pointer_grab = nullptr;
 #endif
@@ -238,78 +252,177 @@ static void draw_dot(cairo_t *cr, double x, double y, double size)
 	cairo_set_line_width(cr, 1);
 	cairo_stroke(cr);
 }
-static void draw_sat_val_block(cairo_t *cr, double pos_x, double pos_y, double size, double hue)
-{
-	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil(size), ceil(size));
-	unsigned char *data = cairo_image_surface_get_data(surface);
-	int stride = cairo_image_surface_get_stride(surface);
-	int surface_width = cairo_image_surface_get_width(surface);
-	int surface_height = cairo_image_surface_get_height(surface);
-	Color c;
-	unsigned char *line_data;
-	for (int y = 0; y < surface_height; ++y){
-		line_data = data + stride * y;
+static void set_device_scale(cairo_surface_t *surface, int scale)
+{
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 14, 0)
+	cairo_surface_set_device_scale(surface, scale, scale);
+#endif
+}
+static int get_scale(GtkWidget *widget)
+{
+#if GTK_MAJOR_VERSION >= 3 && CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 14, 0)
+	return gtk_widget_get_scale_factor(widget);
+#else
+	return 1;
+#endif
+}
+static inline uint32_t pack_color(const Color &c)
+{
+	return 0xFF000000 | (uint32_t(c.rgb.red * 255) << 16) | (uint32_t(c.rgb.green * 255) << 8) | uint32_t(c.rgb.blue * 255);
+}
+static void draw_sat_val_block(GtkColorWheelPrivate *ns, cairo_t *cr, double pos_x, double pos_y, double size, double hue, int scale)
+{
+	cairo_surface_t *surface = ns->cache_sat_val_block;
+	if (surface && ns->cache_sat_val_block_scale != scale){
+		cairo_surface_destroy(surface);
+		surface = ns->cache_sat_val_block = 0;
+	}
+	if (!surface){
+		surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil(size * scale), ceil(size * scale));
+		if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS){
+			cerr << "ColorWheel image surface allocation failed" << endl;
+			cairo_surface_destroy(surface);
+			return;
+		}
+		set_device_scale(surface, scale);
+		ns->cache_sat_val_block = surface;
+		ns->cache_sat_val_block_scale = scale;
+		ns->cache_sat_val_block_hue = -1;
+	}
+	if (ns->cache_sat_val_block_hue != hue){
+		cairo_surface_flush(surface);
+		unsigned char *data = cairo_image_surface_get_data(surface);
+		int stride = cairo_image_surface_get_stride(surface);
+		int surface_width = cairo_image_surface_get_width(surface);
+		int surface_height = cairo_image_surface_get_height(surface);
+		double pixel_size = size * scale;
+		//with fixed hue each channel is value * (1 - saturation * (1 - channel of fully saturated color))
+		Color c;
+		c.hsv.hue = hue;
+		c.hsv.saturation = 1;
+		c.hsv.value = 1;
+		color_hsv_to_rgb(&c, &c);
+		float complement[3] = {1 - c.rgb.red, 1 - c.rgb.green, 1 - c.rgb.blue};
+		vector<float> row(surface_width * 3);
 		for (int x = 0; x < surface_width; ++x){
-			c.hsv.hue = hue;
-			c.hsv.saturation = x / size;
-			c.hsv.value = y / size;
-			color_hsv_to_rgb(&c, &c);
-			line_data[2] = c.rgb.red * 255;
-			line_data[1] = c.rgb.green * 255;
-			line_data[0] = c.rgb.blue * 255;
-			line_data[3] = 0xFF;
-			line_data += 4;
+			float saturation = x / pixel_size;
+			for (int i = 0; i < 3; ++i)
+				row[x * 3 + i] = 1 - saturation * complement[i];
+		}
+		for (int y = 0; y < surface_height; ++y){
+			uint32_t *line_data = reinterpret_cast<uint32_t*>(data + stride * y);
+			float value = y / pixel_size;
+			for (int x = 0; x < surface_width; ++x){
+				c.rgb.red = value * row[x * 3];
+				c.rgb.green = value * row[x * 3 + 1];
+				c.rgb.blue = value * row[x * 3 + 2];
+				line_data[x] = pack_color(c);
+			}
 		}
+		cairo_surface_mark_dirty(surface);
+		ns->cache_sat_val_block_hue = hue;
 	}
-	cairo_surface_mark_dirty(surface);
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, pos_x - size / 2, pos_y - size / 2);
-	cairo_surface_destroy(surface);
 	cairo_rectangle(cr, pos_x - size / 2, pos_y - size / 2, size, size);
 	cairo_fill(cr);
 	cairo_restore(cr);
 }
-static void draw_wheel(GtkColorWheelPrivate *ns, cairo_t *cr, double radius, double width, const ColorWheelType *wheel)
+/** Number of entries in hue to color lookup table used when rendering wheel. */
+static const int hue_table_size = 1024;
+/** Polynomial atan2 approximation with maximum error of 1e-5 radians, much smaller than hue table step. */
+static inline double approximate_atan2(double y, double x)
+{
+	double ax = fabs(x), ay = fabs(y);
+	double max = ax > ay ? ax : ay;
+	if (max == 0) return 0;
+	double a = (ax < ay ? ax : ay) / max;
+	double s = a * a;
+	double r = a * (0.99997726 + s * (-0.33262347 + s * (0.19354346 + s * (-0.11643287 + s * (0.05265332 + s * -0.01172120)))));
+	if (ay > ax) r = M_PI / 2 - r;
+	if (x < 0) r = M_PI - r;
+	if (y < 0) r = -r;
+	return r;
+}
+/** Largest x with x * x <= value, or -1 if value is negative. */
+static int span_floor(double value)
+{
+	if (value < 0) return -1;
+	int x = int(sqrt(value));
+	while ((x + 1) * (x + 1) <= value) x++;
+	while (x > 0 && x * x > value) x--;
+	return x;
+}
+/** Smallest non-negative x with x * x >= value. */
+static int span_ceil(double value)
+{
+	if (value <= 0) return 0;
+	int x = int(ceil(sqrt(value)));
+	while (x > 0 && (x - 1) * (x - 1) >= value) x--;
+	while (x * x < value) x++;
+	return x;
+}
+static void draw_wheel(GtkColorWheelPrivate *ns, cairo_t *cr, double radius, double width, const ColorWheelType *wheel, int scale)
 {
 	cairo_surface_t *surface;
 	double inner_radius = radius - width;
+	if (ns->cache_color_wheel && ns->cache_color_wheel_scale != scale){
+		cairo_surface_destroy(ns->cache_color_wheel);
+		ns->cache_color_wheel = 0;
+	}
 	if (ns->cache_color_wheel){
 		surface = ns->cache_color_wheel;
 	}else{
-		surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil(radius * 2), ceil(radius * 2));
+		surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil(radius * 2 * scale), ceil(radius * 2 * scale));
 		if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS){
 			cerr << "ColorWheel image surface allocation failed" << endl;
+			cairo_surface_destroy(surface);
 			return;
 		}
+		set_device_scale(surface, scale);
+		uint32_t hue_table[hue_table_size];
+		Color c;
+		for (int i = 0; i < hue_table_size; ++i){
+			wheel->hue_to_hsl(i / double(hue_table_size), &c);
+			color_hsl_to_rgb(&c, &c);
+			hue_table[i] = pack_color(c);
+		}
 		unsigned char *data = cairo_image_surface_get_data(surface);
 		int stride = cairo_image_surface_get_stride(surface);
 		int surface_width = cairo_image_surface_get_width(surface);
 		int surface_height = cairo_image_surface_get_height(surface);
-		double radius_sq = radius * radius + 2 * radius + 1;
-		double inner_radius_sq = inner_radius * inner_radius - 2 * inner_radius + 1;
-		Color c;
-		unsigned char *line_data;
+		double pixel_radius = radius * scale, pixel_inner_radius = inner_radius * scale;
+		double radius_sq = pixel_radius * pixel_radius + 2 * pixel_radius + 1;
+		double inner_radius_sq = pixel_inner_radius * pixel_inner_radius - 2 * pixel_inner_radius + 1;
+		int center_x = surface_width / 2, center_y = surface_height / 2;
 		for (int y = 0; y < surface_height; ++y){
-			line_data = data + stride * y;
-			for (int x = 0; x < surface_width; ++x){
-				int dx = -(x - surface_width / 2);
-				int dy = y - surface_height / 2;
-				int dist = dx * dx + dy * dy;
-				if ((dist >= inner_radius_sq) && (dist <= radius_sq)){
-					double angle = atan2((double)dx, (double)dy) + M_PI;
-					wheel->hue_to_hsl(angle / (M_PI * 2), &c);
-					color_hsl_to_rgb(&c, &c);
-					line_data[2] = c.rgb.red * 255;
-					line_data[1] = c.rgb.green * 255;
-					line_data[0] = c.rgb.blue * 255;
-					line_data[3] = 0xFF;
+			uint32_t *line_data = reinterpret_cast<uint32_t*>(data + stride * y);
+			int dy = y - center_y;
+			//pixels with inner_radius_sq <= dx * dx + dy * dy <= radius_sq form one or two horizontal spans
+			int outer = span_floor(radius_sq - dy * dy);
+			if (outer < 0) continue;
+			int inner = span_ceil(inner_radius_sq - dy * dy);
+			if (inner > outer) continue;
+			int spans[2][2] = {{center_x - outer, center_x - inner}, {center_x + inner, center_x + outer}};
+			if (inner == 0){
+				spans[0][1] = center_x + outer;
+				spans[1][0] = 1;
+				spans[1][1] = 0;
+			}
+			for (int i = 0; i < 2; ++i){
+				int x_start = max_int(spans[i][0], 0);
+				int x_end = min_int(spans[i][1], surface_width - 1);
+				for (int x = x_start; x <= x_end; ++x){
+					int dx = center_x - x;
+					double hue = (approximate_atan2(dx, dy) + M_PI) / (M_PI * 2);
+					line_data[x] = hue_table[int(hue * hue_table_size + 0.5) % hue_table_size];
 				}
-				line_data += 4;
 			}
 		}
+		cairo_surface_mark_dirty(surface);
 		ns->cache_color_wheel = surface;
+		ns->cache_color_wheel_scale = scale;
 	}
-	cairo_surface_mark_dirty(surface);
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, 0, 0);
 	cairo_set_line_width(cr, width);
@@ -387,13 +500,15 @@ static gboolean motion_notify(GtkWidget *widget, GdkEventMotion *event)
 }
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
+	TRACE_SCOPE("GtkColorWheel::draw");
 	GtkColorWheelPrivate *ns = GET_PRIVATE(widget);
-	draw_wheel(ns, cr, ns->radius, ns->circle_width, ns->color_wheel_type);
+	int scale = get_scale(widget);
+	draw_wheel(ns, cr, ns->radius, ns->circle_width, ns->color_wheel_type, scale);
 	if (ns->selected){
 		double block_size = 2 * (ns->radius - ns->circle_width) * sin(M_PI / 4) - 6;
 		Color hsl;
 		ns->color_wheel_type->hue_to_hsl(ns->selected->hue, &hsl);
-		draw_sat_val_block(cr, ns->radius, ns->radius, block_size, hsl.hsl.hue);
+		draw_sat_val_block(ns, cr, ns->radius, ns->radius, block_size, hsl.hsl.hue, scale);
 		draw_dot(cr, ns->radius - block_size / 2 + block_size * ns->selected->saturation, ns->radius - block_size / 2 + block_size * ns->selected->lightness, 4);
 	}
 	for (uint32_t i = 0; i != ns->n_cpoint; i++){
@@ -19,6 +19,7 @@
 #include "ColorWidget.h"
 #include "../Color.h"
 #include "../MathUtil.h"
+#include "../Tracing.h"
 #include <math.h>
 #include <boost/math/special_functions/round.hpp>
 #include <iostream>
@@ -206,6 +207,7 @@ static void cairo_set_color(cairo_t *cr, Color &color)
 }
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
+	TRACE_SCOPE("GtkColor::draw");
 	GtkColorPrivate *ns = GET_PRIVATE(widget);
 	Color color, split_color;
 #if GTK_MAJOR_VERSION >= 3
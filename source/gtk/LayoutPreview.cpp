@@ -20,6 +20,7 @@
 #include "../layout/System.h"
 #include "../transformation/Chain.h"
 #include "../Rect2.h"
+#include "../Tracing.h"
 #include <list>
 #include <typeinfo>
 using namespace std;
@@ -107,6 +108,7 @@ static bool set_selected_box(GtkLayoutPreviewPrivate *ns, Box* box)
 }
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
+	TRACE_SCOPE("GtkLayoutPreview::draw");
 	GtkLayoutPreviewPrivate *ns = GET_PRIVATE(widget);
 	if (ns->system && ns->system->box){
 		ns->area = Rect2<float>(0, 0, 1, 1);
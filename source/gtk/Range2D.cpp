@@ -19,6 +19,7 @@
 #include "Range2D.h"
 #include "../Color.h"
 #include "../MathUtil.h"
+#include "../Tracing.h"
 #include <math.h>
 #ifdef _MSC_VER
 #define M_PI 3.14159265359
@@ -192,6 +193,7 @@ static gboolean motion_notify(GtkWidget *widget, GdkEventMotion *event)
 }
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
+	TRACE_SCOPE("GtkRange2D::draw");
 	GtkRange2DPrivate *ns = GET_PRIVATE(widget);
 	draw_sat_val_block(ns, cr, 0, 0, ns->block_size);
 	draw_dot(cr, ns->block_size * ns->x, ns->block_size * ns->y, 6);
@@ -19,7 +19,9 @@
 #include "Swatch.h"
 #include "../Color.h"
 #include "../MathUtil.h"
+#include "../Tracing.h"
 #include <math.h>
+#include <algorithm>
 #include <boost/math/special_functions/round.hpp>
 
 #define GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE((obj), GTK_TYPE_SWATCH, GtkSwatchPrivate))
@@ -219,6 +221,7 @@ static void draw_hexagon(cairo_t *cr, float x, float y, float radius)
 }
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
+	TRACE_SCOPE("GtkSwatch::draw");
 	GtkSwatchPrivate *ns = GET_PRIVATE(widget);
 	if (gtk_widget_has_focus(widget) || ns->active){
 #if GTK_MAJOR_VERSION >= 3
@@ -261,48 +264,35 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 	draw_hexagon(cr, radius_multi * cos(rotation + (ns->current_color) * (2 * PI) / edges), radius_multi * sin(rotation + (ns->current_color) * (2
 			* PI) / edges), 27);
 	cairo_stroke(cr);
-	Color color;
+	Color colors[7];
+	if (ns->transformation_chain){
+		ns->transformation_chain->apply(ns->color, colors, 7);
+	}else{
+		std::copy(ns->color, ns->color + 7, colors);
+	}
 	//Draw fill
 	for (int i = 1; i < 7; ++i) {
 		if (i == ns->current_color)
 			continue;
-		if (ns->transformation_chain){
-			ns->transformation_chain->apply(&ns->color[i], &color);
-		}else{
-			color_copy(&ns->color[i], &color);
-		}
+		Color &color = colors[i];
 		cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
 		draw_hexagon(cr, radius_multi * cos(rotation + i * (2 * PI) / edges), radius_multi * sin(rotation + i * (2 * PI) / edges), 25.5);
 		cairo_fill(cr);
 	}
-	if (ns->transformation_chain){
-		ns->transformation_chain->apply(&ns->color[ns->current_color], &color);
-	}else{
-		color_copy(&ns->color[ns->current_color], &color);
-	}
+	Color &color = colors[ns->current_color];
 	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
 	draw_hexagon(cr, radius_multi * cos(rotation + (ns->current_color) * (2 * PI) / edges), radius_multi * sin(rotation + (ns->current_color) * (2 * PI) / edges), 25.5);
 	cairo_fill(cr);
 	//Draw center
-	if (ns->transformation_chain){
-		ns->transformation_chain->apply(&ns->color[0], &color);
-	}else{
-		color_copy(&ns->color[0], &color);
-	}
-	cairo_set_source_rgb(cr, boost::math::round(color.rgb.red * 255.0) / 255.0, boost::math::round(color.rgb.green * 255.0) / 255.0, boost::math::round(color.rgb.blue * 255.0) / 255.0);
+	Color &center_color = colors[0];
+	cairo_set_source_rgb(cr, boost::math::round(center_color.rgb.red * 255.0) / 255.0, boost::math::round(center_color.rgb.green * 255.0) / 255.0, boost::math::round(center_color.rgb.blue * 255.0) / 255.0);
 	draw_hexagon(cr, 0, 0, 25.5);
 	cairo_fill(cr);
 	//Draw numbers
 	char numb[2] = " ";
 	for (int i = 1; i < 7; ++i) {
 		Color c;
-		if (ns->transformation_chain){
-			Color t;
-			ns->transformation_chain->apply(&ns->color[i], &t);
-			color_get_contrasting(&t, &c);
-		}else{
-			color_get_contrasting(&ns->color[i], &c);
-		}
+		color_get_contrasting(&colors[i], &c);
 		cairo_text_extents_t extends;
 		numb[0] = '0' + i;
 		cairo_text_extents(cr, numb, &extends);
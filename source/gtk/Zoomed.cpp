@@ -19,6 +19,7 @@
 #include "Zoomed.h"
 #include "../Color.h"
 #include "../MathUtil.h"
+#include "../Tracing.h"
 #include <math.h>
 #include <iomanip>
 #include <algorithm>
@@ -292,6 +293,7 @@ gfloat gtk_zoomed_get_zoom(GtkZoomed* zoomed)
 }
 static gboolean draw(GtkWidget *widget, cairo_t *cr)
 {
+	TRACE_SCOPE("GtkZoomed::draw");
 	GtkZoomedPrivate *ns = GET_PRIVATE(widget);
 #if GTK_MAJOR_VERSION >= 3
 	int padding_x = 0, padding_y = 0;
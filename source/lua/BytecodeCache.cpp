@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "BytecodeCache.h"
+#include "../Tracing.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string>
+#include <sstream>
+#include <cstring>
+extern "C"{
+#include <lualib.h>
+#include <lauxlib.h>
+}
+using namespace std;
+namespace lua
+{
+bool bytecodeCacheEnabled()
+{
+	const char *no_cache = g_getenv("GPICK_NO_LUA_CACHE");
+	return no_cache == nullptr || *no_cache == 0;
+}
+/** Cache file header. Cached chunk is used only when header matches exactly. */
+static string cacheHeader(const char *filename, const GStatBuf &stat)
+{
+	stringstream ss;
+	ss << "gpick lua chunk\n" << LUA_RELEASE << "\n" << filename << "\n" << static_cast<int64_t>(stat.st_mtime) << " " << static_cast<int64_t>(stat.st_size) << "\n";
+	return ss.str();
+}
+static int writeChunk(lua_State *, const void *data, size_t size, void *userdata)
+{
+	reinterpret_cast<string*>(userdata)->append(reinterpret_cast<const char*>(data), size);
+	return 0;
+}
+static int loadCachedChunk(lua_State *L, const char *filename, const char *cache_filename, const string &header)
+{
+	gchar *contents;
+	gsize length;
+	if (!g_file_get_contents(cache_filename, &contents, &length, nullptr))
+		return LUA_ERRFILE;
+	int status = LUA_ERRFILE;
+	if (length > header.length() && memcmp(contents, header.data(), header.length()) == 0){
+		string chunk_name = string("@") + filename;
+		status = luaL_loadbufferx(L, contents + header.length(), length - header.length(), chunk_name.c_str(), "b");
+		if (status != LUA_OK)
+			lua_pop(L, 1);
+	}
+	g_free(contents);
+	return status;
+}
+int loadCachedFile(lua_State *L, const char *filename, const char *cache_path)
+{
+	GStatBuf stat;
+	if (g_stat(filename, &stat) != 0)
+		return luaL_loadfile(L, filename);
+	string header = cacheHeader(filename, stat);
+	gchar *checksum = g_compute_checksum_for_string(G_CHECKSUM_MD5, filename, -1);
+	string cache_name = string(checksum) + ".luac";
+	g_free(checksum);
+	gchar *cache_filename = g_build_filename(cache_path, cache_name.c_str(), nullptr);
+	int status = loadCachedChunk(L, filename, cache_filename, header);
+	if (status == LUA_OK){
+		tracing::count("lua.bytecode_cache_hits");
+		g_free(cache_filename);
+		return status;
+	}
+	tracing::count("lua.bytecode_cache_misses");
+	status = luaL_loadfile(L, filename);
+	if (status == LUA_OK){
+		string data = header;
+#if LUA_VERSION_NUM >= 503
+		lua_dump(L, writeChunk, &data, 0);
+#else
+		lua_dump(L, writeChunk, &data);
+#endif
+		//g_file_set_contents writes into temporary file and renames it, so other instances never see partially written chunk
+		g_file_set_contents(cache_filename, data.data(), data.length(), nullptr);
+	}
+	g_free(cache_filename);
+	return status;
+}
+static int searcher(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "searchpath");
+	lua_pushvalue(L, 1);
+	lua_getfield(L, -3, "path");
+	lua_call(L, 2, 1);
+	//standard file searcher reports files which were not found
+	if (lua_isnil(L, -1))
+		return 0;
+	const char *filename = lua_tostring(L, -1);
+	if (loadCachedFile(L, filename, lua_tostring(L, lua_upvalueindex(1))) != LUA_OK)
+		return luaL_error(L, "error loading module '%s' from file '%s':\n\t%s", name, filename, lua_tostring(L, -1));
+	lua_pushstring(L, filename);
+	return 2;
+}
+void installBytecodeCache(lua_State *L, const char *cache_path)
+{
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "searchers");
+	//insert after preload searcher
+	for (lua_Integer i = lua_rawlen(L, -1); i >= 2; i--){
+		lua_rawgeti(L, -1, i);
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_pushstring(L, cache_path);
+	lua_pushcclosure(L, searcher, 1);
+	lua_rawseti(L, -2, 2);
+	lua_pop(L, 2);
+}
+}
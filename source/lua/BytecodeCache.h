@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_LUA_BYTECODE_CACHE_H_
+#define GPICK_LUA_BYTECODE_CACHE_H_
+struct lua_State;
+namespace lua
+{
+/**
+ * Check if compiled Lua chunks should be cached. Cache is disabled when GPICK_NO_LUA_CACHE environment variable is set to a non-empty value, which allows comparing startup times with and without cache.
+ * @return True if cache is enabled.
+ */
+bool bytecodeCacheEnabled();
+/**
+ * Load Lua file as a chunk, using compiled chunk from cache directory when it is up to date. Compiled chunk is written into cache directory when it is missing or stale.
+ * Cached chunks are keyed by file path, modification time, size and Lua release, so edited scripts and Lua upgrades are compiled again.
+ * @param[in] L Lua state.
+ * @param[in] filename Lua file name.
+ * @param[in] cache_path Existing cache directory.
+ * @return Lua status code, with loaded chunk or error message pushed onto stack, same as luaL_loadfile.
+ */
+int loadCachedFile(lua_State *L, const char *filename, const char *cache_path);
+/**
+ * Add package searcher which loads Lua modules through loadCachedFile(), so that require uses compiled chunks.
+ * Searcher is placed before the standard Lua file searcher and uses the same package.path.
+ * @param[in] L Lua state.
+ * @param[in] cache_path Existing cache directory.
+ */
+void installBytecodeCache(lua_State *L, const char *cache_path);
+}
+#endif /* GPICK_LUA_BYTECODE_CACHE_H_ */
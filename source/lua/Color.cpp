@@ -17,6 +17,7 @@
  */
 
 #include "Color.h"
+#include "UserdataPool.h"
 #include "../Color.h"
 extern "C"{
 #include <lualib.h>
@@ -24,11 +25,13 @@ extern "C"{
 }
 namespace lua
 {
+static Color *newColorUserdata(lua_State *L)
+{
+	return reinterpret_cast<Color*>(UserdataPool::push(L, UserdataPool::Type::color));
+}
 static int newColor(lua_State *L)
 {
-	Color *c = reinterpret_cast<Color*>(lua_newuserdata(L, sizeof(Color)));
-	luaL_getmetatable(L, "color");
-	lua_setmetatable(L, -2);
+	Color *c = newColorUserdata(L);
 	if (lua_type(L, 2) == LUA_TNUMBER && lua_type(L, 3) == LUA_TNUMBER && lua_type(L, 4) == LUA_TNUMBER ){
 		c->rgb.red = luaL_checknumber(L, 2);
 		c->rgb.green = luaL_checknumber(L, 3);
@@ -46,9 +49,7 @@ Color &checkColor(lua_State *L, int index)
 }
 int pushColor(lua_State *L, const Color &color)
 {
-	Color *c = reinterpret_cast<Color*>(lua_newuserdata(L, sizeof(Color)));
-	luaL_getmetatable(L, "color");
-	lua_setmetatable(L, -2);
+	Color *c = newColorUserdata(L);
 	color_copy(&color, c);
 	return 1;
 }
@@ -216,29 +217,85 @@ static int colorLabB(lua_State *L)
 	lua_pushnumber(L, c.lab.b);
 	return 1;
 }
-static int colorRgbToHsl(lua_State *L)
+static int colorXyz(lua_State *L)
 {
 	Color &c = checkColor(L, 1);
-	Color c2;
-	color_rgb_to_hsl(&c, &c2);
-	pushColor(L, c2);
-	return 1;
+	if (lua_type(L, 2) == LUA_TNUMBER && lua_type(L, 3) == LUA_TNUMBER && lua_type(L, 4) == LUA_TNUMBER){
+		c.xyz.x = luaL_checknumber(L, 2);
+		c.xyz.y = luaL_checknumber(L, 3);
+		c.xyz.z = luaL_checknumber(L, 4);
+	}
+	lua_pushnumber(L, c.xyz.x);
+	lua_pushnumber(L, c.xyz.y);
+	lua_pushnumber(L, c.xyz.z);
+	return 3;
 }
-static int colorHslToRgb(lua_State *L)
+static int colorLab(lua_State *L)
 {
 	Color &c = checkColor(L, 1);
-	Color c2;
-	color_hsl_to_rgb(&c, &c2);
-	pushColor(L, c2);
-	return 1;
+	if (lua_type(L, 2) == LUA_TNUMBER && lua_type(L, 3) == LUA_TNUMBER && lua_type(L, 4) == LUA_TNUMBER){
+		c.lab.L = luaL_checknumber(L, 2);
+		c.lab.a = luaL_checknumber(L, 3);
+		c.lab.b = luaL_checknumber(L, 4);
+	}
+	lua_pushnumber(L, c.lab.L);
+	lua_pushnumber(L, c.lab.a);
+	lua_pushnumber(L, c.lab.b);
+	return 3;
+}
+static int colorLch(lua_State *L)
+{
+	Color &c = checkColor(L, 1);
+	if (lua_type(L, 2) == LUA_TNUMBER && lua_type(L, 3) == LUA_TNUMBER && lua_type(L, 4) == LUA_TNUMBER){
+		c.lch.L = luaL_checknumber(L, 2);
+		c.lch.C = luaL_checknumber(L, 3);
+		c.lch.h = luaL_checknumber(L, 4);
+	}
+	lua_pushnumber(L, c.lch.L);
+	lua_pushnumber(L, c.lch.C);
+	lua_pushnumber(L, c.lch.h);
+	return 3;
+}
+static void rgbToXyz(const Color *a, Color *b)
+{
+	color_rgb_to_xyz(a, b, color_get_sRGB_transformation_matrix());
+}
+static void xyzToRgb(const Color *a, Color *b)
+{
+	color_xyz_to_rgb(a, b, color_get_inverted_sRGB_transformation_matrix());
 }
-static int colorRgbToCmyk(lua_State *L)
+/** Converts color (argument 1). Result is written into target color (argument 2) when it is given, so that conversion can be done in-place without allocating new userdata. */
+template<void (*convert)(const Color *, Color *)>
+static int colorConvert(lua_State *L)
 {
 	Color &c = checkColor(L, 1);
-	Color c2, c3;
-	color_rgb_to_cmy(&c, &c3);
-	color_cmy_to_cmyk(&c3, &c2);
-	pushColor(L, c2);
+	Color result;
+	convert(&c, &result);
+	if (lua_isnoneornil(L, 2)){
+		pushColor(L, result);
+		return 1;
+	}
+	color_copy(&result, &checkColor(L, 2));
+	lua_settop(L, 2);
+	return 1;
+}
+/** Converts every color in array (argument 1) in-place and returns the same array. */
+template<void (*convert)(const Color *, Color *)>
+static int colorConvertArray(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	size_t count = lua_rawlen(L, 1);
+	for (size_t i = 1; i <= count; i++){
+		lua_rawgeti(L, 1, i);
+		Color *c = reinterpret_cast<Color*>(luaL_testudata(L, -1, "color"));
+		if (c == nullptr)
+			return luaL_error(L, "color expected at index %d", static_cast<int>(i));
+		Color result;
+		convert(c, &result);
+		color_copy(&result, c);
+		lua_pop(L, 1);
+	}
+	lua_settop(L, 1);
 	return 1;
 }
 static int colorLchLightness(lua_State *L)
@@ -271,6 +328,18 @@ static int colorLchHue(lua_State *L)
 static const struct luaL_Reg color_functions[] =
 {
 	{"new", newColor},
+	{"rgbToHsl", colorConvertArray<color_rgb_to_hsl>},
+	{"hslToRgb", colorConvertArray<color_hsl_to_rgb>},
+	{"rgbToHsv", colorConvertArray<color_rgb_to_hsv>},
+	{"hsvToRgb", colorConvertArray<color_hsv_to_rgb>},
+	{"rgbToCmyk", colorConvertArray<color_rgb_to_cmyk>},
+	{"cmykToRgb", colorConvertArray<color_cmyk_to_rgb>},
+	{"rgbToXyz", colorConvertArray<rgbToXyz>},
+	{"xyzToRgb", colorConvertArray<xyzToRgb>},
+	{"rgbToLab", colorConvertArray<color_rgb_to_lab_d50>},
+	{"labToRgb", colorConvertArray<color_lab_to_rgb_d50>},
+	{"rgbToLch", colorConvertArray<color_rgb_to_lch_d50>},
+	{"lchToRgb", colorConvertArray<color_lch_to_rgb_d50>},
 	{nullptr, nullptr}
 };
 static const struct luaL_Reg color_members[] =
@@ -296,17 +365,32 @@ static const struct luaL_Reg color_members[] =
 	{"lchLightness", colorLchLightness},
 	{"lchChroma", colorLchChroma},
 	{"lchHue", colorLchHue},
-	{"rgbToHsl", colorRgbToHsl},
-	{"hslToRgb", colorHslToRgb},
-	{"rgbToCmyk", colorRgbToCmyk},
+	{"lch", colorLch},
+	{"lab", colorLab},
+	{"xyz", colorXyz},
+	{"rgbToHsl", colorConvert<color_rgb_to_hsl>},
+	{"hslToRgb", colorConvert<color_hsl_to_rgb>},
+	{"rgbToHsv", colorConvert<color_rgb_to_hsv>},
+	{"hsvToRgb", colorConvert<color_hsv_to_rgb>},
+	{"rgbToCmyk", colorConvert<color_rgb_to_cmyk>},
+	{"cmykToRgb", colorConvert<color_cmyk_to_rgb>},
+	{"rgbToXyz", colorConvert<rgbToXyz>},
+	{"xyzToRgb", colorConvert<xyzToRgb>},
+	{"rgbToLab", colorConvert<color_rgb_to_lab_d50>},
+	{"labToRgb", colorConvert<color_lab_to_rgb_d50>},
+	{"rgbToLch", colorConvert<color_rgb_to_lch_d50>},
+	{"lchToRgb", colorConvert<color_lch_to_rgb_d50>},
 	{nullptr, nullptr}
 };
 int registerColor(lua_State *L)
 {
 	luaL_newmetatable(L, "color");
-	lua_pushvalue(L, -1);
-	lua_setfield(L, -2, "__index");
 	luaL_setfuncs(L, color_members, 0);
+	//separate method table, so finalizer can not be called as a method
+	lua_newtable(L);
+	luaL_setfuncs(L, color_members, 0);
+	lua_setfield(L, -2, "__index");
+	UserdataPool::setFinalizer(L, UserdataPool::Type::color);
 	lua_pop(L, 1);
 	luaL_newlib(L, color_functions);
 	return 1;
@@ -19,6 +19,7 @@
 #include "ColorObject.h"
 #include "Color.h"
 #include "Script.h"
+#include "UserdataPool.h"
 #include "../ColorObject.h"
 extern "C"{
 #include <lualib.h>
@@ -28,9 +29,7 @@ namespace lua
 {
 static int newColorObject(lua_State *L)
 {
-	ColorObject** c = reinterpret_cast<ColorObject**>(lua_newuserdata(L, sizeof(ColorObject*)));
-	luaL_getmetatable(L, "colorObject");
-	lua_setmetatable(L, -2);
+	ColorObject** c = reinterpret_cast<ColorObject**>(UserdataPool::push(L, UserdataPool::Type::colorObject));
 	*c = nullptr;
 	return 1;
 }
@@ -38,13 +37,13 @@ ColorObject* checkColorObject(lua_State *L, int index)
 {
 	void *ud = luaL_checkudata(L, index, "colorObject");
 	luaL_argcheck(L, ud != nullptr, index, "`colorObject' expected");
-	return *reinterpret_cast<ColorObject**>(ud);
+	ColorObject *color_object = *reinterpret_cast<ColorObject**>(ud);
+	luaL_argcheck(L, color_object != nullptr, index, "color object is not valid anymore");
+	return color_object;
 }
 int pushColorObject(lua_State *L, ColorObject* color_object)
 {
-	ColorObject** c = reinterpret_cast<ColorObject**>(lua_newuserdata(L, sizeof(ColorObject*)));
-	luaL_getmetatable(L, "colorObject");
-	lua_setmetatable(L, -2);
+	ColorObject** c = reinterpret_cast<ColorObject**>(UserdataPool::push(L, UserdataPool::Type::colorObject));
 	*c = color_object;
 	return 1;
 }
@@ -82,9 +81,11 @@ static const struct luaL_Reg color_object_members[] = {
 int registerColorObject(lua_State *L)
 {
 	luaL_newmetatable(L, "colorObject");
-	lua_pushvalue(L, -1);
-	lua_setfield(L, -2, "__index");
+	//separate method table, so finalizer can not be called as a method
+	lua_newtable(L);
 	luaL_setfuncs(L, color_object_members, 0);
+	lua_setfield(L, -2, "__index");
+	UserdataPool::setFinalizer(L, UserdataPool::Type::colorObject);
 	lua_pop(L, 1);
 	luaL_newlib(L, color_object_functions);
 	return 1;
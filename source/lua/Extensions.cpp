@@ -43,12 +43,44 @@ static void checkArgumentIsFunctionOrNil(lua_State *L, int index)
 	bool type_matches = type == LUA_TFUNCTION || type == LUA_TNIL;
 	luaL_argcheck(L, type_matches, index, "function or nil expected");
 }
+/** Deserialize function can be nil when only serializeMany function is provided. */
+static Ref optionalFunction(lua_State *L, int index)
+{
+	if (lua_type(L, index) == LUA_TFUNCTION)
+		return Ref(L, index);
+	return Ref();
+}
+/** Objects which scripts add converters and callbacks into. Worker states have their own objects and ignore layouts. */
+struct Targets
+{
+	Converters *converters;
+	Callbacks *callbacks;
+	bool layouts;
+};
+static char targets_key;
+static void setTargets(lua_State *L, Converters &converters, Callbacks &callbacks, bool layouts)
+{
+	Targets *targets = reinterpret_cast<Targets*>(lua_newuserdata(L, sizeof(Targets)));
+	targets->converters = &converters;
+	targets->callbacks = &callbacks;
+	targets->layouts = layouts;
+	lua_rawsetp(L, LUA_REGISTRYINDEX, &targets_key);
+}
+static Targets &getTargets(lua_State *L)
+{
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &targets_key);
+	Targets &targets = *reinterpret_cast<Targets*>(lua_touserdata(L, -1));
+	lua_pop(L, 1);
+	return targets;
+}
 static int addLayout(lua_State *L)
 {
 	const char *name = luaL_checkstring(L, 2);
 	const char *label = luaL_checkstring(L, 3);
 	checkArgumentIsFunctionOrNil(L, 4);
 	int mask = luaL_optinteger(L, 5, 0);
+	if (!getTargets(L).layouts)
+		return 0;
 	getGlobalState(L).layouts().add(new layout::Layout(name, label, mask, Ref(L, 4)));
 	return 0;
 }
@@ -58,20 +90,24 @@ static int addConverter(lua_State *L)
 	const char *label = luaL_checkstring(L, 3);
 	checkArgumentIsFunctionOrNil(L, 4);
 	if (lua_gettop(L) >= 5) checkArgumentIsFunctionOrNil(L, 5);
+	if (lua_gettop(L) >= 6) checkArgumentIsFunctionOrNil(L, 6);
+	Converters &converters = *getTargets(L).converters;
 	if (lua_gettop(L) == 4)
-		getGlobalState(L).converters().add(new Converter(name, label, Ref(L, 4), Ref()));
-	else if (lua_gettop(L) >= 5)
-		getGlobalState(L).converters().add(new Converter(name, label, Ref(L, 4), Ref(L, 5)));
+		converters.add(new Converter(name, label, Ref(L, 4), Ref(), Ref()));
+	else if (lua_gettop(L) == 5)
+		converters.add(new Converter(name, label, Ref(L, 4), Ref(L, 5), Ref()));
+	else if (lua_gettop(L) >= 6)
+		converters.add(new Converter(name, label, Ref(L, 4), optionalFunction(L, 5), optionalFunction(L, 6)));
 	return 0;
 }
 static int setOptionChangeCallback(lua_State *L)
 {
-	getGlobalState(L).callbacks().optionChange(Ref(L, 2));
+	getTargets(L).callbacks->optionChange(Ref(L, 2));
 	return 0;
 }
 static int setComponentToTextCallback(lua_State *L)
 {
-	getGlobalState(L).callbacks().componentToText(Ref(L, 2));
+	getTargets(L).callbacks->componentToText(Ref(L, 2));
 	return 0;
 }
 static const struct luaL_Reg functions[] =
@@ -82,7 +118,7 @@ static const struct luaL_Reg functions[] =
 	{"setOptionChangeCallback", setOptionChangeCallback},
 	{nullptr, nullptr}
 };
-void registerAll(lua_State *L, GlobalState &global_state)
+static void registerExtensions(lua_State *L, GlobalState &global_state)
 {
 	Script script(L);
 	script.registerExtension("color", registerColor);
@@ -101,4 +137,14 @@ void registerAll(lua_State *L, GlobalState &global_state)
 	});
 	setGlobalState(L, global_state);
 }
+void registerAll(lua_State *L, GlobalState &global_state)
+{
+	registerExtensions(L, global_state);
+	setTargets(L, global_state.converters(), global_state.callbacks(), true);
+}
+void registerWorker(lua_State *L, GlobalState &global_state, Converters &converters, Callbacks &callbacks)
+{
+	registerExtensions(L, global_state);
+	setTargets(L, converters, callbacks, false);
+}
 }
@@ -20,8 +20,18 @@
 #define GPICK_LUA_EXTENSIONS_H_
 struct lua_State;
 struct GlobalState;
+struct Converters;
 namespace lua
 {
+struct Callbacks;
 void registerAll(lua_State *L, GlobalState &global_state);
+/**
+ * Register extensions into a worker state. Converters and callbacks added by scripts go into given objects instead of global state, and layouts are ignored.
+ * @param[in] L Worker Lua state.
+ * @param[in] global_state Global state.
+ * @param[in] converters Converters owned by worker.
+ * @param[in] callbacks Callbacks owned by worker.
+ */
+void registerWorker(lua_State *L, GlobalState &global_state, Converters &converters, Callbacks &callbacks);
 }
 #endif /* GPICK_LUA_EXTENSIONS_H_ */
@@ -18,6 +18,7 @@
 
 #include "Script.h"
 #include <sstream>
+#include <cstdlib>
 extern "C"{
 #include <lualib.h>
 #include <lauxlib.h>
@@ -26,10 +27,35 @@ extern "C"{
 using namespace std;
 namespace lua
 {
+struct AllocationCounter
+{
+	uint64_t allocated;
+};
+static void *allocate(void *userdata, void *pointer, size_t old_size, size_t new_size)
+{
+	if (new_size == 0){
+		free(pointer);
+		return nullptr;
+	}
+	//when pointer is nullptr, old_size contains type of new object
+	if (pointer == nullptr)
+		old_size = 0;
+	if (new_size > old_size)
+		reinterpret_cast<AllocationCounter*>(userdata)->allocated += new_size - old_size;
+	return realloc(pointer, new_size);
+}
+static int panic(lua_State *L)
+{
+	//error object is not necessarily a string
+	const char *message = lua_tostring(L, -1);
+	cerr << "PANIC: unprotected error in call to Lua API (" << (message != nullptr ? message : "error object is not a string") << ")" << endl;
+	return 0;
+}
 Script::Script()
 {
-	m_state = luaL_newstate();
+	m_state = lua_newstate(allocate, new AllocationCounter{0});
 	m_state_owned = true;
+	lua_atpanic(m_state, panic);
 	luaL_openlibs(m_state);
 }
 Script::Script(lua_State *state)
@@ -39,8 +65,12 @@ Script::Script(lua_State *state)
 }
 Script::~Script()
 {
-	if (m_state_owned)
+	if (m_state_owned){
+		void *counter;
+		lua_getallocf(m_state, &counter);
 		lua_close(m_state);
+		delete reinterpret_cast<AllocationCounter*>(counter);
+	}
 	m_state = nullptr;
 }
 Script::operator lua_State*()
@@ -139,4 +169,11 @@ const std::string &Script::getLastError()
 {
 	return m_last_error;
 }
+uint64_t allocatedBytes(lua_State *L)
+{
+	void *counter;
+	if (lua_getallocf(L, &counter) != allocate)
+		return 0;
+	return reinterpret_cast<AllocationCounter*>(counter)->allocated;
+}
 }
@@ -21,6 +21,7 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <cstdint>
 struct lua_State;
 struct luaL_Reg;
 namespace lua
@@ -44,5 +45,11 @@ struct Script
 	bool m_state_owned;
 	std::string m_last_error;
 };
+/**
+ * Get number of bytes allocated by Lua state since its creation. Freed memory is not subtracted, so difference between two calls shows garbage collector pressure.
+ * @param[in] L Lua state created by Script.
+ * @return Allocated bytes, or 0 if state was not created by Script.
+ */
+uint64_t allocatedBytes(lua_State *L);
 }
 #endif /* GPICK_LUA_SCRIPT_H_ */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "UserdataPool.h"
+#include "../Color.h"
+#include "../ColorObject.h"
+extern "C"{
+#include <lualib.h>
+#include <lauxlib.h>
+}
+namespace lua
+{
+/** Free list does not grow above this size, remaining collected userdata is freed. */
+static const size_t max_free_count = 4096;
+static const char *metatable_names[] = {"color", "colorObject"};
+static const size_t userdata_sizes[] = {sizeof(Color), sizeof(ColorObject*)};
+struct PoolState
+{
+	int depth;
+	size_t handle_count;
+	size_t free_counts[2];
+};
+static char pool_state_key, handles_key, free_list_keys[2];
+static PoolState *getPoolState(lua_State *L)
+{
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &pool_state_key);
+	PoolState *state = reinterpret_cast<PoolState*>(lua_touserdata(L, -1));
+	lua_pop(L, 1);
+	if (state != nullptr)
+		return state;
+	state = reinterpret_cast<PoolState*>(lua_newuserdata(L, sizeof(PoolState)));
+	state->depth = 0;
+	state->handle_count = 0;
+	state->free_counts[0] = state->free_counts[1] = 0;
+	lua_rawsetp(L, LUA_REGISTRYINDEX, &pool_state_key);
+	lua_newtable(L);
+	lua_rawsetp(L, LUA_REGISTRYINDEX, &handles_key);
+	for (auto &key: free_list_keys){
+		lua_newtable(L);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &key);
+	}
+	return state;
+}
+UserdataPool::UserdataPool(lua_State *L):
+	m_L(L)
+{
+	PoolState *state = getPoolState(L);
+	state->depth++;
+	m_mark = state->handle_count;
+}
+UserdataPool::~UserdataPool()
+{
+	release();
+	getPoolState(m_L)->depth--;
+}
+void UserdataPool::release()
+{
+	PoolState *state = getPoolState(m_L);
+	if (state->handle_count == m_mark)
+		return;
+	lua_rawgetp(m_L, LUA_REGISTRYINDEX, &handles_key);
+	for (size_t i = m_mark + 1; i <= state->handle_count; i++){
+		lua_rawgeti(m_L, -1, i);
+		*reinterpret_cast<ColorObject**>(lua_touserdata(m_L, -1)) = nullptr;
+		lua_pop(m_L, 1);
+		//handle is not referenced by pool anymore, so it can be collected and recycled once scripts do not reference it too
+		lua_pushnil(m_L);
+		lua_rawseti(m_L, -2, i);
+	}
+	lua_pop(m_L, 1);
+	state->handle_count = m_mark;
+}
+void *UserdataPool::push(lua_State *L, Type type)
+{
+	PoolState *state = getPoolState(L);
+	size_t index = static_cast<size_t>(type);
+	void *userdata;
+	if (state->free_counts[index] > 0){
+		size_t free_index = state->free_counts[index]--;
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &free_list_keys[index]);
+		lua_rawgeti(L, -1, free_index);
+		lua_pushnil(L);
+		lua_rawseti(L, -3, free_index);
+		lua_remove(L, -2);
+		userdata = lua_touserdata(L, -1);
+	}else{
+		userdata = lua_newuserdata(L, userdata_sizes[index]);
+	}
+	//setting metatable marks recycled userdata for finalization again
+	luaL_getmetatable(L, metatable_names[index]);
+	lua_setmetatable(L, -2);
+	if (type == Type::colorObject && state->depth > 0){
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &handles_key);
+		lua_pushvalue(L, -2);
+		lua_rawseti(L, -2, ++state->handle_count);
+		lua_pop(L, 1);
+	}
+	return userdata;
+}
+template<UserdataPool::Type type>
+static int recycle(lua_State *L)
+{
+	PoolState *state = getPoolState(L);
+	size_t index = static_cast<size_t>(type);
+	void *userdata = lua_touserdata(L, 1);
+	if (userdata == nullptr || state->free_counts[index] >= max_free_count)
+		return 0;
+	if (type == UserdataPool::Type::colorObject)
+		*reinterpret_cast<ColorObject**>(userdata) = nullptr;
+	//storing userdata in free list resurrects it, finalizer is not called again until push() sets metatable
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &free_list_keys[index]);
+	lua_pushvalue(L, 1);
+	lua_rawseti(L, -2, state->free_counts[index] + 1);
+	lua_pop(L, 1);
+	state->free_counts[index]++;
+	return 0;
+}
+void UserdataPool::setFinalizer(lua_State *L, Type type)
+{
+	if (type == Type::color)
+		lua_pushcfunction(L, recycle<Type::color>);
+	else
+		lua_pushcfunction(L, recycle<Type::colorObject>);
+	lua_setfield(L, -2, "__gc");
+}
+}
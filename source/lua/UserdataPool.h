@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GPICK_LUA_USERDATA_POOL_H_
+#define GPICK_LUA_USERDATA_POOL_H_
+#include <cstddef>
+struct lua_State;
+namespace lua
+{
+/** \struct UserdataPool
+ * \brief Recycles color and color object userdata, and invalidates color object handles pushed to Lua during a scope.
+ *
+ * Converters are called for every color in picker and export paths, and new userdata for every call keeps Lua memory allocator busy.
+ * Color and color object userdata have a finalizer which puts collected userdata into a free list, and push() takes userdata from that list before allocating new userdata.
+ * Userdata is reused only after garbage collector has found it unreachable, so values kept by scripts are never overwritten.
+ * Color objects are owned by C++ code and can be destroyed after the call, so color object handles pushed while a scope is active are invalidated when scope ends or release() is called.
+ * Using invalidated handle raises a Lua error. Scopes can be nested.
+ */
+struct UserdataPool
+{
+	enum class Type
+	{
+		color,
+		colorObject,
+	};
+	UserdataPool(lua_State *L);
+	~UserdataPool();
+	/** Invalidate all color object handles pushed since scope construction or previous release() call. */
+	void release();
+	/**
+	 * Push userdata with type metatable set. Userdata taken from free list contains values of previous use.
+	 * @param[in] L Lua state.
+	 * @param[in] type Userdata type, determines size and metatable of userdata.
+	 * @return Userdata pushed onto stack.
+	 */
+	static void *push(lua_State *L, Type type);
+	/**
+	 * Set finalizer, which returns collected userdata into free list, as "__gc" field of metatable on top of stack.
+	 * @param[in] L Lua state.
+	 * @param[in] type Userdata type of metatable.
+	 */
+	static void setFinalizer(lua_State *L, Type type);
+	private:
+	lua_State *m_L;
+	size_t m_mark;
+	UserdataPool(const UserdataPool &) = delete;
+	UserdataPool &operator=(const UserdataPool &) = delete;
+};
+}
+#endif /* GPICK_LUA_USERDATA_POOL_H_ */
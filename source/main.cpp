@@ -23,9 +23,11 @@
 #include "I18N.h"
 #include "version/Version.h"
 #include "DynvHelpers.h"
+#include "Batch.h"
 #include <gtk/gtk.h>
 #include <string>
 #include <iostream>
+#include <string.h>
 using namespace std;
 
 static gchar **commandline_filename = nullptr;
@@ -53,6 +55,8 @@ static GOptionEntry commandline_entries[] =
 int main(int argc, char **argv)
 {
 	setlocale(LC_ALL, "");
+	if (argc > 1 && strcmp(argv[1], "batch") == 0)
+		return batch_main(argc - 1, argv + 1);
 	gtk_init(&argc, &argv);
 	initialize_i18n();
 	g_set_application_name(program_name);
@@ -17,6 +17,11 @@
  */
 
 #include "TextFile.h"
+#include "Color.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstring>
 
 namespace text_file_parser {
 	Configuration::Configuration()
@@ -32,11 +37,146 @@ namespace text_file_parser {
 		int_values = true;
 	}
 	bool scanner(TextFile &text_file, const Configuration &configuration);
+	bool scanner(TextFile &text_file, const Configuration &configuration, const char *data, size_t length, int &state);
+	bool scannerStateIsMain(int state);
 	bool TextFile::parse(const Configuration &configuration)
 	{
 		return scanner(*this, configuration);
 	}
+	bool TextFile::parse(const Configuration &configuration, const char *data, size_t length)
+	{
+		int state = -1;
+		return scanner(*this, configuration, data, length, state);
+	}
+	/** Collects results of a single chunk, so that they can be delivered to the real TextFile in source order. */
+	struct ChunkTextFile: public TextFile
+	{
+		const char *m_data;
+		size_t m_length;
+		int m_state;
+		bool m_error;
+		size_t m_error_line, m_error_start_column, m_error_end_column;
+		std::vector<Color> m_colors;
+		ChunkTextFile(const char *data, size_t length):
+			m_data(data),
+			m_length(length),
+			m_state(-1),
+			m_error(false)
+		{
+		}
+		virtual ~ChunkTextFile()
+		{
+		}
+		virtual void outOfMemory()
+		{
+			m_error = true;
+		}
+		virtual void syntaxError(size_t start_line, size_t start_column, size_t end_line, size_t end_colunn)
+		{
+			m_error = true;
+			m_error_line = start_line;
+			m_error_start_column = start_column;
+			m_error_end_column = end_colunn;
+		}
+		virtual size_t read(char *buffer, size_t length)
+		{
+			return 0;
+		}
+		virtual void addColor(const Color &color)
+		{
+			m_colors.push_back(color);
+		}
+		virtual void addColors(const Color *colors, size_t count)
+		{
+			m_colors.insert(m_colors.end(), colors, colors + count);
+		}
+		void scan(const Configuration &configuration, int state)
+		{
+			m_colors.clear();
+			m_error = false;
+			m_state = state;
+			scanner(*this, configuration, m_data, m_length, m_state);
+		}
+	};
+	static bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+	}
+	/** Check if input can be split right after the newline at given position. Tokens can contain whitespace only after a digit, comma or opening parenthesis, so newline is safe to split at when last non whitespace character before it is something else. */
+	static bool isSafeSplit(const char *data, size_t newline)
+	{
+		size_t i = newline;
+		while (i > 0 && isSpace(data[i - 1]))
+			i--;
+		if (i == 0)
+			return true;
+		char c = data[i - 1];
+		return !((c >= '0' && c <= '9') || c == ',' || c == '(');
+	}
+	bool TextFile::parse(const Configuration &configuration, const char *data, size_t length, size_t threads)
+	{
+		const size_t min_chunk_size = 1024 * 1024;
+		if (threads > length / min_chunk_size)
+			threads = length / min_chunk_size;
+		if (threads <= 1)
+			return parse(configuration, data, length);
+		std::vector<size_t> boundaries;
+		boundaries.push_back(0);
+		for (size_t i = 1; i < threads; i++){
+			size_t position = std::max(length / threads * i, boundaries.back());
+			for (;;){
+				const char *newline = static_cast<const char*>(memchr(data + position, '\n', length - position));
+				if (newline == nullptr){
+					position = length;
+					break;
+				}
+				position = newline - data;
+				if (isSafeSplit(data, position)){
+					position++;
+					break;
+				}
+				position++;
+			}
+			if (position >= length)
+				break;
+			if (position > boundaries.back())
+				boundaries.push_back(position);
+		}
+		boundaries.push_back(length);
+		std::vector<ChunkTextFile> chunks;
+		chunks.reserve(boundaries.size() - 1);
+		for (size_t i = 0; i + 1 < boundaries.size(); i++)
+			chunks.emplace_back(data + boundaries[i], boundaries[i + 1] - boundaries[i]);
+		//every chunk is scanned assuming it does not start inside of a multi-line comment
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < chunks.size(); i++)
+			workers.emplace_back(&ChunkTextFile::scan, &chunks[i], std::cref(configuration), -1);
+		chunks[0].scan(configuration, -1);
+		for (auto &worker: workers)
+			worker.join();
+		//if previous chunk ended inside of a comment, the assumption was wrong and the chunk is scanned again continuing from the previous chunk state
+		for (size_t i = 1; i < chunks.size(); i++){
+			if (!scannerStateIsMain(chunks[i - 1].m_state))
+				chunks[i].scan(configuration, chunks[i - 1].m_state);
+		}
+		size_t line = 0;
+		for (auto &chunk: chunks){
+			if (chunk.m_error){
+				syntaxError(line + chunk.m_error_line, chunk.m_error_start_column, line + chunk.m_error_line, chunk.m_error_end_column);
+				return false;
+			}
+			if (!chunk.m_colors.empty())
+				addColors(&chunk.m_colors.front(), chunk.m_colors.size());
+			line += std::count(chunk.m_data, chunk.m_data + chunk.m_length, '\n');
+		}
+		return true;
+	}
 	TextFile::~TextFile()
 	{
 	}
+	void TextFile::addColors(const Color *colors, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			addColor(colors[i]);
+	}
 }
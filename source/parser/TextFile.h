@@ -37,12 +37,19 @@ namespace text_file_parser
 	};
 	struct TextFile
 	{
+		/** Parse text by reading it in chunks through read(). */
 		bool parse(const Configuration &configuration);
+		/** Parse text which is already fully available in memory (for example a memory mapped file). Input is scanned in place, read() is not used. */
+		bool parse(const Configuration &configuration, const char *data, size_t length);
+		/** Parse text which is fully available in memory using up to "threads" threads. Input is split into chunks at newlines which can not be a part of any color, chunks are scanned in parallel and colors are delivered in source order, so the result is identical to the single threaded parse. */
+		bool parse(const Configuration &configuration, const char *data, size_t length, size_t threads);
 		virtual ~TextFile();
 		virtual void outOfMemory() = 0;
 		virtual void syntaxError(size_t start_line, size_t start_column, size_t end_line, size_t end_colunn) = 0;
 		virtual size_t read(char *buffer, size_t length) = 0;
 		virtual void addColor(const Color &color) = 0;
+		/** Receives found colors in batches. Default implementation calls addColor() for each color. */
+		virtual void addColors(const Color *colors, size_t count);
 	};
 }
 #endif /* GPICK_PARSER_TEXT_FILE_H_ */
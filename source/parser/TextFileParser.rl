@@ -3,13 +3,36 @@
 #include <string.h>
 #include <stdlib.h>
 #include <cstddef>
-#include <functional>
-#include <vector>
+#include <cstdint>
 #include <string>
 #include <iostream>
 using namespace std;
 namespace text_file_parser
 {
+/** Keeps last few parsed numbers. Scanner runs several patterns at once and backtracks, so only the most recently pushed values belong to the matched token. */
+template<typename T>
+struct NumberStack
+{
+	T values[4];
+	size_t count;
+	NumberStack():
+		count(0)
+	{
+	}
+	void push(T value)
+	{
+		values[count++ & 3] = value;
+	}
+	/** Get value by index, counting from the first of last "size" values. */
+	T get(size_t size, size_t index) const
+	{
+		return values[(count - size + index) & 3];
+	}
+	void clear()
+	{
+		count = 0;
+	}
+};
 struct FSM
 {
 	public:
@@ -17,24 +40,39 @@ struct FSM
 		char separator;
 		int act;
 		int top;
-		char *ts;
-		char *te;
+		const char *ts;
+		const char *te;
 		int stack[256];
 		char buffer[8 * 1024];
-		int line;
+		const char *base;
+		size_t line;
 		int column;
-		int line_start;
+		ptrdiff_t line_start;
 		int buffer_offset;
 		int64_t number_i64;
-		vector<int64_t> numbers_i64;
-		char *number_double_start;
-		vector<double> numbers_double;
-		function<void(const Color&)> addColor;
+		NumberStack<int64_t> numbers_i64;
+		const char *number_double_start;
+		NumberStack<double> numbers_double;
+		TextFile *text_file;
+		Color colors[256];
+		size_t color_count;
+		FSM(TextFile &text_file):
+			ts(nullptr),
+			te(nullptr),
+			base(nullptr),
+			line(0),
+			column(0),
+			line_start(0),
+			buffer_offset(0),
+			text_file(&text_file),
+			color_count(0)
+		{
+		}
 		void handleNewline()
 		{
 			line++;
 			column = 0;
-			line_start = te - buffer;
+			line_start = te - base;
 		}
 		int hexToInt(char hex)
 		{
@@ -47,6 +85,19 @@ struct FSM
 		{
 			return hexToInt(hex_pair[0]) << 4 | hexToInt(hex_pair[1]);
 		}
+		void addColor(Color &color)
+		{
+			color_rgb_normalize(&color);
+			colors[color_count++] = color;
+			if (color_count == sizeof(colors) / sizeof(colors[0]))
+				flushColors();
+		}
+		void flushColors()
+		{
+			if (color_count == 0) return;
+			text_file->addColors(colors, color_count);
+			color_count = 0;
+		}
 		void colorHexFull(bool with_hash_symbol)
 		{
 			Color color;
@@ -69,48 +120,53 @@ struct FSM
 		void colorRgb()
 		{
 			Color color;
-			color.rgb.red = numbers_i64[0] / 255.0;
-			color.rgb.green = numbers_i64[1] / 255.0;
-			color.rgb.blue = numbers_i64[2] / 255.0;
+			color.rgb.red = numbers_i64.get(3, 0) / 255.0;
+			color.rgb.green = numbers_i64.get(3, 1) / 255.0;
+			color.rgb.blue = numbers_i64.get(3, 2) / 255.0;
 			color.ma[3] = 0;
-			numbers_i64.clear();
+			clearNumberStacks();
 			addColor(color);
 		}
 		void colorRgba()
 		{
 			Color color;
-			color.rgb.red = numbers_i64[0] / 255.0;
-			color.rgb.green = numbers_i64[1] / 255.0;
-			color.rgb.blue = numbers_i64[2] / 255.0;
-			color.ma[3] = numbers_double[0];
-			numbers_i64.clear();
-			numbers_double.clear();
+			color.rgb.red = numbers_i64.get(3, 0) / 255.0;
+			color.rgb.green = numbers_i64.get(3, 1) / 255.0;
+			color.rgb.blue = numbers_i64.get(3, 2) / 255.0;
+			color.ma[3] = numbers_double.get(1, 0);
+			clearNumberStacks();
 			addColor(color);
 		}
 		void colorValues()
 		{
 			Color color;
-			color.rgb.red = numbers_double[0];
-			color.rgb.green = numbers_double[1];
-			color.rgb.blue = numbers_double[2];
+			color.rgb.red = numbers_double.get(3, 0);
+			color.rgb.green = numbers_double.get(3, 1);
+			color.rgb.blue = numbers_double.get(3, 2);
 			color.ma[3] = 0;
-			numbers_double.clear();
+			clearNumberStacks();
 			addColor(color);
 		}
 		void colorValueIntegers()
 		{
 			Color color;
-			color.rgb.red = numbers_i64[0] / 255.0;
-			color.rgb.green = numbers_i64[1] / 255.0;
-			color.rgb.blue = numbers_i64[2] / 255.0;
+			color.rgb.red = numbers_i64.get(3, 0) / 255.0;
+			color.rgb.green = numbers_i64.get(3, 1) / 255.0;
+			color.rgb.blue = numbers_i64.get(3, 2) / 255.0;
 			color.ma[3] = 0;
-			numbers_i64.clear();
+			clearNumberStacks();
 			addColor(color);
 		}
 		double parseDouble(const char *start, const char *end)
 		{
-			string v(start, end);
-			return stod(v.c_str());
+			//number is copied into a small local buffer, because input is not zero terminated when scanning mapped memory
+			char value[64];
+			size_t length = end - start;
+			if (length >= sizeof(value))
+				return stod(string(start, end));
+			memcpy(value, start, length);
+			value[length] = 0;
+			return strtod(value, nullptr);
 		}
 		void clearNumberStacks()
 		{
@@ -126,8 +182,8 @@ struct FSM
 	number_i64 = digit+ >{ fsm->number_i64 = 0; } ${ fsm->number_i64 = fsm->number_i64 * 10 + (*p - '0'); };
 	sign = '-' | '+';
 	number_double = sign? (([0-9]+ '.' [0-9]+) | ('.' [0-9]+) | ([0-9]+)) ('e'i sign? digit+)?;
-	number = number_i64 %{ fsm->numbers_i64.push_back(fsm->number_i64); };
-	real_number = number_double >{ fsm->number_double_start = p; } %{ fsm->numbers_double.push_back(fsm->parseDouble(fsm->number_double_start, p)); };
+	number = number_i64 %{ fsm->numbers_i64.push(fsm->number_i64); };
+	real_number = number_double >{ fsm->number_double_start = p; } %{ fsm->numbers_double.push(fsm->parseDouble(fsm->number_double_start, p)); };
 
 	newline = ('\n' | '\r\n') @{ fsm->handleNewline(); };
 	anything = any | newline;
@@ -158,32 +214,22 @@ struct FSM
 
 bool scanner(TextFile &text_file, const Configuration &configuration)
 {
-	FSM fsm_struct;
+	FSM fsm_struct(text_file);
 	FSM *fsm = &fsm_struct;
-	fsm->ts = 0;
-	fsm->te = 0;
-	fsm->line = 0;
-	fsm->line_start = 0;
-	fsm->column = 0;
-	fsm->buffer_offset = 0;
+	fsm->base = fsm->buffer;
 	bool parse_error = false;
-	fsm->addColor = [&text_file](const Color &color){
-		Color c = color;
-		color_rgb_normalize(&c);
-		text_file.addColor(c);
-	};
 	%% write init;
 	int have = 0;
 	while (1){
-		char *p = fsm->buffer + have;
+		const char *p = fsm->buffer + have;
 		int space = sizeof(fsm->buffer) - have;
 		if (space == 0){
 			text_file.outOfMemory();
 			break;
 		}
-		char *eof = 0;
+		const char *eof = 0;
 		auto read_size = text_file.read(fsm->buffer + have, space);
-		char *pe = p + read_size;
+		const char *pe = p + read_size;
 		if (read_size > 0){
 			if (read_size < sizeof(fsm->buffer)) eof = pe;
 			%% write exec;
@@ -208,7 +254,32 @@ bool scanner(TextFile &text_file, const Configuration &configuration)
 			break;
 		}
 	}
+	fsm->flushColors();
 	return parse_error == false;
 }
+bool scanner(TextFile &text_file, const Configuration &configuration, const char *data, size_t length, int &state)
+{
+	FSM fsm_struct(text_file);
+	FSM *fsm = &fsm_struct;
+	fsm->base = data;
+	bool parse_error = false;
+	%% write init;
+	if (state >= 0) fsm->cs = state; //continue from the state previous part of input ended with
+	const char *p = data;
+	const char *pe = data + length;
+	const char *eof = pe;
+	%% write exec;
+	state = fsm->cs;
+	if (fsm->cs == text_file_error) {
+		parse_error = true;
+		text_file.syntaxError(fsm->line, fsm->ts - data - fsm->line_start, fsm->line, fsm->te - data - fsm->line_start);
+	}
+	fsm->flushColors();
+	return parse_error == false;
+}
+bool scannerStateIsMain(int state)
+{
+	return state < 0 || state == text_file_en_main;
+}
 
 }
@@ -0,0 +1,190 @@
+#include <boost/test/unit_test.hpp>
+#include "lua/BytecodeCache.h"
+#include "lua/Script.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string>
+#include <vector>
+extern "C"{
+#include <lualib.h>
+#include <lauxlib.h>
+}
+using namespace std;
+using namespace lua;
+
+namespace {
+struct CacheFixture
+{
+	string directory, filename, cache_filename;
+	Script script;
+	CacheFixture()
+	{
+		gchar *path = g_dir_make_tmp("gpick-test-XXXXXX", nullptr);
+		BOOST_REQUIRE(path != nullptr);
+		directory = path;
+		g_free(path);
+		gchar *cache_path = g_build_filename(directory.c_str(), "cache", nullptr);
+		g_mkdir(cache_path, 0700);
+		g_free(cache_path);
+		filename = directory + G_DIR_SEPARATOR_S + "module.lua";
+		writeFile(filename, "return 1");
+		gchar *checksum = g_compute_checksum_for_string(G_CHECKSUM_MD5, filename.c_str(), -1);
+		cache_filename = cachePath() + G_DIR_SEPARATOR_S + checksum + ".luac";
+		g_free(checksum);
+	}
+	~CacheFixture()
+	{
+		g_remove(cache_filename.c_str());
+		g_remove(filename.c_str());
+		g_rmdir(cachePath().c_str());
+		g_rmdir(directory.c_str());
+	}
+	string cachePath()
+	{
+		return directory + G_DIR_SEPARATOR_S + "cache";
+	}
+	static void writeFile(const string &filename, const string &contents)
+	{
+		BOOST_REQUIRE(g_file_set_contents(filename.c_str(), contents.data(), contents.length(), nullptr));
+	}
+	static string readFile(const string &filename)
+	{
+		gchar *contents;
+		gsize length;
+		if (!g_file_get_contents(filename.c_str(), &contents, &length, nullptr))
+			return "";
+		string result(contents, length);
+		g_free(contents);
+		return result;
+	}
+	static int writeChunk(lua_State *, const void *data, size_t size, void *userdata)
+	{
+		reinterpret_cast<string*>(userdata)->append(reinterpret_cast<const char*>(data), size);
+		return 0;
+	}
+	/** Compile code which returns given value into a binary chunk. */
+	string compile(int value)
+	{
+		string code = "return " + to_string(value), chunk;
+		BOOST_REQUIRE(luaL_loadstring(script, code.c_str()) == LUA_OK);
+		lua_dump(script, writeChunk, &chunk, 0);
+		lua_pop(script, 1);
+		return chunk;
+	}
+	/** Cache header lines: magic, Lua release, file name, modification time and size. */
+	vector<string> cacheHeader()
+	{
+		string contents = readFile(cache_filename);
+		vector<string> lines;
+		size_t start = 0;
+		for (int i = 0; i < 4; i++){
+			size_t end = contents.find('\n', start);
+			BOOST_REQUIRE(end != string::npos);
+			lines.push_back(contents.substr(start, end - start + 1));
+			start = end + 1;
+		}
+		return lines;
+	}
+	/** Load file through cache and return result of chunk call. */
+	int load()
+	{
+		BOOST_REQUIRE(loadCachedFile(script, filename.c_str(), cachePath().c_str()) == LUA_OK);
+		BOOST_REQUIRE(lua_pcall(script, 0, 1, 0) == LUA_OK);
+		int result = static_cast<int>(lua_tointeger(script, -1));
+		lua_pop(script, 1);
+		return result;
+	}
+	/** Replace cached chunk with chunk returning 2, changing one header line. */
+	void replaceCachedChunk(size_t line, const string &value)
+	{
+		vector<string> header = cacheHeader();
+		header[line] = value;
+		string contents;
+		for (auto &header_line: header)
+			contents += header_line;
+		writeFile(cache_filename, contents + compile(2));
+	}
+};
+}
+BOOST_FIXTURE_TEST_SUITE(bytecode_cache, CacheFixture)
+BOOST_AUTO_TEST_CASE(reuse)
+{
+	BOOST_CHECK(load() == 1);
+	BOOST_REQUIRE(g_file_test(cache_filename.c_str(), G_FILE_TEST_EXISTS));
+	BOOST_CHECK(cacheHeader()[0] == "gpick lua chunk\n");
+	BOOST_CHECK(cacheHeader()[1] == string(LUA_RELEASE) + "\n");
+	//valid cache entry is used instead of source file
+	replaceCachedChunk(0, "gpick lua chunk\n");
+	BOOST_CHECK(load() == 2);
+	BOOST_CHECK(load() == 2);
+}
+BOOST_AUTO_TEST_CASE(stale_header)
+{
+	BOOST_CHECK(load() == 1);
+	vector<string> header = cacheHeader();
+	string mtime = header[3].substr(0, header[3].find(' '));
+	string size = header[3].substr(header[3].find(' ') + 1);
+	replaceCachedChunk(3, to_string(stoll(mtime) + 1) + " " + size);
+	BOOST_CHECK(load() == 1);
+	replaceCachedChunk(3, mtime + " " + to_string(stoll(size) + 1) + "\n");
+	BOOST_CHECK(load() == 1);
+	replaceCachedChunk(1, "Lua 0.0.0\n");
+	BOOST_CHECK(load() == 1);
+	//rejected entries are replaced by a valid one
+	replaceCachedChunk(0, header[0]);
+	BOOST_CHECK(load() == 2);
+	//edited source file is compiled again
+	writeFile(filename, "return 3 ");
+	BOOST_CHECK(load() == 3);
+}
+BOOST_AUTO_TEST_CASE(corrupt_file)
+{
+	BOOST_CHECK(load() == 1);
+	vector<string> header = cacheHeader();
+	string contents;
+	for (auto &header_line: header)
+		contents += header_line;
+	writeFile(cache_filename, contents + "not a chunk");
+	BOOST_CHECK(load() == 1);
+	writeFile(cache_filename, contents.substr(0, 10));
+	BOOST_CHECK(load() == 1);
+	BOOST_CHECK(cacheHeader() == header);
+}
+BOOST_AUTO_TEST_CASE(searcher)
+{
+	lua_State *L = script;
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "searchers");
+	size_t searcher_count = lua_rawlen(L, -1);
+	lua_rawgeti(L, -1, 1);
+	lua_rawgeti(L, -2, 2);
+	installBytecodeCache(L, cachePath().c_str());
+	BOOST_CHECK(lua_rawlen(L, -3) == searcher_count + 1);
+	lua_rawgeti(L, -3, 1);
+	BOOST_CHECK(lua_rawequal(L, -1, -3));
+	lua_rawgeti(L, -4, 3);
+	BOOST_CHECK(lua_rawequal(L, -1, -3));
+	lua_rawgeti(L, -5, 2);
+	BOOST_CHECK(lua_iscfunction(L, -1));
+	lua_pop(L, 6);
+	string path = directory + G_DIR_SEPARATOR_S + "?.lua";
+	lua_pushstring(L, path.c_str());
+	lua_setfield(L, -2, "path");
+	lua_pop(L, 1);
+	BOOST_REQUIRE(script.loadCode("return require(\"module\")"));
+	BOOST_REQUIRE_MESSAGE(script.run(0, 1), script.getLastError());
+	BOOST_CHECK(lua_tointeger(L, -1) == 1);
+	lua_pop(L, 1);
+	BOOST_CHECK(g_file_test(cache_filename.c_str(), G_FILE_TEST_EXISTS));
+}
+BOOST_AUTO_TEST_CASE(disable_cache)
+{
+	g_unsetenv("GPICK_NO_LUA_CACHE");
+	BOOST_CHECK(bytecodeCacheEnabled());
+	g_setenv("GPICK_NO_LUA_CACHE", "", TRUE);
+	BOOST_CHECK(bytecodeCacheEnabled());
+	g_setenv("GPICK_NO_LUA_CACHE", "1", TRUE);
+	BOOST_CHECK(!bytecodeCacheEnabled());
+	g_unsetenv("GPICK_NO_LUA_CACHE");
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <vector>
+#include "ColorDistance.h"
+#include "Color.h"
+using namespace std;
+
+static Color lab(float L, float a, float b)
+{
+	Color color;
+	color.lab.L = L;
+	color.lab.a = a;
+	color.lab.b = b;
+	color.ma[3] = 0;
+	return color;
+}
+BOOST_AUTO_TEST_CASE(ciede2000_reference_values)
+{
+	//pairs from CIEDE2000 test data by Sharma, Wu and Dalal
+	struct{
+		Color a, b;
+		float distance;
+	}pairs[] = {
+		{lab(50, 2.6772f, -79.7751f), lab(50, 0, -82.7485f), 2.0425f},
+		{lab(50, 0, 0), lab(50, -1, 2), 2.3669f},
+		{lab(50, 2.5f, 0), lab(73, 25, -18), 27.1492f},
+		{lab(50, 2.5f, 0), lab(50, 0, -2.5f), 4.3065f},
+		{lab(60.2574f, -34.0099f, 36.2677f), lab(60.4626f, -34.1751f, 39.4387f), 1.2644f},
+		{lab(22.7233f, 20.0904f, -46.6940f), lab(23.0331f, 14.9730f, -42.5619f), 2.0373f},
+		{lab(90.9257f, -0.5406f, -0.9208f), lab(88.6381f, -0.8985f, -0.7239f), 1.5381f},
+	};
+	for (auto &pair: pairs){
+		BOOST_CHECK_CLOSE(color_distance_ciede2000(&pair.a, &pair.b), pair.distance, 0.01);
+		BOOST_CHECK_CLOSE(color_distance_ciede2000(&pair.b, &pair.a), pair.distance, 0.01);
+		Color a, b;
+		float distance;
+		color_distance_ciede2000_metric.prepare(&pair.a, &a);
+		color_distance_ciede2000_metric.prepare(&pair.b, &b);
+		color_distance_ciede2000_metric.distances(a, &b, 1, &distance);
+		BOOST_CHECK_CLOSE(sqrt(distance), pair.distance, 0.01);
+	}
+}
+BOOST_AUTO_TEST_CASE(cam16ucs_reference_values)
+{
+	color_init();
+	Color white, black, result;
+	color_set(&white, 1.0f, 1.0f, 1.0f);
+	color_set(&black, 0.0f, 0.0f, 0.0f);
+	color_rgb_to_cam16ucs(&white, &result);
+	BOOST_CHECK_CLOSE(result.cam16ucs.J, 100.0f, 0.01);
+	color_rgb_to_cam16ucs(&black, &result);
+	BOOST_CHECK_SMALL(result.cam16ucs.J, 0.001f);
+	float previous = 0;
+	for (int i = 1; i <= 10; i++){
+		Color gray;
+		color_set(&gray, i / 10.0f);
+		color_rgb_to_cam16ucs(&gray, &result);
+		BOOST_CHECK(result.cam16ucs.J > previous);
+		previous = result.cam16ucs.J;
+	}
+}
+BOOST_AUTO_TEST_CASE(batch_distances)
+{
+	color_init();
+	mt19937 generator(1);
+	uniform_real_distribution<float> distribution(0, 1);
+	const size_t count = 1001;
+	vector<Color> colors(count), labs(count), cam16(count);
+	for (size_t i = 0; i < count; i++){
+		color_set(&colors[i], distribution(generator), distribution(generator), distribution(generator));
+		color_rgb_to_lab_d50(&colors[i], &labs[i]);
+		color_rgb_to_cam16ucs(&colors[i], &cam16[i]);
+	}
+	vector<Color> prepared(count);
+	vector<float> distances(count);
+	for (const ColorDistance *metric = color_distance_get_metrics(); metric->name; metric++){
+		for (size_t i = 0; i < count; i++)
+			metric->prepareRgb(colors[i], prepared[i]);
+		metric->distances(prepared[0], prepared.data(), count, distances.data());
+		for (size_t i = 0; i < count; i++){
+			float expected;
+			if (metric == &color_distance_cie76_metric){
+				float d0 = labs[i].lab.L - labs[0].lab.L, d1 = labs[i].lab.a - labs[0].lab.a, d2 = labs[i].lab.b - labs[0].lab.b;
+				expected = d0 * d0 + d1 * d1 + d2 * d2;
+			}else if (metric == &color_distance_cie94_metric){
+				expected = powf(color_distance_lch(&labs[i], &labs[0]), 2);
+			}else if (metric == &color_distance_ciede2000_metric){
+				expected = powf(color_distance_ciede2000(&labs[0], &labs[i]), 2);
+			}else{
+				expected = powf(color_distance_cam16ucs(&cam16[0], &cam16[i]), 2);
+			}
+			BOOST_CHECK_SMALL(distances[i] - expected, max(expected, 1.0f) * 0.001f);
+		}
+	}
+	BOOST_CHECK_EQUAL(&color_distance_get_metric("ciede2000", color_distance_cie94_metric), &color_distance_ciede2000_metric);
+	BOOST_CHECK_EQUAL(&color_distance_get_metric("unknown", color_distance_cie94_metric), &color_distance_cie94_metric);
+}
@@ -0,0 +1,197 @@
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <list>
+#include <set>
+#include <random>
+#include <vector>
+#include <cmath>
+#include "ColorListIndex.h"
+#include "ColorDistance.h"
+#include "ColorObject.h"
+#include "Color.h"
+using namespace std;
+
+static float lab_distance(const Color &a, const Color &b)
+{
+	Color a_lab, b_lab;
+	color_rgb_to_lab_d50(&a, &a_lab);
+	color_rgb_to_lab_d50(&b, &b_lab);
+	return static_cast<float>(sqrt(pow(a_lab.lab.L - b_lab.lab.L, 2) + pow(a_lab.lab.a - b_lab.lab.a, 2) + pow(a_lab.lab.b - b_lab.lab.b, 2)));
+}
+struct RandomColors
+{
+	mt19937 generator;
+	uniform_real_distribution<float> distribution;
+	vector<ColorObject*> color_objects;
+	RandomColors(size_t count):
+		generator(1),
+		distribution(0, 1)
+	{
+		color_init();
+		for (size_t i = 0; i < count; i++)
+			color_objects.push_back(new ColorObject("", next()));
+	}
+	~RandomColors()
+	{
+		for (auto color_object: color_objects)
+			color_object->release();
+	}
+	Color next()
+	{
+		Color color;
+		color_set(&color, distribution(generator), distribution(generator), distribution(generator));
+		return color;
+	}
+	vector<float> distances(const Color &color)
+	{
+		vector<float> result;
+		for (auto color_object: color_objects)
+			result.push_back(lab_distance(color, color_object->getColor()));
+		sort(result.begin(), result.end());
+		return result;
+	}
+};
+BOOST_AUTO_TEST_CASE(color_list_index_nearest)
+{
+	RandomColors colors(5000);
+	ColorListIndex index;
+	for (auto color_object: colors.color_objects)
+		index.add(color_object);
+	BOOST_CHECK_EQUAL(index.size(), 5000);
+	vector<ColorListIndex::Result> result;
+	for (int i = 0; i < 50; i++){
+		Color color = colors.next();
+		vector<float> expected = colors.distances(color);
+		index.nearest(color, 5, result);
+		BOOST_REQUIRE_EQUAL(result.size(), 5);
+		for (size_t j = 0; j < result.size(); j++){
+			BOOST_CHECK_CLOSE(result[j].first, expected[j], 0.01);
+			BOOST_CHECK_CLOSE(result[j].first, lab_distance(color, result[j].second->getColor()), 0.01);
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(color_list_index_radius)
+{
+	RandomColors colors(5000);
+	ColorListIndex index;
+	for (auto color_object: colors.color_objects)
+		index.add(color_object);
+	vector<ColorListIndex::Result> result;
+	for (int i = 0; i < 50; i++){
+		Color color = colors.next();
+		vector<float> expected = colors.distances(color);
+		index.withinRadius(color, 10, result);
+		size_t expected_count = upper_bound(expected.begin(), expected.end(), 10.0f) - expected.begin();
+		BOOST_CHECK_EQUAL(result.size(), expected_count);
+		for (auto &item: result)
+			BOOST_CHECK(item.first <= 10);
+	}
+}
+BOOST_AUTO_TEST_CASE(color_list_index_updates)
+{
+	RandomColors colors(1000);
+	ColorListIndex index;
+	for (auto color_object: colors.color_objects)
+		index.add(color_object);
+	vector<ColorListIndex::Result> result;
+	Color black, white;
+	color_set(&black, 0.0f, 0.0f, 0.0f);
+	color_set(&white, 1.0f, 1.0f, 1.0f);
+	colors.color_objects[10]->setColor(black);
+	index.nearest(black, 1, result);
+	BOOST_REQUIRE_EQUAL(result.size(), 1);
+	BOOST_CHECK_EQUAL(result[0].second, colors.color_objects[10]);
+	BOOST_CHECK_SMALL(result[0].first, 0.001f);
+	colors.color_objects[10]->setColor(white);
+	index.nearest(black, 1, result);
+	BOOST_REQUIRE_EQUAL(result.size(), 1);
+	BOOST_CHECK(result[0].second != colors.color_objects[10]);
+	index.nearest(white, 1, result);
+	BOOST_CHECK_EQUAL(result[0].second, colors.color_objects[10]);
+	index.remove(colors.color_objects[10]);
+	BOOST_CHECK_EQUAL(index.size(), 999);
+	index.nearest(white, 1, result);
+	BOOST_CHECK(result[0].second != colors.color_objects[10]);
+	index.clear();
+	BOOST_CHECK_EQUAL(index.size(), 0);
+	index.nearest(white, 1, result);
+	BOOST_CHECK(result.empty());
+}
+BOOST_AUTO_TEST_CASE(color_list_index_cluster)
+{
+	RandomColors colors(5000);
+	ColorListIndex index;
+	for (auto color_object: colors.color_objects)
+		index.add(color_object);
+	list<ColorObject*> color_objects(colors.color_objects.begin(), colors.color_objects.end());
+	vector<ColorListIndex::Cluster> clusters;
+	index.cluster(color_objects, 5, clusters);
+	BOOST_CHECK(!clusters.empty());
+	set<ColorObject*> representatives, members;
+	for (auto &cluster: clusters){
+		BOOST_CHECK(representatives.insert(cluster.representative).second);
+		for (auto member: cluster.members){
+			BOOST_CHECK(members.insert(member).second);
+			BOOST_CHECK(lab_distance(cluster.representative->getColor(), member->getColor()) <= 5.001f);
+		}
+	}
+	//colors which were kept are further than threshold from each other
+	vector<ColorObject*> kept;
+	for (auto color_object: colors.color_objects){
+		BOOST_CHECK(representatives.count(color_object) == 0 || members.count(color_object) == 0);
+		if (members.count(color_object) == 0)
+			kept.push_back(color_object);
+	}
+	BOOST_CHECK_EQUAL(kept.size() + members.size(), colors.color_objects.size());
+	for (size_t i = 0; i < kept.size(); i += 50){
+		for (size_t j = i + 1; j < kept.size(); j++)
+			BOOST_CHECK(lab_distance(kept[i]->getColor(), kept[j]->getColor()) > 4.999f);
+	}
+	index.cluster(color_objects, 0, clusters);
+	BOOST_CHECK(clusters.empty());
+}
+BOOST_AUTO_TEST_CASE(color_object_lab_cache)
+{
+	RandomColors colors(100);
+	for (auto color_object: colors.color_objects){
+		Color lab, lch, other = colors.next();
+		color_rgb_to_lab_d50(&color_object->getColor(), &lab);
+		color_lab_to_lch(&lab, &lch);
+		BOOST_CHECK_EQUAL(color_object->getLab().lab.L, lab.lab.L);
+		BOOST_CHECK_EQUAL(color_object->getLch().lch.C, lch.lch.C);
+		color_object->setColor(other);
+		Color other_lab, other_lch;
+		color_rgb_to_lab_d50(&other, &other_lab);
+		color_lab_to_lch(&other_lab, &other_lch);
+		BOOST_CHECK_EQUAL(color_object->getLab().lab.b, other_lab.lab.b);
+		BOOST_CHECK_EQUAL(color_object->getLch().lch.h, other_lch.lch.h);
+		float distance = color_distance_lch(&lab, &other_lab);
+		BOOST_CHECK_CLOSE(color_distance_lch_squared(&lab, &lch, &other_lab, &other_lch), distance * distance, 0.01);
+	}
+}
+BOOST_AUTO_TEST_CASE(color_list_index_metrics)
+{
+	RandomColors colors(2000);
+	for (auto metric: {&color_distance_ciede2000_metric, &color_distance_cam16ucs_metric}){
+		ColorListIndex index(*metric);
+		for (auto color_object: colors.color_objects)
+			index.add(color_object);
+		vector<Color> prepared(colors.color_objects.size());
+		for (size_t i = 0; i < prepared.size(); i++)
+			metric->prepareRgb(colors.color_objects[i]->getColor(), prepared[i]);
+		vector<float> expected(prepared.size());
+		vector<ColorListIndex::Result> result;
+		for (int i = 0; i < 20; i++){
+			Color color = colors.next(), query;
+			metric->prepareRgb(color, query);
+			metric->distances(query, prepared.data(), prepared.size(), expected.data());
+			sort(expected.begin(), expected.end());
+			index.nearest(color, 5, result);
+			BOOST_REQUIRE_EQUAL(result.size(), 5);
+			for (size_t j = 0; j < result.size(); j++)
+				BOOST_CHECK_CLOSE(result[j].first, sqrt(expected[j]), 0.01);
+			index.withinRadius(color, 10, result);
+			BOOST_CHECK_EQUAL(result.size(), static_cast<size_t>(upper_bound(expected.begin(), expected.end(), 100.0f) - expected.begin()));
+		}
+	}
+}
@@ -0,0 +1,22 @@
+#include <boost/test/unit_test.hpp>
+#include "ColorRYB.h"
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(ryb_hue_table_accuracy)
+{
+	color_ryb_init();
+	for (int i = 0; i <= 10000; i++){
+		double hue = i / 10000.0;
+		Color table, exact, hsv;
+		color_rybhue_to_rgb(hue, &table);
+		color_rybhue_to_rgb_exact(hue, &exact);
+		BOOST_CHECK_SMALL(table.rgb.red - exact.rgb.red, 0.0001f);
+		BOOST_CHECK_SMALL(table.rgb.green - exact.rgb.green, 0.0001f);
+		BOOST_CHECK_SMALL(table.rgb.blue - exact.rgb.blue, 0.0001f);
+		if (i == 0 || i == 10000) continue;
+		color_rgb_to_hsv(&exact, &hsv);
+		double ryb_hue;
+		BOOST_CHECK_EQUAL(color_rgbhue_to_rybhue(hsv.hsv.hue, &ryb_hue), 0);
+		BOOST_CHECK_SMALL(ryb_hue - hue, 0.00001);
+	}
+}
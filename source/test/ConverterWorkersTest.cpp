@@ -0,0 +1,190 @@
+#include <boost/test/unit_test.hpp>
+#include "ConverterWorkers.h"
+#include "GlobalState.h"
+#include "Converters.h"
+#include "Converter.h"
+#include "ColorObject.h"
+#include "Color.h"
+#include "lua/Script.h"
+#include <random>
+#include <vector>
+#include <string>
+#include <cmath>
+extern "C"{
+#include <lualib.h>
+#include <lauxlib.h>
+}
+using namespace std;
+
+namespace {
+struct ColorInitialization
+{
+	ColorInitialization()
+	{
+		color_init();
+	}
+};
+struct WorkersFixture: public ColorInitialization
+{
+	GlobalState global_state;
+	ConverterWorkers workers;
+	vector<ColorObject*> color_objects;
+	WorkersFixture():
+		workers(global_state, 3)
+	{
+		BOOST_REQUIRE(global_state.loadAll());
+	}
+	~WorkersFixture()
+	{
+		for (auto color_object: color_objects)
+			color_object->release();
+	}
+	void randomColorObjects(size_t count)
+	{
+		mt19937 generator(1);
+		uniform_real_distribution<float> distribution(0, 1);
+		for (size_t i = 0; i < count; i++){
+			Color color;
+			color_set(&color, distribution(generator), distribution(generator), distribution(generator));
+			color_objects.push_back(new ColorObject("", color));
+		}
+	}
+	Converter &converter(const char *name)
+	{
+		Converter *converter = global_state.converters().byName(name);
+		BOOST_REQUIRE(converter != nullptr);
+		return *converter;
+	}
+	/** Add converter, which exists only in main state, with serialize and deserialize functions returned by Lua code. */
+	Converter &addMainStateConverter(const char *code)
+	{
+		lua::Script &script = global_state.script();
+		BOOST_REQUIRE(script.loadCode(code));
+		BOOST_REQUIRE_MESSAGE(script.run(0, 2), script.getLastError());
+		lua_State *L = script;
+		Converter *converter = new Converter("test_main_state", "test", lua::Ref(L, -2), lua::Ref(L, -1), lua::Ref());
+		lua_pop(L, 2);
+		converter->paste(true);
+		global_state.converters().add(converter);
+		return *converter;
+	}
+	/** Deserialize in main state only, the first converter wins when qualities are equal. */
+	void deserializeSingle(const vector<Converter*> &converters, const vector<string> &texts, vector<ConverterWorkers::Deserialized> &result)
+	{
+		result.resize(texts.size());
+		for (size_t i = 0; i < texts.size(); i++){
+			result[i].quality = 0;
+			for (auto converter: converters){
+				ColorObject color_object;
+				float quality;
+				if (converter->deserialize(texts[i].c_str(), &color_object, quality) && quality > result[i].quality){
+					result[i].color = color_object.getColor();
+					result[i].name = color_object.getName();
+					result[i].quality = quality;
+				}
+			}
+		}
+	}
+	static bool closeColors(const Color &a, const Color &b)
+	{
+		return std::abs(a.rgb.red - b.rgb.red) < 1e-6f && std::abs(a.rgb.green - b.rgb.green) < 1e-6f && std::abs(a.rgb.blue - b.rgb.blue) < 1e-6f;
+	}
+	static void checkEqual(const vector<ConverterWorkers::Deserialized> &a, const vector<ConverterWorkers::Deserialized> &b)
+	{
+		BOOST_REQUIRE(a.size() == b.size());
+		for (size_t i = 0; i < a.size(); i++){
+			BOOST_CHECK_EQUAL(a[i].quality, b[i].quality);
+			if (a[i].quality > 0){
+				BOOST_CHECK(color_equal(&a[i].color, &b[i].color));
+				BOOST_CHECK_EQUAL(a[i].name, b[i].name);
+			}
+		}
+	}
+};
+/** Text with equal quality matches: hex code without hash at the start and hex code with hash at the end. */
+const char *tie_text = "112233#aabbcc";
+}
+BOOST_FIXTURE_TEST_SUITE(converter_workers, WorkersFixture)
+BOOST_AUTO_TEST_CASE(serialize)
+{
+	const size_t count = 4 * 4096 + 123;
+	randomColorObjects(count);
+	Converter &web_hex = converter("color_web_hex");
+	vector<string> expected, result;
+	web_hex.serialize(&color_objects.front(), count, ConverterSerializePosition(count), expected);
+	workers.serialize(web_hex, &color_objects.front(), count, ConverterSerializePosition(count), result);
+	BOOST_CHECK(workers.workerCount() == 3);
+	BOOST_REQUIRE(result.size() == count);
+	BOOST_CHECK(result == expected);
+}
+BOOST_AUTO_TEST_CASE(deserialize)
+{
+	const size_t count = 4 * 512 + 7;
+	randomColorObjects(count);
+	Converter &web_hex = converter("color_web_hex"), &no_hash = converter("color_web_hex_no_hash"), &css_rgb = converter("color_css_rgb");
+	vector<string> texts;
+	for (size_t i = 0; i < count; i++){
+		const Color &color = color_objects[i]->getColor();
+		switch (i % 4){
+			case 0:
+				texts.push_back(web_hex.serialize(color));
+				break;
+			case 1:
+				texts.push_back(css_rgb.serialize(color));
+				break;
+			case 2:
+				texts.push_back(tie_text);
+				break;
+			case 3:
+				texts.push_back("no color");
+				break;
+		}
+	}
+	for (auto &converters: vector<vector<Converter*>>{{&web_hex, &no_hash, &css_rgb}, {&no_hash, &web_hex, &css_rgb}}){
+		vector<ConverterWorkers::Deserialized> expected, result;
+		deserializeSingle(converters, texts, expected);
+		workers.deserialize(converters, texts, result);
+		BOOST_CHECK(workers.workerCount() == 3);
+		checkEqual(result, expected);
+		//tie is resolved by converter order in every range
+		Color tie;
+		if (converters[0] == &web_hex)
+			color_set(&tie, 0xaa / 255.0f, 0xbb / 255.0f, 0xcc / 255.0f);
+		else
+			color_set(&tie, 0x11 / 255.0f, 0x22 / 255.0f, 0x33 / 255.0f);
+		for (size_t i = 2; i < count; i += 4)
+			BOOST_CHECK(closeColors(result[i].color, tie));
+	}
+}
+BOOST_AUTO_TEST_CASE(main_state_converter)
+{
+	//workers do not have this converter, so all work must be done in main state
+	Converter &main_state = addMainStateConverter(
+		"return function(colorObject)\n"
+		"	return 'main ' .. colorObject:getColor():red()\n"
+		"end, function(text, colorObject)\n"
+		"	if text ~= 'main' then return -1 end\n"
+		"	local c = colorObject:getColor()\n"
+		"	c:rgb(0.5, 0.25, 0.125)\n"
+		"	colorObject:setColor(c)\n"
+		"	return 2\n"
+		"end");
+	const size_t serialize_count = 4 * 4096;
+	randomColorObjects(serialize_count);
+	vector<string> expected, result;
+	main_state.serialize(&color_objects.front(), serialize_count, ConverterSerializePosition(serialize_count), expected);
+	workers.serialize(main_state, &color_objects.front(), serialize_count, ConverterSerializePosition(serialize_count), result);
+	BOOST_REQUIRE(result.size() == serialize_count);
+	BOOST_CHECK(result == expected);
+	BOOST_CHECK(result.back().compare(0, 5, "main ") == 0);
+	vector<string> texts(4 * 512, "main");
+	texts.front() = "#aabbcc";
+	vector<Converter*> converters = {&converter("color_web_hex"), &main_state};
+	vector<ConverterWorkers::Deserialized> deserialized_expected, deserialized;
+	deserializeSingle(converters, texts, deserialized_expected);
+	workers.deserialize(converters, texts, deserialized);
+	checkEqual(deserialized, deserialized_expected);
+	BOOST_CHECK_EQUAL(deserialized.back().quality, 2);
+	BOOST_CHECK_EQUAL(deserialized.front().quality, 1);
+}
+BOOST_AUTO_TEST_SUITE_END()
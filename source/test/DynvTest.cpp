@@ -1,6 +1,8 @@
 #include <boost/test/unit_test.hpp>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <chrono>
 #include "dynv/DynvSystem.h"
 #include "dynv/DynvXml.h"
 #include "dynv/DynvVarString.h"
@@ -125,3 +127,43 @@ BOOST_AUTO_TEST_CASE(dynv_array_null)
 	delete [] values;
 	BOOST_CHECK(dynv_system_release(dynv) == 0);
 }
+BOOST_AUTO_TEST_CASE(xml_large_settings)
+{
+	auto dynv = buildDynv();
+	const size_t list_size = 20000, list_count = 25;
+	vector<string> strings;
+	vector<const char*> string_pointers;
+	for (size_t i = 0; i < list_size; i++){
+		strings.push_back("color name #" + to_string(i) + " <&>");
+	}
+	for (auto &value: strings){
+		string_pointers.push_back(value.c_str());
+	}
+	for (size_t i = 0; i < list_count; i++){
+		dynv_set_array(dynv, "string", ("lists.list" + to_string(i)).c_str(), (const void**)&string_pointers.front(), list_size);
+	}
+	stringstream xml;
+	auto start = chrono::steady_clock::now();
+	xml << "<?xml version=\"1.0\" encoding='UTF-8'?><root>\n";
+	BOOST_REQUIRE(dynv_xml_serialize(dynv, xml) == 0);
+	xml << "</root>\n";
+	auto serialized = chrono::steady_clock::now();
+	BOOST_CHECK(xml.str().size() > 10 * 1024 * 1024);
+	auto loaded = buildDynv();
+	BOOST_REQUIRE(dynv_xml_deserialize(loaded, xml) == 0);
+	auto deserialized = chrono::steady_clock::now();
+	BOOST_TEST_MESSAGE("serialized " << xml.str().size() << " bytes in " << chrono::duration_cast<chrono::milliseconds>(serialized - start).count() << " ms, deserialized in " << chrono::duration_cast<chrono::milliseconds>(deserialized - serialized).count() << " ms");
+	for (size_t i = 0; i < list_count; i++){
+		int error;
+		uint32_t count;
+		char** values = (char**)dynv_get_array(loaded, "string", ("lists.list" + to_string(i)).c_str(), &count, &error);
+		BOOST_CHECK(error == 0);
+		BOOST_REQUIRE(values != nullptr);
+		BOOST_CHECK(count == list_size);
+		BOOST_CHECK(strings.front() == values[0]);
+		BOOST_CHECK(strings.back() == values[count - 1]);
+		delete [] values;
+	}
+	BOOST_CHECK(dynv_system_release(loaded) == 0);
+	BOOST_CHECK(dynv_system_release(dynv) == 0);
+}
@@ -1,5 +1,10 @@
 #include <boost/test/unit_test.hpp>
 #include "lua/Script.h"
+#include "lua/Color.h"
+#include "lua/ColorObject.h"
+#include "Converter.h"
+#include "ColorObject.h"
+#include "Color.h"
 extern "C"{
 #include <lualib.h>
 #include <lauxlib.h>
@@ -49,3 +54,117 @@ BOOST_AUTO_TEST_CASE(register_nullptr_extension)
 	string return_value = script.getString(-1);
 	BOOST_CHECK(return_value == "ok");
 }
+BOOST_AUTO_TEST_CASE(color_conversions)
+{
+	color_init();
+	Script script;
+	BOOST_REQUIRE(script.registerExtension("color", [](Script &script){
+		return registerColor(script);
+	}));
+	bool status = script.loadCode(
+		"local color = require(\"gpick/color\")\n"
+		"local c = color:new(0.2, 0.4, 0.6)\n"
+		"local lab = c:rgbToLab()\n"
+		"local target = color:new()\n"
+		"local result = c:rgbToLab(target)\n"
+		"assert(result == target)\n"
+		"assert(target:labLightness() == lab:labLightness() and target:labB() == lab:labB())\n"
+		"local colors = {color:new(0.2, 0.4, 0.6), color:new(0.9, 0.1, 0.3)}\n"
+		"assert(color.rgbToLch(colors) == colors)\n"
+		"color.lchToRgb(colors)\n"
+		"c:rgbToXyz(c):xyzToRgb(c)\n"
+		"local red, green, blue = c:rgb()\n"
+		"return lab:labLightness(), red, colors[1]:red(), colors[2]:blue()");
+	BOOST_REQUIRE(status == true);
+	status = script.run(0, 4);
+	BOOST_REQUIRE_MESSAGE(status == true, script.getLastError());
+	lua_State *L = script;
+	Color rgb, lab;
+	color_set(&rgb, 0.2f, 0.4f, 0.6f);
+	color_rgb_to_lab_d50(&rgb, &lab);
+	BOOST_CHECK_CLOSE(lua_tonumber(L, -4), lab.lab.L, 0.001);
+	BOOST_CHECK_CLOSE(lua_tonumber(L, -3), 0.2, 0.01);
+	BOOST_CHECK_CLOSE(lua_tonumber(L, -2), 0.2, 0.01);
+	BOOST_CHECK_CLOSE(lua_tonumber(L, -1), 0.3, 0.01);
+}
+BOOST_AUTO_TEST_CASE(kept_userdata_between_converter_calls)
+{
+	color_init();
+	Script script;
+	BOOST_REQUIRE(script.registerExtension("color", [](Script &script){
+		return registerColor(script);
+	}));
+	BOOST_REQUIRE(script.registerExtension("colorObject", [](Script &script){
+		return registerColorObject(script);
+	}));
+	bool status = script.loadCode(
+		"local color = require(\"gpick/color\")\n"
+		"require(\"gpick/colorObject\")\n"
+		"return function(color_object)\n"
+		"	if kept_object == nil then\n"
+		"		kept_object = color_object\n"
+		"		kept_color = color_object:getColor()\n"
+		"		return \"first\"\n"
+		"	end\n"
+		"	local red = color_object:getColor():red()\n"
+		"	local ok, message = pcall(function() return kept_object:getColor() end)\n"
+		"	assert(not ok)\n"
+		"	return string.format(\"%s|%f|%f\", message, kept_color:red(), red)\n"
+		"end");
+	BOOST_REQUIRE(status == true);
+	status = script.run(0, 1);
+	BOOST_REQUIRE_MESSAGE(status == true, script.getLastError());
+	lua_State *L = script;
+	Converter converter("test", "test", Ref(L, -1), Ref(), Ref());
+	lua_pop(L, 1);
+	Color color;
+	color_set(&color, 0.25f, 0.5f, 0.75f);
+	ColorObject *first = new ColorObject("first", color);
+	BOOST_CHECK(converter.serialize(first) == "first");
+	first->release();
+	lua_gc(L, LUA_GCCOLLECT, 0);
+	color_set(&color, 0.5f, 0.5f, 0.5f);
+	ColorObject *second = new ColorObject("second", color);
+	string result = converter.serialize(second);
+	second->release();
+	BOOST_CHECK_MESSAGE(result.find("not valid anymore") != string::npos, result);
+	BOOST_CHECK_MESSAGE(result.find("|0.250000|0.500000") != string::npos, result);
+}
+BOOST_AUTO_TEST_CASE(batch_serialize_error)
+{
+	color_init();
+	Script script;
+	BOOST_REQUIRE(script.registerExtension("colorObject", [](Script &script){
+		return registerColorObject(script);
+	}));
+	BOOST_REQUIRE(script.registerExtension("color", [](Script &script){
+		return registerColor(script);
+	}));
+	bool status = script.loadCode(
+		"require(\"gpick/color\")\n"
+		"require(\"gpick/colorObject\")\n"
+		"return function(color_object, position)\n"
+		"	local name = color_object:getName()\n"
+		"	if name == \"bad\" then error(\"bad color\") end\n"
+		"	return name .. position.index\n"
+		"end");
+	BOOST_REQUIRE(status == true);
+	status = script.run(0, 1);
+	BOOST_REQUIRE_MESSAGE(status == true, script.getLastError());
+	lua_State *L = script;
+	Converter converter("test", "test", Ref(L, -1), Ref(), Ref());
+	lua_pop(L, 1);
+	Color color;
+	color_set(&color, 0.5f, 0.5f, 0.5f);
+	vector<ColorObject*> color_objects;
+	for (auto name: {"a", "bad", "c"})
+		color_objects.push_back(new ColorObject(name, color));
+	vector<string> result;
+	converter.serialize(&color_objects.front(), color_objects.size(), ConverterSerializePosition(10, 20), result);
+	for (auto color_object: color_objects)
+		color_object->release();
+	BOOST_REQUIRE(result.size() == 3);
+	BOOST_CHECK(result[0] == "a10");
+	BOOST_CHECK(result[1] == "");
+	BOOST_CHECK(result[2] == "c12");
+}
@@ -2,6 +2,9 @@
 #include <fstream>
 #include <iostream>
 #include <vector>
+#include <sstream>
+#include <chrono>
+#include <thread>
 #include "parser/TextFile.h"
 #include "Color.h"
 using namespace std;
@@ -56,6 +59,16 @@ struct TextFile: public text_file_parser::TextFile
 			text_file_parser::Configuration configuration;
 			text_file_parser::TextFile::parse(configuration);
 		}
+		void parse(const string &data)
+		{
+			text_file_parser::Configuration configuration;
+			text_file_parser::TextFile::parse(configuration, data.c_str(), data.length());
+		}
+		void parse(const string &data, size_t threads)
+		{
+			text_file_parser::Configuration configuration;
+			text_file_parser::TextFile::parse(configuration, data.c_str(), data.length(), threads);
+		}
 };
 
 BOOST_AUTO_TEST_CASE(full_hex)
@@ -167,3 +180,71 @@ BOOST_AUTO_TEST_CASE(single_line_hash_comments)
 	BOOST_CHECK(parser.checkColor(0, color));
 	file.close();
 }
+BOOST_AUTO_TEST_CASE(repeated_corpus)
+{
+	stringstream corpus;
+	for (int i = 1; i <= 9; i++){
+		ifstream file("test/textImport0" + to_string(i) + ".txt");
+		BOOST_REQUIRE(file.is_open());
+		corpus << file.rdbuf() << "\n";
+	}
+	string data, corpus_data = corpus.str();
+	TextFile corpus_parser(nullptr);
+	corpus_parser.parse(corpus_data);
+	BOOST_REQUIRE(!corpus_parser.m_failed);
+	BOOST_REQUIRE(corpus_parser.count() > 0);
+	const size_t size = 16 * 1024 * 1024;
+	size_t repeats = 0;
+	data.reserve(size + corpus_data.length());
+	while (data.length() < size){
+		data += corpus_data;
+		repeats++;
+	}
+	istringstream stream(data);
+	TextFile stream_parser(&stream), memory_parser(nullptr);
+	stream_parser.parse();
+	memory_parser.parse(data);
+	BOOST_CHECK(!stream_parser.m_failed);
+	BOOST_CHECK(!memory_parser.m_failed);
+	BOOST_CHECK(memory_parser.count() == corpus_parser.count() * repeats);
+	BOOST_REQUIRE(stream_parser.count() == memory_parser.count());
+	for (size_t i = 0; i < memory_parser.count(); i++){
+		if (!memory_parser.checkColor(i, stream_parser.m_colors[i]) || !corpus_parser.checkColor(i % corpus_parser.count(), stream_parser.m_colors[i])){
+			BOOST_ERROR("color " << i << " differs");
+			break;
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(parallel)
+{
+	//multi-line comments are long enough to span chunk boundaries
+	string comment = "/*\n";
+	for (int i = 0; i < 100000; i++)
+		comment += "#ccbbaa rgb(1, 2, 3)\n";
+	comment += "*/\n";
+	string block = "color: #aabbcc\ncolor: rgb(170, 187,\n204)\n170 187\n 204\n// #ccbbaa\n# #ccbbaa\n0.1, 0.2, 0.3\n";
+	string data;
+	for (int i = 0; i < 8; i++){
+		for (int j = 0; j < 50000; j++)
+			data += block;
+		data += comment;
+	}
+	TextFile serial_parser(nullptr), parallel_parser(nullptr);
+	size_t threads = max(thread::hardware_concurrency(), 8u);
+	auto start = chrono::steady_clock::now();
+	serial_parser.parse(data);
+	auto serial_parsed = chrono::steady_clock::now();
+	parallel_parser.parse(data, threads);
+	auto parallel_parsed = chrono::steady_clock::now();
+	BOOST_TEST_MESSAGE("parallel text file parsing with " << threads << " threads: " << chrono::duration<double>(serial_parsed - start).count() / chrono::duration<double>(parallel_parsed - serial_parsed).count() << "x speedup");
+	BOOST_CHECK(!serial_parser.m_failed);
+	BOOST_CHECK(!parallel_parser.m_failed);
+	BOOST_CHECK(serial_parser.count() == 8 * 50000 * 4);
+	BOOST_REQUIRE(serial_parser.count() == parallel_parser.count());
+	for (size_t i = 0; i < serial_parser.count(); i++){
+		if (!parallel_parser.checkColor(i, serial_parser.m_colors[i])){
+			BOOST_ERROR("color " << i << " differs");
+			break;
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#include <boost/test/unit_test.hpp>
+#include "ToolColorNaming.h"
+#include "color_names/ColorNames.h"
+#include "Color.h"
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(tool_color_name_cache)
+{
+	color_init();
+	ColorNames *color_names = color_names_new();
+	BOOST_REQUIRE(color_names_load_from_file(color_names, "share/gpick/color_dictionary_0.txt") == 0);
+	ToolColorNameCache cache;
+	Color color;
+	color_set(&color, 0.9f, 0.1f, 0.1f);
+	bool cached;
+	string name = cache.get(color_names, &color, false, cached);
+	BOOST_CHECK(cached == false);
+	BOOST_CHECK(name == color_names_get(color_names, &color, false));
+	BOOST_CHECK(cache.get(color_names, &color, false, cached) == name);
+	BOOST_CHECK(cached == true);
+	cache.get(color_names, &color, true, cached);
+	BOOST_CHECK(cached == false);
+	cache.clear();
+	cache.get(color_names, &color, false, cached);
+	BOOST_CHECK(cached == false);
+	ToolColorNameCache::Statistics statistics;
+	statistics.lookups = 1;
+	statistics.saved_lookups = 5;
+	cache.addRecompute(statistics);
+	statistics.lookups = 0;
+	statistics.saved_lookups = 6;
+	cache.addRecompute(statistics);
+	BOOST_CHECK(cache.lastRecompute().lookups == 0);
+	BOOST_CHECK(cache.lastRecompute().saved_lookups == 6);
+	BOOST_CHECK(cache.total().lookups == 1);
+	BOOST_CHECK(cache.total().saved_lookups == 11);
+	color_names_destroy(color_names);
+}
@@ -0,0 +1,143 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "transformation/GammaModification.h"
+#include "transformation/Quantization.h"
+#include "Color.h"
+#include "MathUtil.h"
+using namespace std;
+using namespace transformation;
+
+namespace {
+struct TestGammaModification: public GammaModification
+{
+	TestGammaModification(float value):
+		GammaModification(value)
+	{
+	}
+	using GammaModification::apply;
+	int exactBelow() const
+	{
+		return exact_below;
+	}
+};
+struct TestQuantization: public Quantization
+{
+	TestQuantization(float value, bool clip_top_):
+		Quantization(value)
+	{
+		clip_top = clip_top_;
+	}
+	using Quantization::apply;
+};
+}
+/** Gamma modification before batch kernel was added. */
+static float gamma_reference(float x, float value)
+{
+	Color color, linear;
+	color.rgb.red = color.rgb.green = color.rgb.blue = x;
+	color_rgb_get_linear(&color, &linear);
+	linear.rgb.red = pow(linear.rgb.red, value);
+	color_linear_get_rgb(&linear, &color);
+	return clamp_float(color.rgb.red, 0, 1);
+}
+/** Quantization before batch kernel was added. */
+static float quantization_reference(float x, float value, bool clip_top)
+{
+	if (clip_top)
+		return min((value - 1) / value, boost::math::round(x * value) / value);
+	float actual_max = value - 1;
+	return boost::math::round(x * actual_max) / actual_max;
+}
+/** Apply to values in all color channels at different lanes and check that alpha of output is preserved. */
+template<typename T>
+static vector<float> apply(T &transformation, const vector<float> &values)
+{
+	vector<Color> input(values.size()), output(values.size());
+	for (size_t i = 0; i < values.size(); i++){
+		input[i].rgb.red = values[i];
+		input[i].rgb.green = values[(i + 1) % values.size()];
+		input[i].rgb.blue = values[(i + 2) % values.size()];
+		input[i].ma[3] = 0.75f;
+		output[i].ma[3] = 0.25f;
+	}
+	transformation.apply(&input.front(), &output.front(), values.size());
+	vector<float> result(values.size());
+	for (size_t i = 0; i < values.size(); i++){
+		result[i] = output[i].rgb.red;
+		BOOST_CHECK_EQUAL(output[i].rgb.green, output[(i + 1) % values.size()].rgb.red);
+		BOOST_CHECK_EQUAL(output[i].rgb.blue, output[(i + 2) % values.size()].rgb.red);
+		BOOST_CHECK_EQUAL(output[i].ma[3], 0.25f);
+	}
+	Color single = input[0];
+	single.ma[3] = 0.5f;
+	transformation.apply(&input[0], &single);
+	BOOST_CHECK_EQUAL(single.rgb.red, result[0]);
+	return result;
+}
+BOOST_AUTO_TEST_CASE(gamma_modification_kernel)
+{
+	color_init();
+	const float curve_step = 1.0f / (255 * 16);
+	for (float value: {0.05f, 0.3f, 1.0f, 2.2f, 10.0f}){
+		TestGammaModification gamma(value);
+		vector<float> values = {0, 1, 0.5f, 1 / 255.0f, 254 / 255.0f};
+		for (int i = 0; i <= 1000; i++)
+			values.push_back(i / 1000.0f);
+		int exact_below = gamma.exactBelow();
+		for (int cell = max(exact_below - 2, 0); cell <= exact_below + 2; cell++){
+			for (float offset: {0.0f, 0.25f, 0.5f, 0.999f})
+				values.push_back((cell + offset) * curve_step);
+		}
+		vector<float> result = apply(gamma, values);
+		for (size_t i = 0; i < values.size(); i++)
+			BOOST_CHECK_MESSAGE(std::abs(result[i] - gamma_reference(values[i], value)) <= 2 * curve_step, "gamma " << value << ", input " << values[i] << ": " << result[i] << " != " << gamma_reference(values[i], value));
+		//inputs outside of [0, 1] are clamped before modification
+		vector<float> outside = {-0.5f, -0.0001f, -numeric_limits<float>::infinity(), 1.0001f, 2, numeric_limits<float>::infinity()};
+		result = apply(gamma, outside);
+		for (size_t i = 0; i < outside.size(); i++)
+			BOOST_CHECK_SMALL(result[i] - gamma_reference(clamp_float(outside[i], 0, 1), value), 2 * curve_step);
+		vector<float> invalid = {numeric_limits<float>::quiet_NaN(), 0.5f, numeric_limits<float>::quiet_NaN()};
+		result = apply(gamma, invalid);
+		BOOST_CHECK_EQUAL(result[0], 0);
+		BOOST_CHECK_EQUAL(result[2], 0);
+	}
+	//small gamma values need exact modification near zero
+	BOOST_CHECK(TestGammaModification(0.05f).exactBelow() > 0);
+	BOOST_CHECK(TestGammaModification(1.0f).exactBelow() == 0);
+}
+BOOST_AUTO_TEST_CASE(quantization_kernel)
+{
+	for (float value: {2.0f, 16.0f, 256.0f}){
+		for (bool clip_top: {false, true}){
+			TestQuantization quantization(value, clip_top);
+			float scale = clip_top ? value : value - 1;
+			vector<float> values = {0, 1, -0.0f, -1, -0.3f, 1.5f, 3};
+			for (int i = 0; i <= 1000; i++)
+				values.push_back(i / 1000.0f);
+			//values at and next to rounding ties
+			for (int i = 0; i < scale; i++){
+				float tie = (i + 0.5f) / scale;
+				values.push_back(tie);
+				values.push_back(nextafter(tie, 0.0f));
+				values.push_back(nextafter(tie, 1.0f));
+				values.push_back(-tie);
+			}
+			values.push_back(nextafter(0.5f, 0.0f) / scale);
+			vector<float> result = apply(quantization, values);
+			for (size_t i = 0; i < values.size(); i++){
+				float expected = quantization_reference(values[i], value, clip_top);
+				BOOST_CHECK_MESSAGE(std::abs(result[i] - expected) <= 1e-6f, "quantization " << value << (clip_top ? " clipped" : "") << ", input " << values[i] << ": " << result[i] << " != " << expected);
+			}
+			if (clip_top)
+				BOOST_CHECK_EQUAL(apply(quantization, {1.0f})[0], (value - 1) / value);
+			vector<float> invalid = {numeric_limits<float>::quiet_NaN(), 0.5f, numeric_limits<float>::quiet_NaN()};
+			result = apply(quantization, invalid);
+			BOOST_CHECK_EQUAL(result[0], 0);
+			BOOST_CHECK_EQUAL(result[2], 0);
+		}
+	}
+}
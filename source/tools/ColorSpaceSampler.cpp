@@ -25,8 +25,10 @@
 #include "../uiListPalette.h"
 #include "../uiUtilities.h"
 #include "../ToolColorNaming.h"
+#include "../TaskExecutor.h"
 #include <sstream>
 #include <algorithm>
+#include <memory>
 using namespace std;
 
 #define N_AXIS 3
@@ -55,6 +57,7 @@ struct ColorSpaceSamplerArgs
 	ColorList *preview_color_list;
 	struct dynvSystem *params;
 	GlobalState* gs;
+	std::shared_ptr<TaskExecutor::Task> preview_task;
 };
 
 struct ColorSpaceSamplerNameAssigner: public ToolColorNameAssigner
@@ -77,45 +80,36 @@ struct ColorSpaceSamplerNameAssigner: public ToolColorNameAssigner
 			return m_stream.str();
 		}
 };
-static void calc(ColorSpaceSamplerArgs *args, bool preview, size_t limit)
+static void generate(int color_space, bool linearization, const AxisOptions *axis, size_t limit, vector<Color> &colors)
 {
-	ColorSpaceSamplerNameAssigner name_assigner(args->gs);
-	ColorList *color_list;
-	if (preview)
-		color_list = args->preview_color_list;
-	else
-		color_list = args->gs->getColorList();
 	vector<Color> values;
-	size_t value_count = args->axis[0].samples * args->axis[1].samples * args->axis[2].samples;
-	if (preview)
+	size_t value_count = axis[0].samples * axis[1].samples * axis[2].samples;
+	if (limit > 0)
 		value_count = std::min(limit, value_count);
 	values.resize(value_count);
 	size_t value_i = 0;
-	for (int x = 0; x < args->axis[0].samples; x++){
-		float x_value = (args->axis[0].samples > 1) ? (args->axis[0].min_value + (args->axis[0].max_value - args->axis[0].min_value) * (x / (double)(args->axis[0].samples - 1))) : args->axis[0].min_value;
-		for (int y = 0; y < args->axis[1].samples; y++){
-			float y_value = (args->axis[1].samples > 1) ? (args->axis[1].min_value + (args->axis[1].max_value - args->axis[1].min_value) * (y / (double)(args->axis[1].samples - 1))) : args->axis[1].min_value;
-			for (int z = 0; z < args->axis[2].samples; z++){
-				float z_value = (args->axis[2].samples > 1) ? (args->axis[2].min_value + (args->axis[2].max_value - args->axis[2].min_value) * (z / (double)(args->axis[2].samples - 1))) : args->axis[2].min_value;
+	for (int x = 0; x < axis[0].samples; x++){
+		float x_value = (axis[0].samples > 1) ? (axis[0].min_value + (axis[0].max_value - axis[0].min_value) * (x / (double)(axis[0].samples - 1))) : axis[0].min_value;
+		for (int y = 0; y < axis[1].samples; y++){
+			float y_value = (axis[1].samples > 1) ? (axis[1].min_value + (axis[1].max_value - axis[1].min_value) * (y / (double)(axis[1].samples - 1))) : axis[1].min_value;
+			for (int z = 0; z < axis[2].samples; z++){
+				float z_value = (axis[2].samples > 1) ? (axis[2].min_value + (axis[2].max_value - axis[2].min_value) * (z / (double)(axis[2].samples - 1))) : axis[2].min_value;
 				values[value_i].ma[0] = x_value;
 				values[value_i].ma[1] = y_value;
 				values[value_i].ma[2] = z_value;
 				value_i++;
-				if (preview && value_i >= limit){
-					x = args->axis[0].samples;
-					y = args->axis[1].samples;
+				if (value_i >= value_count){
+					x = axis[0].samples;
+					y = axis[1].samples;
 					break;
 				}
 			}
 		}
 	}
+	colors.resize(value_count);
 	Color t;
 	for (size_t i = 0; i < value_count; i++){
-		if (preview){
-			if (limit <= 0) return;
-			limit--;
-		}
-		switch (args->color_space){
+		switch (color_space){
 			case 0:
 				color_copy(&values[i], &t);
 				break;
@@ -140,17 +134,66 @@ static void calc(ColorSpaceSamplerArgs *args, bool preview, size_t limit)
 				color_lch_to_rgb_d50(&t, &t);
 				break;
 		}
-		if (args->linearization)
+		if (linearization)
 			color_linear_get_rgb(&t, &t);
 		color_rgb_normalize(&t);
-		ColorObject *color_object = color_list_new_color_object(color_list, &t);
-		name_assigner.assign(color_object, &t);
+		colors[i] = t;
+	}
+}
+static void store(ColorSpaceSamplerArgs *args, ColorList *color_list, const vector<Color> &colors)
+{
+	ColorSpaceSamplerNameAssigner name_assigner(args->gs);
+	for (auto &color: colors){
+		ColorObject *color_object = color_list_new_color_object(color_list, &color);
+		name_assigner.assign(color_object, &color);
 		color_list_add_color_object(color_list, color_object, 1);
 		color_object->release();
 	}
 }
+/** Computes preview colors in a worker thread. Settings are copied, so that dialog can be changed or destroyed while task is running. */
+struct ColorSpaceSamplerPreviewTask: public TaskExecutor::Task
+{
+	ColorSpaceSamplerArgs *m_args;
+	int m_color_space;
+	bool m_linearization;
+	AxisOptions m_axis[N_AXIS];
+	size_t m_limit;
+	vector<Color> m_colors;
+	ColorSpaceSamplerPreviewTask(ColorSpaceSamplerArgs *args, size_t limit):
+		m_args(args),
+		m_color_space(args->color_space),
+		m_linearization(args->linearization),
+		m_limit(limit)
+	{
+		std::copy(args->axis, args->axis + N_AXIS, m_axis);
+	}
+	virtual void run()
+	{
+		generate(m_color_space, m_linearization, m_axis, m_limit, m_colors);
+	}
+	virtual void finish()
+	{
+		color_list_remove_all(m_args->preview_color_list);
+		store(m_args, m_args->preview_color_list, m_colors);
+	}
+};
+static void calc(ColorSpaceSamplerArgs *args, bool preview, size_t limit)
+{
+	if (preview){
+		if (args->preview_task)
+			args->preview_task->cancel();
+		args->preview_task = make_shared<ColorSpaceSamplerPreviewTask>(args, limit);
+		args->gs->taskExecutor().submit(args->preview_task);
+		return;
+	}
+	vector<Color> colors;
+	generate(args->color_space, args->linearization, args->axis, 0, colors);
+	store(args, args->gs->getColorList(), colors);
+}
 static void destroy_cb(GtkWidget* widget, ColorSpaceSamplerArgs *args)
 {
+	if (args->preview_task)
+		args->preview_task->cancel();
 	color_list_destroy(args->preview_color_list);
 	dynv_system_release(args->params);
 	delete args;
@@ -186,7 +229,6 @@ static void save_settings(ColorSpaceSamplerArgs *args)
 }
 static void update(GtkWidget *widget, ColorSpaceSamplerArgs *args)
 {
-	color_list_remove_all(args->preview_color_list);
 	get_settings(args);
 	calc(args, true, 100);
 }
@@ -25,11 +25,13 @@
 #include "../ToolColorNaming.h"
 #include "../DynvHelpers.h"
 #include "../I18N.h"
+#include "../TaskExecutor.h"
 #include <string.h>
 #include <iostream>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <memory>
 using namespace std;
 
 /** \file PaletteFromImage.cpp
@@ -75,6 +77,7 @@ struct PaletteFromImageArgs{
 	ColorList *preview_color_list;
 	struct dynvSystem *params;
 	GlobalState* gs;
+	std::shared_ptr<TaskExecutor::Task> preview_task;
 };
 
 struct PaletteColorNameAssigner: public ToolColorNameAssigner {
@@ -326,20 +329,7 @@ static void leaf_cb(Node *node, void *userdata){
 	l->push_back(c);
 }
 
-static Node* process_image(PaletteFromImageArgs *args, const char *filename, Node* node){
-
-	if (args->previous_filename == filename){
-		if (args->previous_node)
-			return node_copy(args->previous_node, 0);
-		else
-			return 0;
-	}
-
-	args->previous_filename = filename;
-	if (args->previous_node){
-		node_delete(args->previous_node);
-		args->previous_node = 0;
-	}
+static Node* load_image(const char *filename){
 
 	GError *error = nullptr;
 	GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file(filename, &error);
@@ -366,7 +356,7 @@ static Node* process_image(PaletteFromImageArgs *args, const char *filename, Nod
 
 	Color color;
 
-	args->previous_node = node_new(0);
+	Node *root_node = node_new(0);
 
 	for (int y = 0; y < height; y++){
 		ptr = image_data + rowstride * y;
@@ -376,16 +366,49 @@ static Node* process_image(PaletteFromImageArgs *args, const char *filename, Nod
 			color.xyz.y = ptr[1] / 255.0;
 			color.xyz.z = ptr[2] / 255.0;
 
-			node_update(args->previous_node, &color, &cube, 5);
+			node_update(root_node, &color, &cube, 5);
 
 			ptr += channels;
 		}
 	}
 	g_object_unref(pixbuf);
-	node_reduce(args->previous_node, 200);
+	node_reduce(root_node, 200);
+	return root_node;
+}
+
+static Node* process_image(PaletteFromImageArgs *args, const char *filename, Node* node){
+
+	if (args->previous_filename == filename){
+		if (args->previous_node)
+			return node_copy(args->previous_node, 0);
+		else
+			return 0;
+	}
+
+	args->previous_filename = filename;
+	if (args->previous_node){
+		node_delete(args->previous_node);
+		args->previous_node = 0;
+	}
+
+	args->previous_node = load_image(filename);
+	if (!args->previous_node)
+		return 0;
 	return node_copy(args->previous_node, 0);
 }
 
+bool tools_palette_from_image_extract(const char *filename, uint32_t n_colors, std::vector<Color> &colors){
+	Node *root_node = load_image(filename);
+	if (!root_node)
+		return false;
+	list<Color> tmp_list;
+	node_reduce(root_node, n_colors);
+	node_leaf_callback(root_node, leaf_cb, &tmp_list);
+	node_delete(root_node);
+	colors.assign(tmp_list.begin(), tmp_list.end());
+	return true;
+}
+
 static void get_settings(PaletteFromImageArgs *args){
 
 	gchar *filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(args->file_browser));
@@ -413,22 +436,91 @@ static void save_settings(PaletteFromImageArgs *args){
 	}
 }
 
+static void store(PaletteFromImageArgs *args, ColorList *color_list, const string &filename, list<Color> &colors){
+	int index = 0;
+	gchar *name = g_path_get_basename(filename.c_str());
+	PaletteColorNameAssigner name_assigner(args->gs);
+	for (list<Color>::iterator i = colors.begin(); i != colors.end(); i++){
+		ColorObject *color_object = color_list_new_color_object(color_list, &(*i));
+		name_assigner.assign(color_object, &(*i), name, index);
+		color_list_add_color_object(color_list, color_object, 1);
+		color_object->release();
+		index++;
+	}
+	g_free(name);
+}
+
+/** \struct PaletteFromImagePreviewTask
+ * \brief Loads image and extracts palette in a worker thread.
+ *
+ * Octree of the last loaded image is cached in dialog arguments, so changing color count does not load image again.
+ * Cache is only accessed from the main loop: a copy is made when task is created and newly loaded octree is handed over in finish().
+ */
+struct PaletteFromImagePreviewTask: public TaskExecutor::Task{
+	PaletteFromImageArgs *m_args;
+	string m_filename;
+	uint32_t m_n_colors;
+	Node *m_cached_node;
+	Node *m_loaded_node;
+	list<Color> m_colors;
+	PaletteFromImagePreviewTask(PaletteFromImageArgs *args):
+		m_args(args),
+		m_filename(args->filename),
+		m_n_colors(args->n_colors),
+		m_cached_node(nullptr),
+		m_loaded_node(nullptr)
+	{
+		if (m_filename == args->previous_filename && args->previous_node)
+			m_cached_node = node_copy(args->previous_node, 0);
+	}
+	virtual ~PaletteFromImagePreviewTask(){
+		if (m_cached_node) node_delete(m_cached_node);
+		if (m_loaded_node) node_delete(m_loaded_node);
+	}
+	virtual void run(){
+		if (m_filename.empty())
+			return;
+		Node *node;
+		if (m_cached_node){
+			node = m_cached_node;
+			m_cached_node = nullptr;
+		}else{
+			m_loaded_node = load_image(m_filename.c_str());
+			if (!m_loaded_node || cancelled())
+				return;
+			node = node_copy(m_loaded_node, 0);
+		}
+		node_reduce(node, m_n_colors);
+		node_leaf_callback(node, leaf_cb, &m_colors);
+		node_delete(node);
+	}
+	virtual void finish(){
+		if (m_loaded_node){
+			if (m_args->previous_node)
+				node_delete(m_args->previous_node);
+			m_args->previous_filename = m_filename;
+			m_args->previous_node = m_loaded_node;
+			m_loaded_node = nullptr;
+		}
+		color_list_remove_all(m_args->preview_color_list);
+		store(m_args, m_args->preview_color_list, m_filename, m_colors);
+	}
+};
+
 static void calc(PaletteFromImageArgs *args, bool preview, int limit){
 
+	if (preview){
+		if (args->preview_task)
+			args->preview_task->cancel();
+		args->preview_task = std::make_shared<PaletteFromImagePreviewTask>(args);
+		args->gs->taskExecutor().submit(args->preview_task);
+		return;
+	}
+
 	Node *root_node = 0;
-	int index = 0;
-	gchar *name = g_path_get_basename(args->filename.c_str());
-	PaletteColorNameAssigner name_assigner(args->gs);
 	if (!args->filename.empty())
 		root_node = process_image(args, args->filename.c_str(), root_node);
 
-	ColorList *color_list;
-
-	if (preview)
-		color_list = args->preview_color_list;
-	else
-		color_list = args->gs->getColorList();
-
 	list<Color> tmp_list;
 
 	if (root_node){
@@ -437,17 +529,10 @@ static void calc(PaletteFromImageArgs *args, bool preview, int limit){
 		node_delete(root_node);
 	}
 
-	for (list<Color>::iterator i = tmp_list.begin(); i != tmp_list.end(); i++){
-		ColorObject *color_object = color_list_new_color_object(color_list, &(*i));
-		name_assigner.assign(color_object, &(*i), name, index);
-		color_list_add_color_object(color_list, color_object, 1);
-		color_object->release();
-		index++;
-	}
+	store(args, args->gs->getColorList(), args->filename, tmp_list);
 }
 
 static void update(GtkWidget *widget, PaletteFromImageArgs *args ){
-	color_list_remove_all(args->preview_color_list);
 	get_settings(args);
 	calc(args, true, 100);
 }
@@ -458,6 +543,9 @@ static gchar* format_threshold_value_cb(GtkScale *scale, gdouble value){
 
 static void destroy_cb(GtkWidget* widget, PaletteFromImageArgs *args){
 
+	if (args->preview_task)
+		args->preview_task->cancel();
+
 	if (args->previous_node) node_delete(args->previous_node);
 
 	color_list_destroy(args->preview_color_list);
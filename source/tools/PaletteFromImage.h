@@ -19,6 +19,16 @@
 #ifndef GPICK_TOOLS_PALETTE_FROM_IMAGE_H_
 #define GPICK_TOOLS_PALETTE_FROM_IMAGE_H_
 #include <gtk/gtk.h>
+#include <vector>
+#include "../Color.h"
 struct GlobalState;
 void tools_palette_from_image_show(GtkWindow* parent, GlobalState* gs);
+/**
+ * Extract palette from image file without any user interface.
+ * @param[in] filename Image file name.
+ * @param[in] n_colors Maximum number of colors in palette.
+ * @param[out] colors Extracted palette colors.
+ * @return False if image could not be loaded.
+ */
+bool tools_palette_from_image_extract(const char *filename, uint32_t n_colors, std::vector<Color> &colors);
 #endif /* GPICK_TOOLS_PALETTE_FROM_IMAGE_H_ */
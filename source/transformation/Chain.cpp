@@ -17,6 +17,8 @@
  */
 
 #include "Chain.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
@@ -27,34 +29,170 @@ Chain::Chain()
 	enabled = true;
 }
 
-void Chain::apply(const Color *input, Color *output)
+void Chain::applyTransformations(const vector<Transformation*> &transformations, Color *color)
 {
-	if (!enabled) {
-		color_copy(input, output);
-		return;
-	}
 	Color tmp[2];
 	Color *tmp_p[3];
-
-	color_copy(input, &tmp[0]);
-
+	color_copy(color, &tmp[0]);
 	tmp_p[0] = &tmp[0];
 	tmp_p[1] = &tmp[1];
-	for (TransformationList::iterator i = transformation_chain.begin(); i != transformation_chain.end(); i++){
-
-		(*i)->apply(tmp_p[0], tmp_p[1]);
-
+	for (auto transformation: transformations){
+		transformation->apply(tmp_p[0], tmp_p[1]);
 		tmp_p[2] = tmp_p[0];
 		tmp_p[0] = tmp_p[1];
 		tmp_p[1] = tmp_p[2];
 	}
+	color->rgb = tmp_p[0]->rgb;
+}
+
+void Chain::compile()
+{
+	stages.clear();
+	auto i = transformation_chain.begin();
+	while (i != transformation_chain.end()){
+		Stage stage;
+		if (!(*i)->isContinuous()){
+			stage.type = Stage::Type::transformation;
+			stage.transformations.push_back(i->get());
+			stages.push_back(stage);
+			++i;
+			continue;
+		}
+		bool affine = true;
+		matrix3x3_identity(&stage.matrix);
+		vector3_set(&stage.offset, 0, 0, 0);
+		for (; i != transformation_chain.end() && (*i)->isContinuous(); ++i){
+			stage.transformations.push_back(i->get());
+			matrix3x3 matrix;
+			vector3 offset;
+			if (affine && (*i)->getAffine(&matrix, &offset)){
+				//fuse with previous affine transformations: matrix * (stage.matrix * x + stage.offset) + offset
+				vector3 new_offset;
+				vector3_multiply_matrix3x3(&stage.offset, &matrix, &new_offset);
+				for (int j = 0; j < 3; j++)
+					stage.offset.m[j] = new_offset.m[j] + offset.m[j];
+				matrix3x3_multiply(&stage.matrix, &matrix, &stage.matrix);
+			}else{
+				affine = false;
+			}
+		}
+		if (affine){
+			stage.type = Stage::Type::affine;
+		}else{
+			stage.type = Stage::Type::lookup_table;
+			const int size = lookup_table_size;
+			stage.lookup_table.resize(size * size * size);
+			Color color;
+			color.ma[3] = 1;
+			for (int r = 0; r < size; r++){
+				for (int g = 0; g < size; g++){
+					for (int b = 0; b < size; b++){
+						color_set(&color, r / float(size - 1), g / float(size - 1), b / float(size - 1));
+						applyTransformations(stage.transformations, &color);
+						vector3_set(&stage.lookup_table[(r * size + g) * size + b], color.rgb.red, color.rgb.green, color.rgb.blue);
+					}
+				}
+			}
+			//interpolation error is largest in the middle of lookup table cells, so check all cell centers and apply transformations directly if lookup table is not accurate enough
+			Color interpolated;
+			interpolated.ma[3] = 1;
+			for (int r = 0; r < size - 1 && stage.type == Stage::Type::lookup_table; r++){
+				for (int g = 0; g < size - 1 && stage.type == Stage::Type::lookup_table; g++){
+					for (int b = 0; b < size - 1; b++){
+						color_set(&color, (r + 0.5f) / (size - 1), (g + 0.5f) / (size - 1), (b + 0.5f) / (size - 1));
+						color_copy(&color, &interpolated);
+						applyStage(stage, &interpolated);
+						applyTransformations(stage.transformations, &color);
+						if (std::abs(color.rgb.red - interpolated.rgb.red) > max_lookup_table_error || std::abs(color.rgb.green - interpolated.rgb.green) > max_lookup_table_error || std::abs(color.rgb.blue - interpolated.rgb.blue) > max_lookup_table_error){
+							stage.type = Stage::Type::transformation;
+							stage.lookup_table.clear();
+							break;
+						}
+					}
+				}
+			}
+		}
+		stages.push_back(stage);
+	}
+}
+
+void Chain::applyStage(const Stage &stage, Color *color)
+{
+	switch (stage.type){
+	case Stage::Type::affine:
+		{
+			vector3 input, output;
+			vector3_set(&input, color->rgb.red, color->rgb.green, color->rgb.blue);
+			vector3_multiply_matrix3x3(&input, &stage.matrix, &output);
+			color->rgb.red = output.x + stage.offset.x;
+			color->rgb.green = output.y + stage.offset.y;
+			color->rgb.blue = output.z + stage.offset.z;
+		}
+		break;
+	case Stage::Type::lookup_table:
+		{
+			if (color_is_rgb_out_of_gamut(color)){
+				//lookup table only covers valid RGB values
+				applyTransformations(stage.transformations, color);
+				break;
+			}
+			//trilinear interpolation between eight nearest lookup table entries
+			const int size = lookup_table_size;
+			int index[3];
+			float fraction[3];
+			for (int i = 0; i < 3; i++){
+				float position = color->ma[i] * (size - 1);
+				index[i] = std::min(int(position), size - 2);
+				fraction[i] = position - index[i];
+			}
+			const vector3 *table = &stage.lookup_table[(index[0] * size + index[1]) * size + index[2]];
+			const int step_r = size * size, step_g = size;
+			for (int i = 0; i < 3; i++){
+				float c00 = table[0].m[i] + (table[step_r].m[i] - table[0].m[i]) * fraction[0];
+				float c01 = table[1].m[i] + (table[step_r + 1].m[i] - table[1].m[i]) * fraction[0];
+				float c10 = table[step_g].m[i] + (table[step_r + step_g].m[i] - table[step_g].m[i]) * fraction[0];
+				float c11 = table[step_g + 1].m[i] + (table[step_r + step_g + 1].m[i] - table[step_g + 1].m[i]) * fraction[0];
+				float c0 = c00 + (c10 - c00) * fraction[1];
+				float c1 = c01 + (c11 - c01) * fraction[1];
+				color->ma[i] = c0 + (c1 - c0) * fraction[2];
+			}
+		}
+		break;
+	case Stage::Type::transformation:
+		applyTransformations(stage.transformations, color);
+		break;
+	}
+}
 
-	color_copy(tmp_p[0], output);
+void Chain::apply(const Color *input, Color *output) const
+{
+	apply(input, output, 1);
+}
+
+void Chain::apply(const Color *input, Color *output, size_t count) const
+{
+	if (!enabled) {
+		if (input != output)
+			std::copy(input, input + count, output);
+		return;
+	}
+	if (input != output)
+		std::copy(input, input + count, output);
+	for (auto &stage: stages){
+		if (stage.type == Stage::Type::transformation){
+			for (auto transformation: stage.transformations)
+				transformation->apply(output, output, count);
+		}else{
+			for (size_t i = 0; i < count; i++)
+				applyStage(stage, &output[i]);
+		}
+	}
 }
 
 void Chain::add(boost::shared_ptr<Transformation> transformation)
 {
 	transformation_chain.push_back(transformation);
+	compile();
 }
 
 void Chain::remove(const Transformation *transformation)
@@ -62,6 +200,7 @@ void Chain::remove(const Transformation *transformation)
 	for (TransformationList::iterator i = transformation_chain.begin(); i != transformation_chain.end(); i++){
 		if ((*i).get() == transformation){
 			transformation_chain.erase(i);
+			compile();
 			return;
 		}
 	}
@@ -70,6 +209,12 @@ void Chain::remove(const Transformation *transformation)
 void Chain::clear()
 {
 	transformation_chain.clear();
+	stages.clear();
+}
+
+void Chain::update()
+{
+	compile();
 }
 
 Chain::TransformationList& Chain::getAll()
@@ -21,6 +21,7 @@
 #include "Transformation.h"
 #include <boost/shared_ptr.hpp>
 #include <list>
+#include <vector>
 
 /** \file source/transformation/Chain.h
  * \brief Struct for transformation object list handling.
@@ -35,9 +36,35 @@ struct Chain
 {
 	public:
 		typedef std::list<boost::shared_ptr<Transformation> > TransformationList;
+		/** Lookup table grid size in each dimension. */
+		static const int lookup_table_size = 33;
+		/** Maximum difference between interpolated and directly calculated RGB component value. Lookup table is not used when this error is exceeded. */
+		static constexpr float max_lookup_table_error = 1.0f / 255;
 	protected:
+		/** \struct Stage
+		 * \brief Compiled form of one or more consecutive transformations.
+		 */
+		struct Stage
+		{
+			enum class Type
+			{
+				affine, /**< Fused affine transformations */
+				lookup_table, /**< Continuous transformations baked into a lookup table */
+				transformation, /**< Transformation applied directly */
+			};
+			Type type;
+			matrix3x3 matrix;
+			vector3 offset;
+			std::vector<vector3> lookup_table;
+			std::vector<Transformation*> transformations;
+		};
 		TransformationList transformation_chain;
+		std::vector<Stage> stages;
 		bool enabled;
+		/** Rebuild stages from transformation list. Called when chain is modified, so apply() only reads stages and can run while chain is not modified. */
+		void compile();
+		static void applyStage(const Stage &stage, Color *color);
+		static void applyTransformations(const std::vector<Transformation*> &transformations, Color *color);
 	public:
 		/**
 		 * Chain constructor.
@@ -49,7 +76,20 @@ struct Chain
 		 * @param[in] input Source color in RGB color space.
 		 * @param[out] output Destination color in RGB color space.
 		 */
-		void apply(const Color *input, Color *output);
+		void apply(const Color *input, Color *output) const;
+
+		/**
+		 * Apply transformation chain to an array of colors.
+		 * @param[in] input Source colors in RGB color space.
+		 * @param[out] output Destination colors in RGB color space. Can be the same array as input.
+		 * @param[in] count Number of colors.
+		 */
+		void apply(const Color *input, Color *output, size_t count) const;
+
+		/**
+		 * Rebuild compiled transformation chain. Must be called after changing settings of a transformation object which is already in the list.
+		 */
+		void update();
 
 		/**
 		 * Add transformation object into the list.
@@ -189,95 +189,106 @@ static void load_vector(const Color *color, vector3 *vector)
 	vector->z = color->rgb.blue;
 }
 
-void ColorVisionDeficiency::apply(Color *input, Color *output)
+void ColorVisionDeficiency::updateMatrices()
 {
-	Color linear_input, linear_output;
-	color_rgb_get_linear(input, &linear_input);
-	vector3 vi, vo1, vo2;
-	load_vector(&linear_input, &vi);
-	matrix3x3 matrix1, matrix2;
-	int index = floor(strength * 10);
-	int index_secondary = std::min(index + 1, 10);
-	float interpolation_factor = 1 - ((strength * 10) - index);
-
-	vector3 lms;
-	if ((type == PROTANOPIA) || (type == DEUTERANOPIA) || (type == TRITANOPIA)){
-		load_matrix(rgb_to_lms, &matrix1);
-		load_matrix(lms_to_rgb, &matrix2);
-		vector3_multiply_matrix3x3(&vi, &matrix1, &lms);
-	}
-
 	switch (type){
 		case PROTANOMALY:
-			load_matrix(protanomaly[index], &matrix1);
-			load_matrix(protanomaly[index_secondary], &matrix2);
-			vector3_multiply_matrix3x3(&vi, &matrix1, &vo1);
-			vector3_multiply_matrix3x3(&vi, &matrix2, &vo2);
-			break;
 		case DEUTERANOMALY:
-			load_matrix(deuteranomaly[index], &matrix1);
-			load_matrix(deuteranomaly[index_secondary], &matrix2);
-			vector3_multiply_matrix3x3(&vi, &matrix1, &vo1);
-			vector3_multiply_matrix3x3(&vi, &matrix2, &vo2);
-			break;
 		case TRITANOMALY:
-			load_matrix(tritanomaly[index], &matrix1);
-			load_matrix(tritanomaly[index_secondary], &matrix2);
-			vector3_multiply_matrix3x3(&vi, &matrix1, &vo1);
-			vector3_multiply_matrix3x3(&vi, &matrix2, &vo2);
-			break;
-		case PROTANOPIA:
-			if (lms.z / lms.y < rgb_anchor[2] / rgb_anchor[1]){
-				lms.x = -(protanopia_abc[0].y * lms.y + protanopia_abc[0].z * lms.z) / protanopia_abc[0].x;
-			}else{
-				lms.x = -(protanopia_abc[1].y * lms.y + protanopia_abc[1].z * lms.z) / protanopia_abc[1].x;
+			{
+				const double (*matrices)[9] = (type == PROTANOMALY) ? protanomaly : ((type == DEUTERANOMALY) ? deuteranomaly : tritanomaly);
+				int index = static_cast<int>(floor(strength * 10));
+				int index_secondary = std::min(index + 1, 10);
+				float interpolation_factor = 1 - ((strength * 10) - index);
+				matrix3x3 matrix1, matrix2;
+				load_matrix(matrices[index], &matrix1);
+				load_matrix(matrices[index_secondary], &matrix2);
+				//interpolating results of two matrix multiplications is the same as multiplying by interpolated matrix
+				for (int i = 0; i < 3; i++){
+					for (int j = 0; j < 3; j++){
+						matrix.m[i][j] = matrix1.m[i][j] * interpolation_factor + matrix2.m[i][j] * (1 - interpolation_factor);
+					}
+				}
 			}
-			vector3_multiply_matrix3x3(&lms, &matrix2, &vo1);
-			load_vector(&linear_input, &vo2);
-			interpolation_factor = strength;
 			break;
+		case PROTANOPIA:
 		case DEUTERANOPIA:
-			if (lms.z / lms.x < rgb_anchor[2] / rgb_anchor[0]){
-				lms.y = -(deuteranopia_abc[0].x * lms.x + deuteranopia_abc[0].z * lms.z) / deuteranopia_abc[0].y;
-			}else{
-				lms.y = -(deuteranopia_abc[1].x * lms.x + deuteranopia_abc[1].z * lms.z) / deuteranopia_abc[1].y;
-			}
-			vector3_multiply_matrix3x3(&lms, &matrix2, &vo1);
-			load_vector(&linear_input, &vo2);
-			interpolation_factor = strength;
-			break;
 		case TRITANOPIA:
-			if (lms.y / lms.x < rgb_anchor[1] / rgb_anchor[0]){
-				lms.z = -(tritanopia_abc[0].x * lms.x + tritanopia_abc[0].y * lms.y) / tritanopia_abc[0].z;
-			}else{
-				lms.z = -(tritanopia_abc[1].x * lms.x + tritanopia_abc[1].y * lms.y) / tritanopia_abc[1].z;
-			}
-			vector3_multiply_matrix3x3(&lms, &matrix2, &vo1);
-			load_vector(&linear_input, &vo2);
-			interpolation_factor = strength;
+			load_matrix(rgb_to_lms, &rgb_to_lms_matrix);
+			load_matrix(lms_to_rgb, &lms_to_rgb_matrix);
 			break;
 		default:
-			color_copy(input, output);
-			return;
+			break;
 	}
+}
 
-	linear_output.rgb.red = vo1.x * interpolation_factor + vo2.x * (1 - interpolation_factor);
-	linear_output.rgb.green = vo1.y * interpolation_factor + vo2.y * (1 - interpolation_factor);
-	linear_output.rgb.blue = vo1.z * interpolation_factor + vo2.z * (1 - interpolation_factor);
-	color_linear_get_rgb(&linear_output, output);
-	color_rgb_normalize(output);
+void ColorVisionDeficiency::apply(Color *input, Color *output)
+{
+	apply(input, output, 1);
+}
+
+void ColorVisionDeficiency::apply(Color *input, Color *output, size_t count)
+{
+	if (type < PROTANOMALY || type >= DEFICIENCY_TYPE_COUNT){
+		for (size_t i = 0; i < count; i++)
+			output[i].rgb = input[i].rgb;
+		return;
+	}
+	for (size_t i = 0; i < count; i++){
+		Color linear_input, linear_output;
+		color_rgb_get_linear(&input[i], &linear_input);
+		vector3 vi, vo;
+		load_vector(&linear_input, &vi);
+		if (type == PROTANOMALY || type == DEUTERANOMALY || type == TRITANOMALY){
+			vector3_multiply_matrix3x3(&vi, &matrix, &vo);
+		}else{
+			vector3 lms;
+			vector3_multiply_matrix3x3(&vi, &rgb_to_lms_matrix, &lms);
+			switch (type){
+				case PROTANOPIA:
+					if (lms.z / lms.y < rgb_anchor[2] / rgb_anchor[1]){
+						lms.x = -(protanopia_abc[0].y * lms.y + protanopia_abc[0].z * lms.z) / protanopia_abc[0].x;
+					}else{
+						lms.x = -(protanopia_abc[1].y * lms.y + protanopia_abc[1].z * lms.z) / protanopia_abc[1].x;
+					}
+					break;
+				case DEUTERANOPIA:
+					if (lms.z / lms.x < rgb_anchor[2] / rgb_anchor[0]){
+						lms.y = -(deuteranopia_abc[0].x * lms.x + deuteranopia_abc[0].z * lms.z) / deuteranopia_abc[0].y;
+					}else{
+						lms.y = -(deuteranopia_abc[1].x * lms.x + deuteranopia_abc[1].z * lms.z) / deuteranopia_abc[1].y;
+					}
+					break;
+				case TRITANOPIA:
+					if (lms.y / lms.x < rgb_anchor[1] / rgb_anchor[0]){
+						lms.z = -(tritanopia_abc[0].x * lms.x + tritanopia_abc[0].y * lms.y) / tritanopia_abc[0].z;
+					}else{
+						lms.z = -(tritanopia_abc[1].x * lms.x + tritanopia_abc[1].y * lms.y) / tritanopia_abc[1].z;
+					}
+					break;
+				default:
+					break;
+			}
+			vector3_multiply_matrix3x3(&lms, &lms_to_rgb_matrix, &vo);
+			for (int j = 0; j < 3; j++)
+				vo.m[j] = vo.m[j] * strength + vi.m[j] * (1 - strength);
+		}
+		linear_output.rgb.red = vo.x;
+		linear_output.rgb.green = vo.y;
+		linear_output.rgb.blue = vo.z;
+		color_linear_get_rgb(&linear_output, &output[i]);
+		color_rgb_normalize(&output[i]);
+	}
 }
 
 ColorVisionDeficiency::ColorVisionDeficiency():Transformation(transformation_name, getReadableName())
 {
-	type = PROTANOMALY;
-	strength = 0.5;
+	set(PROTANOMALY, 0.5);
 }
 
 ColorVisionDeficiency::ColorVisionDeficiency(DeficiencyType type_, float strength_):Transformation(transformation_name, getReadableName())
 {
-	type = type_;
-	strength = strength_;
+	set(type_, strength_);
 }
 
 ColorVisionDeficiency::~ColorVisionDeficiency()
@@ -305,8 +316,14 @@ ColorVisionDeficiency::DeficiencyType ColorVisionDeficiency::typeFromString(cons
 
 void ColorVisionDeficiency::deserialize(struct dynvSystem *dynv)
 {
-	strength = dynv_get_float_wd(dynv, "strength", 0.5);
-	type = typeFromString(dynv_get_string_wd(dynv, "type", "protanomaly"));
+	set(typeFromString(dynv_get_string_wd(dynv, "type", "protanomaly")), dynv_get_float_wd(dynv, "strength", 0.5));
+}
+
+void ColorVisionDeficiency::set(DeficiencyType type_, float strength_)
+{
+	type = type_;
+	strength = clamp_float(strength_, 0, 1);
+	updateMatrices();
 }
 
 
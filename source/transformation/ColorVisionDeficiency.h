@@ -58,7 +58,12 @@ struct ColorVisionDeficiency: public Transformation
 	protected:
 		float strength;
 		DeficiencyType type;
+		matrix3x3 matrix; /**< Precomputed linear RGB transformation matrix for anomaly types */
+		matrix3x3 rgb_to_lms_matrix; /**< Linear RGB to LMS matrix for anopia types */
+		matrix3x3 lms_to_rgb_matrix; /**< LMS to linear RGB matrix for anopia types */
+		void updateMatrices();
 		virtual void apply(Color *input, Color *output);
+		virtual void apply(Color *input, Color *output, size_t count);
 
 	public:
 		ColorVisionDeficiency();
@@ -72,6 +77,13 @@ struct ColorVisionDeficiency: public Transformation
 
 		DeficiencyType typeFromString(const char *type_string);
 
+		/**
+		 * Set deficiency type and strength.
+		 * @param[in] type Deficiency type.
+		 * @param[in] strength Deficiency strength in range [0, 1].
+		 */
+		void set(DeficiencyType type, float strength);
+
 	friend struct ColorVisionDeficiencyConfig;
 };
 
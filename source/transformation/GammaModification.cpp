@@ -23,6 +23,12 @@
 #include <gtk/gtk.h>
 #include <math.h>
 #include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace transformation {
 
@@ -38,25 +44,99 @@ const char *GammaModification::getReadableName()
 	return _("Gamma modification");
 }
 
+/** Gamma curve is sampled at multiples of 1/(255 * 16), so 8-bit channel values fall exactly on curve points. */
+static const int curve_size = 255 * 16 + 1;
+/** Maximum allowed interpolation error between gamma curve points. Values in curve cells with larger error are modified directly. */
+static const float max_curve_error = 1.0f / (255 * 16);
+
+static float modify(float x, float value)
+{
+	Color color, linear;
+	color.rgb.red = x;
+	color_rgb_get_linear(&color, &linear);
+	linear.rgb.red = pow(linear.rgb.red, value);
+	color_linear_get_rgb(&linear, &color);
+	return clamp_float(color.rgb.red, 0, 1);
+}
+
+void GammaModification::buildCurve()
+{
+	curve.resize(curve_size);
+	for (int i = 0; i < curve_size; i++)
+		curve[i] = modify(i / float(curve_size - 1), value);
+	//small gamma values make curve very steep near zero, so check interpolation error in the middle of every cell
+	exact_below = 0;
+	for (int i = 0; i < curve_size - 1; i++){
+		float interpolated = (curve[i] + curve[i + 1]) / 2;
+		if (std::abs(modify((i + 0.5f) / (curve_size - 1), value) - interpolated) > max_curve_error)
+			exact_below = i + 1;
+	}
+}
+
 void GammaModification::apply(Color *input, Color *output)
 {
-	Color linear_input, linear_output;
-	color_rgb_get_linear(input, &linear_input);
-	linear_output.rgb.red = pow(linear_input.rgb.red, value);
-	linear_output.rgb.green= pow(linear_input.rgb.green, value);
-	linear_output.rgb.blue = pow(linear_input.rgb.blue, value);
-	color_linear_get_rgb(&linear_output, output);
-	color_rgb_normalize(output);
+	apply(input, output, 1);
+}
+
+void GammaModification::apply(Color *input, Color *output, size_t count)
+{
+	//each channel is modified independently, so linearization, pow, delinearization and clamping is replaced by linear interpolation between gamma curve points
+	const float *table = &curve.front();
+	const float scale = curve_size - 1;
+#ifdef __SSE2__
+	static_assert(sizeof(Color) == sizeof(__m128), "Color must consist of four floats");
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1), scale_v = _mm_set1_ps(scale), last_index = _mm_set1_ps(curve_size - 2);
+	const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	for (size_t i = 0; i < count; i++){
+		//_mm_max_ps returns second operand when first one is NaN, so invalid values end up at the start of the curve
+		__m128 position = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input[i].ma), zero), one), scale_v);
+		__m128 index_f = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(position)), last_index);
+		__m128 fraction = _mm_sub_ps(position, index_f);
+		alignas(16) int32_t index[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_cvttps_epi32(index_f));
+		__m128 low = _mm_set_ps(0, table[index[2]], table[index[1]], table[index[0]]);
+		__m128 high = _mm_set_ps(0, table[index[2] + 1], table[index[1] + 1], table[index[0] + 1]);
+		__m128 result = _mm_add_ps(low, _mm_mul_ps(_mm_sub_ps(high, low), fraction));
+		__m128 alpha = _mm_and_ps(_mm_loadu_ps(output[i].ma), alpha_mask);
+		if (index[0] < exact_below || index[1] < exact_below || index[2] < exact_below){
+			alignas(16) float position_a[4];
+			_mm_store_ps(position_a, position);
+			_mm_storeu_ps(output[i].ma, _mm_or_ps(_mm_andnot_ps(alpha_mask, result), alpha));
+			for (int j = 0; j < 3; j++){
+				if (index[j] < exact_below)
+					output[i].ma[j] = modify(position_a[j] / scale, value);
+			}
+			continue;
+		}
+		_mm_storeu_ps(output[i].ma, _mm_or_ps(_mm_andnot_ps(alpha_mask, result), alpha));
+	}
+#else
+	for (size_t i = 0; i < count; i++){
+		for (int j = 0; j < 3; j++){
+			float x = input[i].ma[j];
+			float position = (x > 0 ? (x < 1 ? x : 1) : 0) * scale;
+			int index = std::min(int(position), curve_size - 2);
+			if (index < exact_below){
+				output[i].ma[j] = modify(position / scale, value);
+				continue;
+			}
+			float fraction = position - index;
+			output[i].ma[j] = table[index] + (table[index + 1] - table[index]) * fraction;
+		}
+	}
+#endif
 }
 
 GammaModification::GammaModification():Transformation(transformation_name, getReadableName())
 {
 	value = 1;
+	buildCurve();
 }
 
 GammaModification::GammaModification(float value_):Transformation(transformation_name, getReadableName())
 {
 	value = value_;
+	buildCurve();
 }
 
 GammaModification::~GammaModification()
@@ -72,6 +152,7 @@ void GammaModification::serialize(struct dynvSystem *dynv)
 void GammaModification::deserialize(struct dynvSystem *dynv)
 {
 	value = dynv_get_float_wd(dynv, "value", 1);
+	buildCurve();
 }
 
 boost::shared_ptr<Configuration> GammaModification::getConfig(){
@@ -19,6 +19,7 @@
 #ifndef TRANSFORMATION_GAMMA_MODIFICATION_H_
 #define TRANSFORMATION_GAMMA_MODIFICATION_H_
 #include "Transformation.h"
+#include <vector>
 namespace transformation
 {
 struct GammaModification;
@@ -40,7 +41,11 @@ struct GammaModification: public Transformation
 		static const char *getReadableName();
 	protected:
 		float value;
+		std::vector<float> curve; /**< Precomputed gamma curve. Rebuilt whenever value changes, so apply() only reads it */
+		int exact_below; /**< Index of the first gamma curve cell accurate enough for interpolation */
+		void buildCurve();
 		virtual void apply(Color *input, Color *output);
+		virtual void apply(Color *input, Color *output, size_t count);
 	public:
 		GammaModification();
 		GammaModification(float value);
@@ -25,6 +25,15 @@ void Invert::apply(Color *input, Color *output)
 	output->rgb.green= 1 - input->rgb.green;
 	output->rgb.blue = 1 - input->rgb.blue;
 }
+bool Invert::getAffine(matrix3x3 *matrix, vector3 *offset)
+{
+	matrix3x3_identity(matrix);
+	for (int i = 0; i < 3; i++){
+		matrix->m[i][i] = -1;
+		offset->m[i] = 1;
+	}
+	return true;
+}
 Invert::Invert():
 	Transformation("invert", "Invert")
 {
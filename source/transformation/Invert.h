@@ -27,6 +27,7 @@ struct Invert: public Transformation
 	virtual ~Invert();
 	protected:
 	virtual void apply(Color *input, Color *output);
+	virtual bool getAffine(matrix3x3 *matrix, vector3 *offset);
 };
 }
 #endif /* TRANSFORMATION_INVERT_H_ */
@@ -24,7 +24,12 @@
 #include <gtk/gtk.h>
 #include <math.h>
 #include <string.h>
+#include <algorithm>
+#include <limits>
 #include <boost/math/special_functions/round.hpp>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace transformation {
 
@@ -42,27 +47,65 @@ const char *Quantization::getReadableName()
 
 void Quantization::apply(Color *input, Color *output)
 {
-	if (clip_top) {
-		float max_intensity = (value - 1) / value;
-		output->rgb.red = MIN(max_intensity, boost::math::round(input->rgb.red * value) / value);
-		output->rgb.green = MIN(max_intensity, boost::math::round(input->rgb.green * value) / value);
-		output->rgb.blue = MIN(max_intensity, boost::math::round(input->rgb.blue * value) / value);
+	apply(input, output, 1);
+}
+
+void Quantization::apply(Color *input, Color *output, size_t count)
+{
+	float scale, max_intensity;
+	if (clip_top){
+		scale = value;
+		max_intensity = (value - 1) / value;
 	}else{
-		float actualmax = value - 1;
-		output->rgb.red = boost::math::round(input->rgb.red * actualmax) / actualmax;
-		output->rgb.green = boost::math::round(input->rgb.green * actualmax) / actualmax;
-		output->rgb.blue = boost::math::round(input->rgb.blue * actualmax) / actualmax;
+		scale = value - 1;
+		max_intensity = std::numeric_limits<float>::max();
+	}
+	const float inverse_scale = 1 / scale;
+#ifdef __SSE2__
+	static_assert(sizeof(Color) == sizeof(__m128), "Color must consist of four floats");
+	//rounds half away from zero like boost::math::round: truncate magnitude, add one when fraction is at least 0.5 and restore sign
+	//adding 0.5 before truncation is not used, because sums just below 1 are rounded up to 1
+	const __m128 scale_v = _mm_set1_ps(scale), inverse_scale_v = _mm_set1_ps(inverse_scale), max_intensity_v = _mm_set1_ps(max_intensity);
+	const __m128 half = _mm_set1_ps(0.5f), one = _mm_set1_ps(1), sign_mask = _mm_set1_ps(-0.0f);
+	const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	for (size_t i = 0; i < count; i++){
+		__m128 x = _mm_mul_ps(_mm_loadu_ps(input[i].ma), scale_v);
+		__m128 sign = _mm_and_ps(x, sign_mask);
+		__m128 magnitude = _mm_andnot_ps(sign_mask, x);
+		__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(magnitude));
+		__m128 rounded = _mm_add_ps(truncated, _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(magnitude, truncated), half), one));
+		__m128 result = _mm_min_ps(_mm_mul_ps(_mm_or_ps(rounded, sign), inverse_scale_v), max_intensity_v);
+		//invalid values are quantized to zero
+		result = _mm_and_ps(result, _mm_cmpord_ps(x, x));
+		__m128 alpha = _mm_and_ps(_mm_loadu_ps(output[i].ma), alpha_mask);
+		_mm_storeu_ps(output[i].ma, _mm_or_ps(_mm_andnot_ps(alpha_mask, result), alpha));
 	}
+#else
+	for (size_t i = 0; i < count; i++){
+		for (int j = 0; j < 3; j++){
+			float x = input[i].ma[j] * scale;
+			//invalid values are quantized to zero
+			output[i].ma[j] = x == x ? std::min(max_intensity, boost::math::round(x) * inverse_scale) : 0;
+		}
+	}
+#endif
+}
+
+bool Quantization::isContinuous()
+{
+	return false;
 }
 
 Quantization::Quantization():Transformation(transformation_name, getReadableName())
 {
 	value = 16;
+	clip_top = false;
 }
 
 Quantization::Quantization(float value_):Transformation(transformation_name, getReadableName())
 {
 	value = value_;
+	clip_top = false;
 }
 
 Quantization::~Quantization()
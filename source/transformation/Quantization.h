@@ -43,6 +43,8 @@ struct Quantization: public Transformation
 		float value;
 		bool clip_top;
 		virtual void apply(Color *input, Color *output);
+		virtual void apply(Color *input, Color *output, size_t count);
+		virtual bool isContinuous();
 	public:
 		Quantization();
 		Quantization(float value);
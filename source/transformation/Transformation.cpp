@@ -31,6 +31,22 @@ void Transformation::apply(Color *input, Color *output)
 {
 	color_copy(input, output);
 }
+void Transformation::apply(Color *input, Color *output, size_t count)
+{
+	Color tmp;
+	for (size_t i = 0; i < count; i++){
+		apply(&input[i], &tmp);
+		output[i].rgb = tmp.rgb;
+	}
+}
+bool Transformation::getAffine(matrix3x3 *matrix, vector3 *offset)
+{
+	return false;
+}
+bool Transformation::isContinuous()
+{
+	return true;
+}
 std::string Transformation::getName() const
 {
 	return name;
@@ -44,6 +44,28 @@ struct Transformation
 		 * @param[out] output Destination color in RGB color space.
 		 */
 		virtual void apply(Color *input, Color *output);
+
+		/**
+		 * Apply transformation to an array of colors.
+		 * @param[in] input Source colors in RGB color space.
+		 * @param[out] output Destination colors in RGB color space. Can be the same array as input.
+		 * @param[in] count Number of colors.
+		 */
+		virtual void apply(Color *input, Color *output, size_t count);
+
+		/**
+		 * Get affine form of transformation: output = matrix * input + offset.
+		 * @param[out] matrix Transformation matrix.
+		 * @param[out] offset Transformation offset.
+		 * @return True, when transformation is affine in RGB color space.
+		 */
+		virtual bool getAffine(matrix3x3 *matrix, vector3 *offset);
+
+		/**
+		 * Check if small change of input always results in small change of output. Only continuous transformations can be approximated by an interpolated lookup table.
+		 * @return True, when transformation is continuous.
+		 */
+		virtual bool isContinuous();
 	public:
 		/**
 		 * Transformation object constructor.
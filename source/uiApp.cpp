@@ -41,6 +41,7 @@
 #include "uiDialogGenerate.h"
 #include "uiDialogAutonumber.h"
 #include "uiDialogSort.h"
+#include "uiDialogDeduplicate.h"
 #include "uiColorDictionaries.h"
 #include "uiTransformations.h"
 #include "uiDialogOptions.h"
@@ -1082,6 +1083,11 @@ static void palette_popup_menu_remove_selected(GtkWidget *widget, AppArgs* args)
 	color_list_remove_selected(args->gs->getColorList());
 }
 
+static void palette_popup_menu_remove_duplicates(GtkWidget *widget, AppArgs* args)
+{
+	dialog_deduplicate_show(GTK_WINDOW(args->window), args->gs->getColorList(), args->gs);
+}
+
 static PaletteListCallbackReturn color_list_clear_names(ColorObject* color_object, void *userdata)
 {
 	color_object->setName("");
@@ -1355,6 +1361,10 @@ static gboolean palette_popup_menu_show(GtkWidget *widget, GdkEventButton* event
 	gtk_menu_shell_append (GTK_MENU_SHELL (menu), item);
 	g_signal_connect(G_OBJECT (item), "activate", G_CALLBACK(palette_popup_menu_remove_all), args);
 	gtk_widget_set_sensitive(item, (total_count >= 1));
+	item = gtk_menu_item_new_with_mnemonic(_("Remove _Duplicates..."));
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), item);
+	g_signal_connect(G_OBJECT(item), "activate", G_CALLBACK(palette_popup_menu_remove_duplicates), args);
+	gtk_widget_set_sensitive(item, (total_count >= 2));
 	gtk_widget_show_all (GTK_WIDGET(menu));
 	if (event){
 		button = event->button;
@@ -1509,6 +1519,12 @@ static int color_list_on_delete(ColorList* color_list, ColorObject* color_object
 	return 0;
 }
 
+static int color_list_on_change(ColorList* color_list, ColorObject* color_object)
+{
+	palette_list_update_text(((AppArgs*)color_list->userdata)->color_list);
+	return 0;
+}
+
 static int color_list_on_clear(ColorList* color_list)
 {
 	palette_list_remove_all_entries(((AppArgs*)color_list->userdata)->color_list);
@@ -1618,6 +1634,7 @@ static void app_initialize_color_list(AppArgs *args)
 	args->gs->getColorList()->on_delete_selected = color_list_on_delete_selected;
 	args->gs->getColorList()->on_get_positions = color_list_on_get_positions;
 	args->gs->getColorList()->on_delete = color_list_on_delete;
+	args->gs->getColorList()->on_change = color_list_on_change;
 	args->gs->getColorList()->userdata = args;
 }
 
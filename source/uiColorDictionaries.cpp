@@ -21,6 +21,7 @@
 #include "DynvHelpers.h"
 #include "GlobalState.h"
 #include "color_names/ColorNames.h"
+#include "ToolColorNaming.h"
 #include "I18N.h"
 #include <list>
 #include <string>
@@ -312,6 +313,7 @@ void dialog_color_dictionaries_show(GtkWindow* parent, GlobalState* gs)
 		}
 		color_names_clear(args->gs->getColorNames());
 		color_names_load(args->gs->getColorNames(), args->params);
+		args->gs->toolColorNameCache().clear();
 	}
 	gint width, height;
 	gtk_window_get_size(GTK_WINDOW(dialog), &width, &height);
@@ -265,6 +265,7 @@ void dialog_converter_show(GtkWindow *parent, GlobalState *gs)
 			dynv_set_bool_array(args->params, "converters.paste", 0, 0);
 		}
 		args->gs->converters().rebuildCopyPasteArrays();
+		color_list_notify_text_change(args->gs->getColorList());
 	}
 	gint width, height;
 	gtk_window_get_size(GTK_WINDOW(dialog), &width, &height);
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2009-2016, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "uiDialogDeduplicate.h"
+#include "uiUtilities.h"
+#include "ColorList.h"
+#include "ColorListIndex.h"
+#include "DynvHelpers.h"
+#include "GlobalState.h"
+#include "I18N.h"
+#include <vector>
+using namespace std;
+
+typedef struct DialogDeduplicateArgs{
+	GtkWidget *threshold;
+	GtkWidget *summary;
+	ColorList *color_list;
+	dynvSystem *params;
+	GlobalState* gs;
+	guint update_source_id;
+}DialogDeduplicateArgs;
+
+/** Delay in milliseconds between the last threshold change and summary update, so that holding spin button arrows does not cluster colors on every step. */
+static const guint update_delay = 150;
+static void update(DialogDeduplicateArgs *args)
+{
+	float threshold = static_cast<float>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->threshold)));
+	vector<ColorListIndex::Cluster> clusters;
+	color_list_get_index(args->color_list).cluster(args->color_list->colors, threshold, clusters);
+	size_t removed = 0;
+	for (auto &cluster: clusters)
+		removed += cluster.members.size();
+	gchar *text = g_strdup_printf(_("%d groups of similar colors found, %d colors will be removed"), static_cast<int>(clusters.size()), static_cast<int>(removed));
+	gtk_label_set_text(GTK_LABEL(args->summary), text);
+	g_free(text);
+}
+static gboolean update_timeout(DialogDeduplicateArgs *args)
+{
+	args->update_source_id = 0;
+	update(args);
+	return FALSE;
+}
+static void remove_update_timeout(DialogDeduplicateArgs *args)
+{
+	if (args->update_source_id){
+		g_source_remove(args->update_source_id);
+		args->update_source_id = 0;
+	}
+}
+static void on_threshold_change(GtkWidget *widget, DialogDeduplicateArgs *args)
+{
+	remove_update_timeout(args);
+	args->update_source_id = g_timeout_add(update_delay, (GSourceFunc)update_timeout, args);
+}
+bool dialog_deduplicate_show(GtkWindow* parent, ColorList *color_list, GlobalState* gs)
+{
+	DialogDeduplicateArgs *args = new DialogDeduplicateArgs;
+	args->gs = gs;
+	args->color_list = color_list;
+	args->update_source_id = 0;
+	args->params = dynv_get_dynv(args->gs->getSettings(), "gpick.deduplicate");
+	GtkWidget *dialog = gtk_dialog_new_with_buttons(_("Remove duplicates"), parent, GtkDialogFlags(GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT), GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL, GTK_STOCK_OK, GTK_RESPONSE_OK, nullptr);
+	gtk_window_set_default_size(GTK_WINDOW(dialog), dynv_get_int32_wd(args->params, "window.width", -1), dynv_get_int32_wd(args->params, "window.height", -1));
+	gtk_dialog_set_alternative_button_order(GTK_DIALOG(dialog), GTK_RESPONSE_OK, GTK_RESPONSE_CANCEL, -1);
+
+	gint table_y;
+	GtkWidget *table = gtk_table_new(2, 2, FALSE);
+	table_y = 0;
+
+	gtk_table_attach(GTK_TABLE(table), gtk_label_aligned_new(_("Color difference:"),0,0.5,0,0),0,1,table_y,table_y+1,GtkAttachOptions(GTK_FILL),GTK_FILL,5,5);
+	args->threshold = gtk_spin_button_new_with_range(0, 100, 0.1);
+	gtk_spin_button_set_value(GTK_SPIN_BUTTON(args->threshold), dynv_get_float_wd(args->params, "threshold", 2.3f));
+	gtk_table_attach(GTK_TABLE(table), args->threshold,1,2,table_y,table_y+1,GtkAttachOptions(GTK_FILL | GTK_EXPAND),GTK_FILL,5,0);
+	g_signal_connect(G_OBJECT(args->threshold), "value-changed", G_CALLBACK(on_threshold_change), args);
+	table_y++;
+
+	args->summary = gtk_label_aligned_new("",0,0.5,0,0);
+	gtk_table_attach(GTK_TABLE(table), args->summary,0,2,table_y,table_y+1,GtkAttachOptions(GTK_FILL | GTK_EXPAND),GTK_FILL,5,5);
+	table_y++;
+
+	update(args);
+
+	gtk_widget_show_all(table);
+	gtk_container_add(GTK_CONTAINER(gtk_dialog_get_content_area(GTK_DIALOG(dialog))), table);
+
+	bool retval = false;
+	gint response = gtk_dialog_run(GTK_DIALOG(dialog));
+	remove_update_timeout(args);
+	float threshold = static_cast<float>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->threshold)));
+	dynv_set_float(args->params, "threshold", threshold);
+	if (response == GTK_RESPONSE_OK){
+		color_list_remove_duplicates(color_list, threshold);
+		retval = true;
+	}
+
+	gint width, height;
+	gtk_window_get_size(GTK_WINDOW(dialog), &width, &height);
+	dynv_set_int32(args->params, "window.width", width);
+	dynv_set_int32(args->params, "window.height", height);
+
+	gtk_widget_destroy(dialog);
+
+	dynv_system_release(args->params);
+	delete args;
+	return retval;
+}
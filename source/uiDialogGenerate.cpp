@@ -79,7 +79,7 @@ struct GenerateColorNameAssigner: public ToolColorNameAssigner
 		virtual std::string getToolSpecificName(ColorObject *color_object, const Color *color)
 		{
 			m_stream.str("");
-			m_stream << _("scheme") << " " << m_scheme_name << " #" << m_ident << "[" << color_names_get(m_gs->getColorNames(), color, false) << "]";
+			m_stream << _("scheme") << " " << m_scheme_name << " #" << m_ident << "[" << getColorName(color) << "]";
 			return m_stream.str();
 		}
 };
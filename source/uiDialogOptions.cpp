@@ -20,12 +20,18 @@
 #include "uiUtilities.h"
 #include "ToolColorNaming.h"
 #include "GlobalState.h"
+#include "ColorDistance.h"
+#include "ColorList.h"
+#include "Converters.h"
+#include "ConverterWorkers.h"
+#include "color_names/ColorNames.h"
 #include "I18N.h"
 #include "DynvHelpers.h"
 #include "lua/Script.h"
 #include "lua/DynvSystem.h"
 #include "lua/Callbacks.h"
 #include <string>
+#include <vector>
 #include <iostream>
 using namespace std;
 extern "C"{
@@ -65,6 +71,7 @@ typedef struct DialogOptionsArgs{
 	GtkWidget *zoom_size;
 	GtkWidget *imprecision_postfix;
 	GtkWidget *tool_color_naming[3];
+	vector<GtkWidget*> color_distance; /**< One radio button for each color difference metric */
 	GtkWidget *color_spaces[6];
 	GtkWidget *out_of_gamut_mask;
 	GtkWidget *lab_illuminant;
@@ -86,7 +93,9 @@ bool dialog_options_update(lua::Script &script, dynvSystem *settings, GlobalStat
 	gs->callbacks().optionChange().get();
 	lua::pushDynvSystem(L, settings);
 	int status = lua_pcall(L, 1, 0, 0);
+	gs->converterWorkers().updateOptions(settings);
 	dynv_system_release(settings);
+	gs->converters().invalidate();
 	if (status == 0){
 		lua_settop(L, stack_top);
 		return true;
@@ -135,6 +144,13 @@ static void calc( DialogOptionsArgs *args, bool preview, int limit)
 		}
 		i++;
 	}
+	const ColorDistance *color_distance_metrics = color_distance_get_metrics();
+	for (size_t i = 0; i < args->color_distance.size(); i++){
+		if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->color_distance[i]))){
+			dynv_set_string(args->params, "color_names.distance", color_distance_metrics[i].name);
+			break;
+		}
+	}
 	for (int i = 0; available_color_spaces[i].label; i++){
 		dynv_set_bool(args->params, available_color_spaces[i].setting, gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->color_spaces[i])));
 	}
@@ -422,12 +438,34 @@ void dialog_options_show(GtkWindow* parent, GlobalState* gs)
 		table_y++;
 		i++;
 	}
+	frame = gtk_frame_new(_("Color difference"));
+	gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_NONE);
+	gtk_table_attach(GTK_TABLE(table_m), frame, 0, 1, table_m_y, table_m_y+1, GtkAttachOptions(GTK_FILL | GTK_EXPAND), GtkAttachOptions(GTK_FILL), 5, 5);
+	table_m_y++;
+	table = gtk_table_new(5, 3, FALSE);
+	table_y=0;
+	gtk_container_add(GTK_CONTAINER(frame), table);
+	group = nullptr;
+	const ColorDistance &selected_distance = color_distance_get_metric(dynv_get_string_wd(args->params, "color_names.distance", "cie94"), color_distance_cie94_metric);
+	const ColorDistance *color_distance_metrics = color_distance_get_metrics();
+	for (i = 0; color_distance_metrics[i].name; i++){
+		widget = gtk_radio_button_new_with_mnemonic(group, _(color_distance_metrics[i].label));
+		args->color_distance.push_back(widget);
+		group = gtk_radio_button_get_group(GTK_RADIO_BUTTON(widget));
+		if (&selected_distance == &color_distance_metrics[i])
+			gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget), true);
+		gtk_table_attach(GTK_TABLE(table), widget,1,2,table_y,table_y+1,GtkAttachOptions(GTK_FILL | GTK_EXPAND),GTK_FILL,3,3);
+		table_y++;
+	}
 	gtk_notebook_append_page(GTK_NOTEBOOK(notebook), table_m, gtk_label_new_with_mnemonic(_("_Color names")));
 	gtk_widget_show_all(notebook);
 	gtk_container_add(GTK_CONTAINER(gtk_dialog_get_content_area(GTK_DIALOG(dialog))), notebook);
 	if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_OK) {
 		calc(args, false, 0);
+		color_names_set_distance(args->gs->getColorNames(), color_distance_get_metric(dynv_get_string_wd(args->params, "color_names.distance", "cie94"), color_distance_cie94_metric));
+		args->gs->toolColorNameCache().clear();
 		dialog_options_update(args->gs->script(), args->gs->getSettings(), args->gs);
+		color_list_notify_text_change(args->gs->getColorList());
 	}
 	gint width, height;
 	gtk_window_get_size(GTK_WINDOW(dialog), &width, &height);
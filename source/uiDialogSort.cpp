@@ -28,11 +28,14 @@
 #include "Noise.h"
 #include "GenerateScheme.h"
 #include "I18N.h"
+#include "TaskExecutor.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <memory>
 using namespace std;
 
 typedef struct DialogSortArgs{
@@ -49,9 +52,11 @@ typedef struct DialogSortArgs{
 
 	struct dynvSystem *params;
 	GlobalState* gs;
+	std::shared_ptr<TaskExecutor::Task> preview_task;
 }DialogSortArgs;
 
 typedef struct SortType{
+	const char *id;
 	const char *name;
 	double (*get_value)(Color *color);
 }SortType;
@@ -133,19 +138,19 @@ static double sort_lch_hue(Color *color)
 }
 
 const SortType sort_types[] = {
-	{N_("RGB Red"), sort_rgb_red},
-	{N_("RGB Green"), sort_rgb_green},
-	{N_("RGB Blue"), sort_rgb_blue},
-	{N_("RGB Grayscale"), sort_rgb_grayscale},
-	{N_("HSL Hue"), sort_hsl_hue},
-	{N_("HSL Saturation"), sort_hsl_saturation},
-	{N_("HSL Lightness"), sort_hsl_lightness},
-	{N_("Lab Lightness"), sort_lab_lightness},
-	{N_("Lab A"), sort_lab_a},
-	{N_("Lab B"), sort_lab_b},
-	{N_("LCh Lightness"), sort_lch_lightness},
-	{N_("LCh Chroma"), sort_lch_chroma},
-	{N_("LCh Hue"), sort_lch_hue},
+	{"rgb_red", N_("RGB Red"), sort_rgb_red},
+	{"rgb_green", N_("RGB Green"), sort_rgb_green},
+	{"rgb_blue", N_("RGB Blue"), sort_rgb_blue},
+	{"rgb_grayscale", N_("RGB Grayscale"), sort_rgb_grayscale},
+	{"hsl_hue", N_("HSL Hue"), sort_hsl_hue},
+	{"hsl_saturation", N_("HSL Saturation"), sort_hsl_saturation},
+	{"hsl_lightness", N_("HSL Lightness"), sort_hsl_lightness},
+	{"lab_lightness", N_("Lab Lightness"), sort_lab_lightness},
+	{"lab_a", N_("Lab A"), sort_lab_a},
+	{"lab_b", N_("Lab B"), sort_lab_b},
+	{"lch_lightness", N_("LCh Lightness"), sort_lch_lightness},
+	{"lch_chroma", N_("LCh Chroma"), sort_lch_chroma},
+	{"lch_hue", N_("LCh Hue"), sort_lch_hue},
 };
 
 static double group_rgb_red(Color *color)
@@ -425,98 +430,94 @@ static void node_update(Node *node, Range *range, double value, uint32_t max_dep
 }
 
 
-static void calc(DialogSortArgs *args, bool preview, int limit){
-	int32_t group_type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->group_type));
-	double group_sensitivity = gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->group_sensitivity));
-	int max_groups = gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->max_groups));
-	int32_t sort_type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->sort_type));
-	bool reverse = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->toggle_reverse));
-	bool reverse_groups = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->toggle_reverse_groups));
-
-	if (!preview){
-		dynv_set_int32(args->params, "group_type", group_type);
-		dynv_set_float(args->params, "group_sensitivity", group_sensitivity);
-		dynv_set_int32(args->params, "max_groups", max_groups);
-		dynv_set_int32(args->params, "sort_type", sort_type);
-		dynv_set_bool(args->params, "reverse", reverse);
-		dynv_set_bool(args->params, "reverse_groups", reverse_groups);
-	}
-
-	ColorList *color_list;
-	if (preview)
-		color_list = args->preview_color_list;
-	else
-		color_list = args->sorted_color_list;
+struct SortSettings
+{
+	int32_t group_type;
+	double group_sensitivity;
+	int max_groups;
+	int32_t sort_type;
+	bool reverse;
+	bool reverse_groups;
+};
 
-	typedef std::multimap<double, ColorObject*> SortedColors;
+static void get_settings(DialogSortArgs *args, SortSettings &settings)
+{
+	settings.group_type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->group_type));
+	settings.group_sensitivity = gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->group_sensitivity));
+	settings.max_groups = gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->max_groups));
+	settings.sort_type = gtk_combo_box_get_active(GTK_COMBO_BOX(args->sort_type));
+	settings.reverse = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->toggle_reverse));
+	settings.reverse_groups = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->toggle_reverse_groups));
+}
+
+/**
+ * Group and sort colors. Does not use any shared state, so it can be called from a worker thread.
+ * @param[in] settings Grouping and sorting settings.
+ * @param[in] colors Colors to sort.
+ * @param[out] order Color indices in sorted order.
+ */
+static void sort_colors(const SortSettings &settings, const vector<Color> &colors, vector<size_t> &order)
+{
+	typedef std::multimap<double, size_t> SortedColors;
 	typedef std::map<uintptr_t, SortedColors> GroupedSortedColors;
 	GroupedSortedColors grouped_sorted_colors;
 
 	typedef std::multimap<double, uintptr_t> SortedGroups;
 	SortedGroups sorted_groups;
 
-	const GroupType *group = &group_types[group_type];
-	const SortType *sort = &sort_types[sort_type];
+	const GroupType *group = &group_types[settings.group_type];
+	const SortType *sort = &sort_types[settings.sort_type];
 
 	Color in;
 	Node *group_nodes = node_new(0);
 	Range range;
 	range.x = 0;
 	range.w = 1;
-	int tmp_limit = limit;
 	if (group->get_group){
-		for (ColorList::iter i = args->selected_color_list->colors.begin(); i != args->selected_color_list->colors.end(); ++i){
-			in = (*i)->getColor();
+		for (size_t i = 0; i < colors.size(); i++){
+			in = colors[i];
 			node_update(group_nodes, &range, group->get_group(&in), 8);
-			if (preview){
-				if (tmp_limit <= 0)
-					break;
-				tmp_limit--;
-			}
 		}
 	}
 
-	node_reduce(group_nodes, group_sensitivity / 100.0, max_groups);
-
-	tmp_limit = limit;
-	for (ColorList::iter i = args->selected_color_list->colors.begin(); i != args->selected_color_list->colors.end(); ++i){
-		in = (*i)->getColor();
+	node_reduce(group_nodes, settings.group_sensitivity / 100.0, settings.max_groups);
 
+	for (size_t i = 0; i < colors.size(); i++){
+		in = colors[i];
 		uintptr_t node_ptr = 0;
 		if (group->get_group){
 			node_ptr = reinterpret_cast<uintptr_t>(node_find(group_nodes, &range, group->get_group(&in)));
 		}
-		grouped_sorted_colors[node_ptr].insert(std::pair<double, ColorObject*>(sort->get_value(&in), *i));
-
-		if (preview){
-			if (tmp_limit <= 0)
-				break;
-			tmp_limit--;
-		}
+		grouped_sorted_colors[node_ptr].insert(std::pair<double, size_t>(sort->get_value(&in), i));
 	}
 
 	node_delete(group_nodes);
 
 	for (GroupedSortedColors::iterator i = grouped_sorted_colors.begin(); i != grouped_sorted_colors.end(); ++i){
-		in = (*(*i).second.begin()).second->getColor();
+		in = colors[(*(*i).second.begin()).second];
 		sorted_groups.insert(std::pair<double, uintptr_t>(sort->get_value(&in), (*i).first));
 	}
 
-	if (reverse_groups){
+	order.clear();
+	order.reserve(colors.size());
+	auto add_group = [&](SortedColors &group_colors){
+		if (settings.reverse){
+			for (SortedColors::reverse_iterator k = group_colors.rbegin(); k != group_colors.rend(); ++k){
+				order.push_back((*k).second);
+			}
+		}else{
+			for (SortedColors::iterator k = group_colors.begin(); k != group_colors.end(); ++k){
+				order.push_back((*k).second);
+			}
+		}
+	};
+	if (settings.reverse_groups){
 		for (SortedGroups::reverse_iterator i = sorted_groups.rbegin(); i != sorted_groups.rend(); ++i){
 			GroupedSortedColors::iterator a, b;
 			a = grouped_sorted_colors.lower_bound((*i).second);
 			b = grouped_sorted_colors.upper_bound((*i).second);
 			for (GroupedSortedColors::iterator j = a; j != b; ++j){
-				if (reverse){
-					for (SortedColors::reverse_iterator k = (*j).second.rbegin(); k != (*j).second.rend(); ++k){
-						color_list_add_color_object(color_list, (*k).second, true);
-					}
-				}else{
-					for (SortedColors::iterator k = (*j).second.begin(); k != (*j).second.end(); ++k){
-						color_list_add_color_object(color_list, (*k).second, true);
-					}
-				}
+				add_group((*j).second);
 			}
 		}
 	}else{
@@ -525,22 +526,104 @@ static void calc(DialogSortArgs *args, bool preview, int limit){
 			a = grouped_sorted_colors.lower_bound((*i).second);
 			b = grouped_sorted_colors.upper_bound((*i).second);
 			for (GroupedSortedColors::iterator j = a; j != b; ++j){
-				if (reverse){
-					for (SortedColors::reverse_iterator k = (*j).second.rbegin(); k != (*j).second.rend(); ++k){
-						color_list_add_color_object(color_list, (*k).second, true);
-					}
-				}else{
-					for (SortedColors::iterator k = (*j).second.begin(); k != (*j).second.end(); ++k){
-						color_list_add_color_object(color_list, (*k).second, true);
-					}
-				}
+				add_group((*j).second);
 			}
 		}
 	}
 }
 
+/** Sorts preview colors in a worker thread. Color objects are only used in finish(), and the task is cancelled before dialog is destroyed. */
+struct SortPreviewTask: public TaskExecutor::Task
+{
+	DialogSortArgs *m_args;
+	SortSettings m_settings;
+	vector<ColorObject*> m_color_objects;
+	vector<Color> m_colors;
+	vector<size_t> m_order;
+	SortPreviewTask(DialogSortArgs *args, const SortSettings &settings, size_t limit):
+		m_args(args),
+		m_settings(settings)
+	{
+		for (auto color_object: args->selected_color_list->colors){
+			if (m_color_objects.size() >= limit)
+				break;
+			m_color_objects.push_back(color_object);
+			m_colors.push_back(color_object->getColor());
+		}
+	}
+	virtual void run()
+	{
+		sort_colors(m_settings, m_colors, m_order);
+	}
+	virtual void finish()
+	{
+		color_list_remove_all(m_args->preview_color_list);
+		for (auto index: m_order)
+			color_list_add_color_object(m_args->preview_color_list, m_color_objects[index], true);
+	}
+};
+
+static void calc(DialogSortArgs *args, bool preview, int limit){
+	SortSettings settings;
+	get_settings(args, settings);
+
+	if (preview){
+		if (args->preview_task)
+			args->preview_task->cancel();
+		args->preview_task = std::make_shared<SortPreviewTask>(args, settings, limit);
+		args->gs->taskExecutor().submit(args->preview_task);
+		return;
+	}
+
+	dynv_set_int32(args->params, "group_type", settings.group_type);
+	dynv_set_float(args->params, "group_sensitivity", settings.group_sensitivity);
+	dynv_set_int32(args->params, "max_groups", settings.max_groups);
+	dynv_set_int32(args->params, "sort_type", settings.sort_type);
+	dynv_set_bool(args->params, "reverse", settings.reverse);
+	dynv_set_bool(args->params, "reverse_groups", settings.reverse_groups);
+
+	vector<ColorObject*> color_objects(args->selected_color_list->colors.begin(), args->selected_color_list->colors.end());
+	vector<Color> colors;
+	colors.reserve(color_objects.size());
+	for (auto color_object: color_objects)
+		colors.push_back(color_object->getColor());
+	vector<size_t> order;
+	sort_colors(settings, colors, order);
+	for (auto index: order)
+		color_list_add_color_object(args->sorted_color_list, color_objects[index], true);
+}
+
+bool sort_color_list(ColorList *color_list, ColorList *sorted_color_list, const char *sort_type, bool reverse)
+{
+	const SortType *sort = nullptr;
+	for (uint32_t i = 0; i < sizeof(sort_types) / sizeof(SortType); i++){
+		if (strcmp(sort_types[i].id, sort_type) == 0){
+			sort = &sort_types[i];
+			break;
+		}
+	}
+	if (!sort)
+		return false;
+	typedef std::multimap<double, ColorObject*> SortedColors;
+	SortedColors sorted_colors;
+	Color in;
+	for (ColorList::iter i = color_list->colors.begin(); i != color_list->colors.end(); ++i){
+		in = (*i)->getColor();
+		sorted_colors.insert(std::pair<double, ColorObject*>(sort->get_value(&in), *i));
+	}
+	if (reverse){
+		for (SortedColors::reverse_iterator i = sorted_colors.rbegin(); i != sorted_colors.rend(); ++i){
+			color_list_add_color_object(sorted_color_list, (*i).second, true);
+		}
+	}else{
+		for (SortedColors::iterator i = sorted_colors.begin(); i != sorted_colors.end(); ++i){
+			color_list_add_color_object(sorted_color_list, (*i).second, true);
+		}
+	}
+	return true;
+}
+
 static void update(GtkWidget *widget, DialogSortArgs *args ){
-	color_list_remove_all(args->preview_color_list);
 	calc(args, true, 100);
 }
 
@@ -633,6 +716,8 @@ bool dialog_sort_show(GtkWindow* parent, ColorList *selected_color_list, ColorLi
 	dynv_set_int32(args->params, "window.height", height);
 	dynv_set_bool(args->params, "show_preview", gtk_expander_get_expanded(GTK_EXPANDER(preview_expander)));
 
+	if (args->preview_task)
+		args->preview_task->cancel();
 	gtk_widget_destroy(dialog);
 
 	color_list_destroy(args->preview_color_list);
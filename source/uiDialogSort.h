@@ -22,4 +22,13 @@
 struct GlobalState;
 struct ColorList;
 bool dialog_sort_show(GtkWindow* parent, ColorList *selected_color_list, ColorList *sorted_color_list, GlobalState* gs);
+/**
+ * Sort colors by a single component without grouping and without showing dialog.
+ * @param[in] color_list Colors to sort.
+ * @param[out] sorted_color_list Color list which receives sorted colors.
+ * @param[in] sort_type Sort type identifier, for example "hsl_hue" or "lab_lightness".
+ * @param[in] reverse Sort in descending order.
+ * @return False if sort type is unknown.
+ */
+bool sort_color_list(ColorList *color_list, ColorList *sorted_color_list, const char *sort_type, bool reverse);
 #endif /* GPICK_UI_DIALOG_SORT_H_ */
@@ -31,12 +31,59 @@
 #include "Vector2.h"
 #include "I18N.h"
 #include "Format.h"
+#include "Tracing.h"
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <unordered_map>
+#include <vector>
 using namespace math;
 using namespace std;
 
+/** \struct PaletteTextCache
+ * \brief Color list converter output for palette rows.
+ *
+ * Text is serialized when a row is rendered, so rows which are never shown are never serialized.
+ * Text produced by each converter is kept, so switching back to a previously used converter does not call Lua again.
+ * Entries must be removed when color or name of a color object changes.
+ */
+struct PaletteTextCache
+{
+	const string &get(ColorObject *color_object, Converters &converters)
+	{
+		Converter *converter = converters.colorList();
+		uint32_t revision = converters.revision();
+		auto &entries = m_entries[color_object];
+		for (auto i = entries.begin(); i != entries.end(); ){
+			if (i->revision != revision){
+				i = entries.erase(i);
+			}else if (i->converter == converter){
+				return i->text;
+			}else{
+				++i;
+			}
+		}
+		entries.push_back(Entry{converter, revision, converters.serialize(color_object, Converters::Type::colorList)});
+		return entries.back().text;
+	}
+	void remove(ColorObject *color_object)
+	{
+		m_entries.erase(color_object);
+	}
+	void clear()
+	{
+		m_entries.clear();
+	}
+	private:
+	struct Entry
+	{
+		Converter *converter;
+		uint32_t revision;
+		string text;
+	};
+	unordered_map<ColorObject*, vector<Entry>> m_entries;
+};
+
 typedef struct ListPaletteArgs{
 	ColorSource source;
 	GtkWidget *treeview;
@@ -45,6 +92,7 @@ typedef struct ListPaletteArgs{
 	bool disable_selection;
 	GtkWidget* count_label;
 	GlobalState* gs;
+	PaletteTextCache text_cache;
 }ListPaletteArgs;
 
 static void destroy_arguments(gpointer data);
@@ -181,29 +229,35 @@ static void palette_list_vertical_autoscroll(GtkTreeView *treeview)
 
 static void palette_list_entry_fill(GtkListStore* store, GtkTreeIter *iter, ColorObject* color_object, ListPaletteArgs* args)
 {
-	string text = args->gs->converters().serialize(color_object, Converters::Type::colorList);
-	gtk_list_store_set(store, iter, 0, color_object->reference(), 1, text.c_str(), 2, color_object->getName().c_str(), -1);
+	args->text_cache.remove(color_object);
+	gtk_list_store_set(store, iter, 0, color_object->reference(), 1, color_object->getName().c_str(), -1);
 }
 static void palette_list_entry_update_row(GtkListStore* store, GtkTreeIter *iter, ColorObject* color_object, ListPaletteArgs* args)
 {
-	string text = args->gs->converters().serialize(color_object, Converters::Type::colorList);
-	gtk_list_store_set(store, iter, 1, text.c_str(), 2, color_object->getName().c_str(), -1);
+	args->text_cache.remove(color_object);
+	gtk_list_store_set(store, iter, 1, color_object->getName().c_str(), -1);
 }
-static void palette_list_entry_update_name(GtkListStore* store, GtkTreeIter *iter, ColorObject* color_object)
+static void palette_list_entry_update_name(GtkListStore* store, GtkTreeIter *iter, ColorObject* color_object, ListPaletteArgs* args)
 {
-	gtk_list_store_set(store, iter, 2, color_object->getName().c_str(), -1);
+	//converters can use color name too
+	args->text_cache.remove(color_object);
+	gtk_list_store_set(store, iter, 1, color_object->getName().c_str(), -1);
 }
-static void palette_list_cell_edited(GtkCellRendererText *cell, gchar *path, gchar *new_text, gpointer user_data)
+static void palette_list_text_data_func(GtkTreeViewColumn *column, GtkCellRenderer *renderer, GtkTreeModel *model, GtkTreeIter *iter, ListPaletteArgs *args)
+{
+	ColorObject *color_object;
+	gtk_tree_model_get(model, iter, 0, &color_object, -1);
+	g_object_set(renderer, "text", args->text_cache.get(color_object, args->gs->converters()).c_str(), nullptr);
+}
+static void palette_list_cell_edited(GtkCellRendererText *cell, gchar *path, gchar *new_text, ListPaletteArgs *args)
 {
 	GtkTreeIter iter;
-	GtkTreeModel *model=GTK_TREE_MODEL(user_data);
+	GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(args->treeview));
 	gtk_tree_model_get_iter_from_string(model, &iter, path );
-	gtk_list_store_set(GTK_LIST_STORE(model), &iter,
-		2, new_text,
-	-1);
 	ColorObject *color_object;
 	gtk_tree_model_get(model, &iter, 0, &color_object, -1);
 	color_object->setName(new_text);
+	palette_list_entry_update_name(GTK_LIST_STORE(model), &iter, color_object, args);
 }
 static void palette_list_row_activated(GtkTreeView *tree_view, GtkTreePath *path, GtkTreeViewColumn *column, gpointer user_data)
 {
@@ -255,7 +309,7 @@ GtkWidget* palette_list_preview_new(GlobalState* gs, bool expander, bool expande
 
 	gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(view), 0);
 
-	store = gtk_list_store_new (3, G_TYPE_POINTER, G_TYPE_STRING, G_TYPE_STRING);
+	store = gtk_list_store_new (2, G_TYPE_POINTER, G_TYPE_STRING);
 
 	col = gtk_tree_view_column_new();
 	gtk_tree_view_column_set_sizing(col,GTK_TREE_VIEW_COLUMN_AUTOSIZE);
@@ -636,7 +690,7 @@ GtkWidget* palette_list_new(GlobalState* gs, GtkWidget* count_label){
 
 	gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(view), 1);
 
-	store = gtk_list_store_new (3, G_TYPE_POINTER, G_TYPE_STRING, G_TYPE_STRING);
+	store = gtk_list_store_new (2, G_TYPE_POINTER, G_TYPE_STRING);
 
 	col = gtk_tree_view_column_new();
 	gtk_tree_view_column_set_sizing(col,GTK_TREE_VIEW_COLUMN_AUTOSIZE);
@@ -653,7 +707,7 @@ GtkWidget* palette_list_new(GlobalState* gs, GtkWidget* count_label){
 	gtk_tree_view_column_set_title(col, _("Color"));
 	renderer = gtk_cell_renderer_text_new();
 	gtk_tree_view_column_pack_start(col, renderer, TRUE);
-	gtk_tree_view_column_add_attribute(col, renderer, "text", 1);
+	gtk_tree_view_column_set_cell_data_func(col, renderer, (GtkTreeCellDataFunc)palette_list_text_data_func, args, nullptr);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(view), col);
 
 	col = gtk_tree_view_column_new();
@@ -662,10 +716,10 @@ GtkWidget* palette_list_new(GlobalState* gs, GtkWidget* count_label){
 	gtk_tree_view_column_set_title(col, _("Name"));
 	renderer = gtk_cell_renderer_text_new();
 	gtk_tree_view_column_pack_start(col, renderer, TRUE);
-	gtk_tree_view_column_add_attribute(col, renderer, "text", 2);
+	gtk_tree_view_column_add_attribute(col, renderer, "text", 1);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(view), col);
 	g_object_set(renderer, "editable", TRUE, nullptr);
-	g_signal_connect(renderer, "edited", (GCallback) palette_list_cell_edited, store);
+	g_signal_connect(renderer, "edited", (GCallback) palette_list_cell_edited, args);
 
 	gtk_tree_view_set_enable_search(GTK_TREE_VIEW(view), false);
 	gtk_tree_view_set_model(GTK_TREE_VIEW(view), GTK_TREE_MODEL(store));
@@ -727,6 +781,7 @@ void palette_list_remove_all_entries(GtkWidget* widget) {
 	}
 
 	gtk_list_store_clear(GTK_LIST_STORE(store));
+	args->text_cache.clear();
 
 	update_counts(args);
 }
@@ -776,6 +831,7 @@ void palette_list_remove_selected_entries(GtkWidget* widget)
 		gtk_tree_model_get(GTK_TREE_MODEL(store), &iter, 0, &color_object, -1);
 		if (color_object->isSelected()){
 			valid = gtk_list_store_remove(GTK_LIST_STORE(store), &iter);
+			args->text_cache.remove(color_object);
 			color_object->release();
 		}else{
 			valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
@@ -786,6 +842,7 @@ void palette_list_remove_selected_entries(GtkWidget* widget)
 
 void palette_list_add_entry(GtkWidget* widget, ColorObject* color_object)
 {
+	TRACE_SCOPE("palette_list_add_entry");
 	ListPaletteArgs* args = (ListPaletteArgs*)g_object_get_data(G_OBJECT(widget), "arguments");
 	GtkTreeIter iter1;
 	GtkListStore *store;
@@ -807,6 +864,7 @@ int palette_list_remove_entry(GtkWidget* widget, ColorObject* r_color_object)
 		gtk_tree_model_get(GTK_TREE_MODEL(store), &iter, 0, &color_object, -1);
 		if (color_object == r_color_object){
 			valid = gtk_list_store_remove(GTK_LIST_STORE(store), &iter);
+			args->text_cache.remove(color_object);
 			color_object->release();
 			return 0;
 		}
@@ -822,7 +880,7 @@ static void execute_callback(GtkListStore *store, GtkTreeIter *iter, ListPalette
 	PaletteListCallbackReturn r = callback(color_object, userdata);
 	switch (r){
 		case PALETTE_LIST_CALLBACK_UPDATE_NAME:
-			palette_list_entry_update_name(store, iter, color_object);
+			palette_list_entry_update_name(store, iter, color_object, args);
 			break;
 		case PALETTE_LIST_CALLBACK_UPDATE_ROW:
 			palette_list_entry_update_row(store, iter, color_object, args);
@@ -840,11 +898,12 @@ static void execute_replace_callback(GtkListStore *store, GtkTreeIter *iter, Lis
 	color_object->reference();
 	PaletteListCallbackReturn r = callback(&color_object, userdata);
 	if (color_object != orig_color_object){
+		args->text_cache.remove(orig_color_object);
 		gtk_list_store_set(store, iter, 0, color_object, -1);
 	}
 	switch (r){
 		case PALETTE_LIST_CALLBACK_UPDATE_NAME:
-			palette_list_entry_update_name(store, iter, color_object);
+			palette_list_entry_update_name(store, iter, color_object, args);
 			break;
 		case PALETTE_LIST_CALLBACK_UPDATE_ROW:
 			palette_list_entry_update_row(store, iter, color_object, args);
@@ -959,10 +1018,16 @@ void palette_list_update_first_selected(GtkWidget* widget, bool only_name)
 		gtk_tree_model_get_iter(model, &iter, reinterpret_cast<GtkTreePath*>(i->data));
 		gtk_tree_model_get(model, &iter, 0, &color_object, -1);
 		if (only_name)
-			palette_list_entry_update_name(GTK_LIST_STORE(model), &iter, color_object);
+			palette_list_entry_update_name(GTK_LIST_STORE(model), &iter, color_object, args);
 		else
 			palette_list_entry_update_row(GTK_LIST_STORE(model), &iter, color_object, args);
 	}
 	g_list_foreach(list, (GFunc)gtk_tree_path_free, nullptr);
 	g_list_free(list);
 }
+void palette_list_update_text(GtkWidget* widget)
+{
+	//column widths are recalculated in idle batches, visible rows are serialized first
+	gtk_tree_view_columns_autosize(GTK_TREE_VIEW(widget));
+	gtk_widget_queue_draw(widget);
+}
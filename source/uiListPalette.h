@@ -45,4 +45,6 @@ gint32 palette_list_get_selected_count(GtkWidget* widget);
 gint32 palette_list_get_count(GtkWidget* widget);
 ColorObject *palette_list_get_first_selected(GtkWidget* widget);
 void palette_list_update_first_selected(GtkWidget* widget, bool only_name);
+/** Redraw color list converter text of all rows. Text of rows which are not visible is serialized in background batches by the tree view. */
+void palette_list_update_text(GtkWidget* widget);
 #endif /* GPICK_UI_LIST_PALETTE_H_ */
@@ -219,6 +219,7 @@ static void apply_configuration(TransformationsArgs *args){
 		auto dv = dynv_system_create(handler_map);
 		args->configuration->applyConfig(dv);
 		args->transformation->deserialize(dv);
+		args->gs->getTransformationChain()->update();
 		dynv_handler_map_release(handler_map);
 		dynv_system_release(dv);
 	}